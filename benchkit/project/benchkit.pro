@@ -0,0 +1,9 @@
+TARGET = benchkit
+TEMPLATE = app
+
+!include(../../daddy/project/daddy.pri) {
+    error("Couldn't find the daddy.pri file...")
+}
+
+TOPPATH = $$PWD/../source
+SOURCES += $$TOPPATH/benchkit.cpp
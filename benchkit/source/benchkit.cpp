@@ -0,0 +1,413 @@
+﻿#include <daddy.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+class BenchKit
+{
+public:
+    BenchKit(uint32_t clients, uint32_t millisec);
+    ~BenchKit();
+
+public:
+    void runSocket(bool ring, uint32_t window, uint32_t size);
+    void runTelepath(uint32_t window, uint32_t size);
+
+private:
+    void clearResult();
+    void report(utf8s bench, utf8s transport, uint32_t window, uint32_t size, double seconds);
+    bool prepareTelepath();
+    void releaseTelepath();
+
+private:
+    uint32_t mClients;
+    uint32_t mMillisec;
+    dSocket mEchoServer;
+    std::thread* mEchoThread;
+    std::atomic<bool> mEchoQuit;
+    bool mTeleTried;
+    TeleGateClientP* mTeleClient;
+    dSocket mTeleGate;
+    dTelepath::SilkID mTeleServer;
+    std::vector<dTelepath::SilkID> mTeleSilks;
+    std::function<void(uint32_t index, dBinary binary)> mTeleEcho;
+    uint64_t mMessages;
+    uint64_t mBytes;
+    std::vector<uint32_t> mLatencies;
+};
+
+static const uint16_t gEchoPort = 7171;
+static FILE* gResult = nullptr;
+static bool gInterrupt = false;
+static void OnInterrupt(int signum)
+{
+    fprintf(stderr, "[daddy] Interrupt signal: %d\n", signum);
+    gInterrupt = true;
+}
+
+static uint64_t NowNsec()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static utf8s BenchMarkIn(int32_t type)
+{
+    if(type == (int32_t) dTeleApi::MarkInType::EntityUuid)
+        return "benchkit";
+    return "";
+}
+
+int main(int argc, char* argv[])
+{
+    signal(SIGINT, OnInterrupt); // Ctrl+C
+    const int32_t Clients = (2 <= argc)? atoi(argv[1]) : 4;
+    const int32_t Millisec = (3 <= argc)? atoi(argv[2]) : 1000;
+    const char* ResultPath = (4 <= argc)? argv[3] : "benchkit.jsonl";
+    if(5 <= argc || Clients < 1 || Millisec < 1 || !(gResult = fopen(ResultPath, "w")))
+    {
+        fprintf(stderr,
+            "[daddy] call the argument again like this!\n"
+            "$ ./benchkit [clients=4] [millisec=1000] [result.jsonl=benchkit.jsonl]\n");
+        return 0;
+    }
+
+    // 결과는 시나리오마다 한줄의 JSON으로 파일에(회귀추적용, stdout은 라이브러리의 로그와 섞임), 진행상황은 stderr로
+    dGlobal::load();
+    {
+        BenchKit Kit(Clients, Millisec);
+        const uint32_t Sizes[] = {16, 256, 4096, 65536, 1048576};
+        for(int i = 0; i < 2 && !gInterrupt; ++i)
+        for(auto iSize : Sizes)
+        {
+            // 파이프라인은 상대방당 256KB까지만 띄워서 소켓버퍼의 교착을 피함
+            const uint32_t Pipeline = std::max(1u, std::min(32u, 0x40000 / iSize));
+            Kit.runSocket(i == 1, 1, iSize);
+            if(1 < Pipeline && !gInterrupt)
+                Kit.runSocket(i == 1, Pipeline, iSize);
+            if(gInterrupt) break;
+        }
+        for(auto iSize : Sizes)
+        {
+            // 한 스레드가 실크의 양끝을 돌리므로 발송중인 프레임이 링(1MB)안에 들어가야 함
+            const uint32_t Size = std::min(iSize, 0x100000 - 16u);
+            const uint32_t Pipeline = std::max(1u, std::min(32u, 0x40000 / Size));
+            Kit.runTelepath(1, Size);
+            if(1 < Pipeline && !gInterrupt)
+                Kit.runTelepath(Pipeline, Size);
+            if(gInterrupt) break;
+        }
+    }
+    dGlobal::release();
+    fclose(gResult);
+    fprintf(stderr, "[daddy] * * * * * done * * * * *\n");
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ BenchKit
+BenchKit::BenchKit(uint32_t clients, uint32_t millisec)
+{
+    mClients = clients;
+    mMillisec = millisec;
+    mEchoThread = nullptr;
+    mEchoQuit = false;
+    mTeleTried = false;
+    mTeleClient = nullptr;
+    mTeleServer = -1;
+    mMessages = 0;
+    mBytes = 0;
+
+    // 에코서버(모든 소켓시나리오가 공유)
+    if(mEchoServer.openServer(gEchoPort))
+    {
+        mEchoThread = new std::thread([this]()
+        {
+            while(!mEchoQuit)
+            {
+                bool Received = false;
+                mEchoServer.recvAll([this, &Received](uint32_t id, const dBinary& binary)
+                {
+                    mEchoServer.sendTo(id, binary, true);
+                    Received = true;
+                });
+                if(!Received)
+                    std::this_thread::yield();
+            }
+        });
+    }
+    else fprintf(stderr, "[daddy] could not open the echo server(%hu)\n", gEchoPort);
+}
+
+BenchKit::~BenchKit()
+{
+    if(mEchoThread)
+    {
+        mEchoQuit = true;
+        mEchoThread->join();
+        delete mEchoThread;
+    }
+    mEchoServer.close();
+    releaseTelepath();
+}
+
+void BenchKit::runSocket(bool ring, uint32_t window, uint32_t size)
+{
+    if(!mEchoThread) return;
+    fprintf(stderr, "[daddy] socket/%s window:%u size:%u\n", (ring)? "ring" : "tcp", window, size);
+
+    // 상대방마다 하나의 스레드가 window만큼 띄워놓고 에코를 기다림
+    std::vector<std::thread> Threads;
+    std::vector<std::vector<uint32_t>> Latencies(mClients);
+    std::vector<uint64_t> Messages(mClients, 0);
+    std::atomic<uint32_t> Ready(0);
+    std::atomic<bool> Measure(false), Stop(false);
+    for(uint32_t i = 0; i < mClients; ++i)
+    {
+        Threads.emplace_back([&, i]()
+        {
+            dSocket Client;
+            if(!Client.openClient("127.0.0.1", gEchoPort))
+            {
+                ++Ready;
+                return;
+            }
+            if(ring)
+                Client.shareLocalRing();
+            std::vector<dump> Payload(size, 0);
+            const dBinary Binary = dBinary::fromExternal(&Payload[0], size);
+            uint32_t Flying = 0;
+            bool Warmed = false;
+            const uint64_t WarmEnd = NowNsec() + 200000000; // 200ms 워밍업(링전환 포함)
+            while(!Stop || 0 < Flying)
+            {
+                while(!Stop && Flying < window)
+                {
+                    const uint64_t SendNsec = NowNsec();
+                    memcpy(&Payload[0], &SendNsec, 8);
+                    if(!Client.sendTo(0, Binary, true))
+                    {
+                        Stop = true;
+                        break;
+                    }
+                    Flying++;
+                }
+                dBinary Echo = Client.recvFrom(0);
+                if(0 < Echo.length())
+                {
+                    Flying--;
+                    if(Measure)
+                    {
+                        uint64_t SendNsec = 0;
+                        memcpy(&SendNsec, Echo.buffer(), 8);
+                        Latencies[i].push_back((uint32_t) ((NowNsec() - SendNsec) / 1000));
+                        Messages[i]++;
+                    }
+                }
+                else if(Client.count() == 0)
+                    break;
+                else std::this_thread::yield();
+                if(!Warmed && WarmEnd < NowNsec())
+                {
+                    Warmed = true;
+                    ++Ready;
+                }
+            }
+            if(!Warmed) ++Ready;
+        });
+    }
+
+    while(Ready < mClients)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const uint64_t BeginNsec = NowNsec();
+    Measure = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(mMillisec));
+    Measure = false;
+    const uint64_t EndNsec = NowNsec();
+    Stop = true;
+    for(auto& iThread : Threads)
+        iThread.join();
+
+    clearResult();
+    for(uint32_t i = 0; i < mClients; ++i)
+    {
+        mMessages += Messages[i];
+        mLatencies.insert(mLatencies.end(), Latencies[i].begin(), Latencies[i].end());
+    }
+    mBytes = mMessages * size;
+    report("socket", (ring)? "ring" : "tcp", window, size, (EndNsec - BeginNsec) / 1e9);
+}
+
+void BenchKit::runTelepath(uint32_t window, uint32_t size)
+{
+    if(!prepareTelepath()) return;
+    fprintf(stderr, "[daddy] telepath/silk window:%u size:%u\n", window, size);
+
+    // 콜백은 모두 nextReceive를 부른 메인스레드에서 호출됨
+    std::vector<dump> Payload(size, 0);
+    const dBinary Binary = dBinary::fromExternal(&Payload[0], size);
+    std::vector<uint32_t> Flying(mClients, 0);
+    bool Measure = false, Stop = false;
+    clearResult();
+    auto SendNext = [&](uint32_t index)
+    {
+        const uint64_t SendNsec = NowNsec();
+        memcpy(&Payload[0], &SendNsec, 8);
+        if(dTelepath::send(mTeleSilks[index], 0, Binary))
+            Flying[index]++;
+    };
+    mTeleEcho = [&](uint32_t index, dBinary binary)
+    {
+        Flying[index]--;
+        if(Measure)
+        {
+            uint64_t SendNsec = 0;
+            memcpy(&SendNsec, binary.buffer(), 8);
+            mLatencies.push_back((uint32_t) ((NowNsec() - SendNsec) / 1000));
+            mMessages++;
+        }
+        if(!Stop)
+            SendNext(index);
+    };
+
+    for(uint32_t i = 0; i < mClients; ++i)
+    for(uint32_t j = 0; j < window; ++j)
+        SendNext(i);
+    auto Pump = [&](uint64_t until)
+    {
+        while(NowNsec() < until && !gInterrupt)
+        {
+            dTelepath::gateCall("127.0.0.1", mTeleClient, BenchMarkIn);
+            if(!dTelepath::nextReceive(mTeleClient))
+                std::this_thread::yield();
+        }
+    };
+    Pump(NowNsec() + 200000000); // 200ms 워밍업
+    const uint64_t BeginNsec = NowNsec();
+    Measure = true;
+    Pump(BeginNsec + mMillisec * (uint64_t) 1000000);
+    Measure = false;
+    const uint64_t EndNsec = NowNsec();
+    Stop = true;
+    for(uint64_t Limit = NowNsec() + 3000000000; NowNsec() < Limit;)
+    {
+        uint32_t Sum = 0;
+        for(auto iFlying : Flying)
+            Sum += iFlying;
+        if(Sum == 0) break;
+        Pump(NowNsec() + 1000000);
+    }
+    mTeleEcho = nullptr;
+
+    mBytes = mMessages * size;
+    report("telepath", "silk", window, size, (EndNsec - BeginNsec) / 1e9);
+}
+
+void BenchKit::clearResult()
+{
+    mMessages = 0;
+    mBytes = 0;
+    mLatencies.clear();
+}
+
+void BenchKit::report(utf8s bench, utf8s transport, uint32_t window, uint32_t size, double seconds)
+{
+    auto Percentile = [this](double rate)->uint32_t
+    {
+        if(mLatencies.empty()) return 0;
+        const size_t Index = std::min(mLatencies.size() - 1, (size_t) (rate * mLatencies.size()));
+        return mLatencies[Index];
+    };
+    std::sort(mLatencies.begin(), mLatencies.end());
+    fprintf(gResult, "{\"bench\":\"%s\",\"transport\":\"%s\",\"clients\":%u,\"window\":%u,\"size\":%u,"
+        "\"seconds\":%.3f,\"messages\":%llu,\"msgs_per_sec\":%.1f,\"mb_per_sec\":%.3f,"
+        "\"p50_us\":%u,\"p99_us\":%u,\"p999_us\":%u}\n",
+        bench, transport, mClients, window, size, seconds, (unsigned long long) mMessages,
+        mMessages / seconds, mBytes / seconds / (1024 * 1024),
+        Percentile(0.5), Percentile(0.99), Percentile(0.999));
+    fflush(gResult);
+}
+
+bool BenchKit::prepareTelepath()
+{
+    if(mTeleTried)
+        return (mTeleServer != -1);
+    mTeleTried = true;
+
+    // 텔레그래프 대신 게이트를 흉내: connect_add를 모아서 클라이언트실크에 connected를 알림
+    if(!mTeleGate.openServer(11019))
+    {
+        fprintf(stderr, "[daddy] could not open the stub gate(11019)\n");
+        return false;
+    }
+    mTeleClient = dTelepath::createClient();
+    mTeleServer = dTelepath::addSilk(dTelepath::SilkType::Server, "bench",
+        [this](dTelepath::TeleID tele, dTelepath::ReceiveType type, dBinary binary)
+        {
+            if(type == dTelepath::ReceiveType::Message)
+                dTelepath::send(mTeleServer, tele, binary);
+            return false;
+        });
+    for(uint32_t i = 0; i < mClients; ++i)
+    {
+        mTeleSilks.push_back(dTelepath::addSilk(dTelepath::SilkType::Client, "bench",
+            [this, i](dTelepath::TeleID, dTelepath::ReceiveType type, dBinary binary)
+            {
+                if(type == dTelepath::ReceiveType::Message && mTeleEcho)
+                    mTeleEcho(i, binary);
+                return false;
+            }));
+    }
+
+    uint16_t ServerPort = 0;
+    std::vector<dTelepath::SilkID> Waitings;
+    for(uint64_t Limit = NowNsec() + 5000000000; NowNsec() < Limit && !gInterrupt;)
+    {
+        dTelepath::gateCall("127.0.0.1", mTeleClient, BenchMarkIn);
+        dTelepath::nextReceive(mTeleClient);
+        mTeleGate.recvAll([&](uint32_t, const dBinary& binary)
+        {
+            const dZokeReader NewReader(binary);
+            if(!strcmp(NewReader("type").getString(), "connect_add"))
+            {
+                if(!strcmp(NewReader("entry").getString(), "server"))
+                    ServerPort = NewReader("port").getUint16();
+                else Waitings.push_back(NewReader("id").getInt32());
+            }
+        });
+        if(ServerPort != 0)
+        {
+            for(auto iSilk : Waitings)
+            {
+                dZoker NewZoker;
+                NewZoker("type").setString("connected");
+                NewZoker("id").setInt32(iSilk);
+                NewZoker("address")("ip4").setString("127.0.0.1");
+                NewZoker("address")("port").setUint16(ServerPort);
+                mTeleGate.sendAll(NewZoker.build(), true);
+            }
+            Waitings.clear();
+        }
+        if(dTelepath::numLinkedTelepath(mTeleServer) == mClients)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    fprintf(stderr, "[daddy] silks could not be linked\n");
+    mTeleServer = -1;
+    return false;
+}
+
+void BenchKit::releaseTelepath()
+{
+    if(mTeleClient)
+    {
+        dTelepath::releaseClient();
+        mTeleClient = nullptr;
+    }
+    mTeleGate.close();
+}
@@ -4,8 +4,17 @@
 #include "dd_binary.hpp"
 
 // Dependencies
+#include <atomic>
 #include <cstring>
 #include <locale.h>
+#if DD_OS_WINDOWS
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
 
 namespace Daddy {
 
@@ -14,9 +23,11 @@ namespace Daddy {
 class BinaryAgentP
 {
 public:
+    static BinaryAgentP* fromMapping(dump* buffer, uint32_t length);
     void attach() const;
     void detach() const;
     BinaryAgentP* add(dumps binary, uint32_t length);
+    BinaryAgentP* sub(uint32_t offset, uint32_t length) const;
 
 public:
     inline dumps buffer() const {return mBuffer;}
@@ -29,13 +40,25 @@ DD_escaper_alone(BinaryAgentP):
         mBuffer = nullptr;
         mWrittenLength = 0;
         mWholeLength = 0;
+        mParent = nullptr;
+        mMapped = false;
         mRefCount = 1;
     }
     void _quit_()
     {
         DD_assert(mRefCount == 0 || mRefCount == 1 || mRefCount == 2,
             "reference count does not match."); // fromExternal는 mRefCount가 2
-        if(mRefCount == 1)
+        if(mParent) // 부분참조는 원본만 반환
+            mParent->detach();
+        else if(mMapped) // 파일매핑은 마지막 참조에서 해제
+        {
+            #if DD_OS_WINDOWS
+                UnmapViewOfFile(mBuffer);
+            #else
+                munmap(mBuffer, mWholeLength);
+            #endif
+        }
+        else if(mRefCount == 1)
             delete[] mBuffer;
     }
     void _move_(_self_&& rhs)
@@ -43,7 +66,9 @@ DD_escaper_alone(BinaryAgentP):
         mBuffer = DD_rvalue(rhs.mBuffer);
         mWrittenLength = DD_rvalue(rhs.mWrittenLength);
         mWholeLength = DD_rvalue(rhs.mWholeLength);
-        mRefCount = DD_rvalue(rhs.mRefCount);
+        mParent = DD_rvalue(rhs.mParent);
+        mMapped = DD_rvalue(rhs.mMapped);
+        mRefCount = rhs.mRefCount.load();
     }
     void _copy_(const _self_& rhs)
     {
@@ -52,7 +77,9 @@ DD_escaper_alone(BinaryAgentP):
     dump* mBuffer;
     uint32_t mWrittenLength;
     uint32_t mWholeLength;
-    mutable int32_t mRefCount;
+    const BinaryAgentP* mParent;
+    bool mMapped; // 읽기전용 파일매핑(여유공간이 없으므로 add시 분리됨)
+    mutable std::atomic<int32_t> mRefCount; // 스레드간 공유가능
 
 public:
     DD_passage_alone(BinaryAgentP, dump* buffer, uint32_t written, uint32_t whole)
@@ -65,6 +92,13 @@ public:
     }
 };
 
+BinaryAgentP* BinaryAgentP::fromMapping(dump* buffer, uint32_t length)
+{
+    auto NewAgent = new BinaryAgentP(buffer, length, length);
+    NewAgent->mMapped = true;
+    return NewAgent;
+}
+
 void BinaryAgentP::attach() const
 {
     mRefCount++;
@@ -97,6 +131,14 @@ BinaryAgentP* BinaryAgentP::add(dumps buffer, uint32_t length)
     return this;
 }
 
+BinaryAgentP* BinaryAgentP::sub(uint32_t offset, uint32_t length) const
+{
+    auto NewAgent = new BinaryAgentP(mBuffer + offset, length, length); // 여유공간이 없으므로 add시 분리됨
+    NewAgent->mParent = (mParent)? mParent : this;
+    NewAgent->mParent->attach();
+    return NewAgent;
+}
+
 dump BinaryAgentP::operator[](int32_t index) const
 {
     DD_assert(0 <= index && index < (int32_t) mWrittenLength, "the index has exceeded the array limit.");
@@ -129,6 +171,19 @@ dBinary& dBinary::add(dumps buffer, uint32_t length)
     return *this;
 }
 
+dBinary dBinary::sub(uint32_t offset, int32_t length) const
+{
+    const uint32_t WholeLength = mRefAgent->length();
+    DD_assert(offset <= WholeLength, "the offset has exceeded the binary limit.");
+    const uint32_t SubLength = (length == -1)? WholeLength - offset : (uint32_t) length;
+    DD_assert(offset + SubLength <= WholeLength, "the length has exceeded the binary limit.");
+
+    dBinary Result;
+    Result.mRefAgent->detach();
+    Result.mRefAgent = mRefAgent->sub(offset, SubLength);
+    return Result;
+}
+
 dump dBinary::operator[](int32_t index) const
 {
     return (*mRefAgent)[index];
@@ -172,6 +227,55 @@ dBinary dBinary::fromFile(const dLiteral& path)
     return dBinary();
 }
 
+dBinary dBinary::fromMappedFile(const dLiteral& path)
+{
+    dump* NewBuffer = nullptr;
+    uint64_t NewLength = 0;
+    #if DD_OS_WINDOWS
+        HANDLE NewFile = CreateFileA(path.buildNative(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(NewFile != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER FileSize;
+            if(GetFileSizeEx(NewFile, &FileSize) && 0 < FileSize.QuadPart && FileSize.QuadPart <= 0xFFFFFFFF)
+            {
+                NewLength = (uint64_t) FileSize.QuadPart;
+                if(HANDLE NewMap = CreateFileMappingA(NewFile, nullptr, PAGE_READONLY, 0, 0, nullptr))
+                {
+                    NewBuffer = (dump*) MapViewOfFile(NewMap, FILE_MAP_READ, 0, 0, 0);
+                    CloseHandle(NewMap); // 뷰가 매핑을 유지
+                }
+            }
+            CloseHandle(NewFile);
+        }
+    #else
+        const int NewFile = open(path.buildNative(), O_RDONLY);
+        if(NewFile != -1)
+        {
+            struct stat NewStat;
+            if(fstat(NewFile, &NewStat) == 0 && 0 < NewStat.st_size && NewStat.st_size <= 0xFFFFFFFF)
+            {
+                NewLength = (uint64_t) NewStat.st_size;
+                void* NewMap = mmap(nullptr, NewLength, PROT_READ, MAP_SHARED, NewFile, 0);
+                if(NewMap != MAP_FAILED)
+                {
+                    posix_madvise(NewMap, NewLength, POSIX_MADV_RANDOM); // 접근한 페이지만 로드
+                    NewBuffer = (dump*) NewMap;
+                }
+            }
+            close(NewFile); // 매핑은 fd를 닫아도 유지
+        }
+    #endif
+
+    if(NewBuffer)
+    {
+        dBinary Result;
+        Result.mRefAgent->detach();
+        Result.mRefAgent = BinaryAgentP::fromMapping(NewBuffer, (uint32_t) NewLength);
+        return Result;
+    }
+    return dBinary();
+}
+
 bool dBinary::toFile(const dLiteral& path) const
 {
     dString OldLocale = setlocale(LC_ALL, nullptr);
@@ -31,6 +31,12 @@ public: // 사용성
     /// @return         연결되어 확장된 자기 객체
     dBinary& add(dumps buffer, uint32_t length);
 
+    /// @brief          부분 바이너리 반환(복사없이 원본버퍼를 참조)
+    /// @param offset   시작위치
+    /// @param length   길이(-1이면 끝까지)
+    /// @return         새로운 객체
+    dBinary sub(uint32_t offset, int32_t length = -1) const;
+
 public: // 연산자
     /// @brief          한 글자 반환
     /// @param index    지정된 위치
@@ -60,6 +66,11 @@ public: // 입출력
     /// @return         새로운 객체
     static dBinary fromFile(const dLiteral& path);
 
+    /// @brief          파일을 매핑하여 바이너리 가져오기(읽기전용, 접근한 페이지만 로드되며 프로세스간 공유)
+    /// @param path     파일경로
+    /// @return         새로운 객체(4GB미만의 파일만, 실패하면 빈 객체)
+    static dBinary fromMappedFile(const dLiteral& path);
+
     /// @brief          파일로 바이너리 내보내기
     /// @param path     파일경로
     /// @return         true-성공, false-실패
@@ -156,7 +156,7 @@
             return gSingleton; \
         } \
         inline static Daddy::EscapeModel* __model(Daddy::EscapePlanP* ep = nullptr) { \
-            static Daddy::EscapeModel gSingleton(ep); \
+            static Daddy::EscapeModel gSingleton((ep)? ep : __em_plan()); /* 소멸이 먼저일 수 있음(핫리로드된 빌드) */ \
             return &gSingleton; \
         } \
     \
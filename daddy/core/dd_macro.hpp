@@ -10,6 +10,7 @@
     - dd_handle.hpp/dHandle: 사용자 객체의 스마트한 핸들관리
     - dd_markup.hpp/dMarkup: 구조적데이터관리(현재 yaml파서)
     - dd_platform.hpp/dSocket: 서버/클라이언트의 역할모델
+    - dd_platform.hpp/dAsyncSocket: 완료통지형 비동기소켓(코루틴지원)
     - dd_platform.hpp/dUtility: 유틸리티 기능제공(현재 프로세스관리)
     - dd_string.hpp/dLiteral: 상수를 보장하는 스트링객체
     - dd_string.hpp/dString: 복사하지 않고 스트링끼리 부분참조되는 스트링객체
@@ -65,6 +66,19 @@
     #pragma message("[daddy] build is intel")
 #endif //}
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ build environment check - coroutine //{ coroutine매크로 확인!
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+    #if __has_include(<coroutine>)
+        #define DD_BUILD_COROUTINE 1
+        #pragma message("[daddy] build is coroutine")
+    #else
+        #define DD_BUILD_COROUTINE 0
+    #endif
+#else
+    #define DD_BUILD_COROUTINE 0
+#endif //}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ build environment check - windows //bx200618-check:{ windows매크로 확인!
 #if defined(_WIN32) || defined(_WIN64)
@@ -6,11 +6,15 @@
 // Dependencies
 #include "dd_binary.hpp"
 #include "dd_thread.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <csignal>
-#include <map>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <thread>
-#include <stack>
+#include <vector>
 #if DD_OS_WINDOWS
     #if DD_OS_WINDOWS_MINGW
         #include <ws2tcpip.h>
@@ -23,6 +27,10 @@
     #define SOCKET_DATA                       SOCKET
     #define SOCKET_NEW                        socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)
     #define SOCKET_SET_KEEPALIVE(S)           do {char _ = 1; setsockopt(S, SOL_SOCKET, SO_KEEPALIVE, &_, sizeof(_));} while(false)
+    #define SOCKET_SET_NODELAY(S, ON)         do {char _ = (ON)? 1 : 0; setsockopt(S, IPPROTO_TCP, TCP_NODELAY, &_, sizeof(_));} while(false)
+    #define SOCKET_SET_CORK(S, ON)            DD_nothing
+    #define SOCKET_SET_REUSEADDR(S)           DD_nothing
+    #define SOCKET_SET_REUSEPORT(S, RET)      do {RET = false;} while(false)
     #define SOCKET_SET_TIMEOUT(S, MSEC, RET)  do {fd_set fd; FD_ZERO(&fd); FD_SET(S, &fd); \
                                               struct timeval _ = {0, (MSEC) * 1000}; \
                                               RET = select(int(S + 1), &fd, nullptr, nullptr, &_);} while(false)
@@ -34,6 +42,11 @@
     #define SOCKET_SEND(S, BUF, LEN)          send(S, (const char*) BUF, LEN, 0)
     #define SOCKET_RECV(S, BUF, LEN)          recv(S, (char*) BUF, LEN, 0)
     #define SOCKET_RECVLEN(S, LEN)            ioctlsocket(S, FIONREAD, (u_long*) &LEN)
+    #define SOCKET_SET_NONBLOCK(S)            do {u_long _ = 1; ioctlsocket(S, FIONBIO, &_);} while(false)
+    #define SOCKET_SET_BLOCK(S)               do {u_long _ = 0; ioctlsocket(S, FIONBIO, &_);} while(false)
+    #define SOCKET_GET_ERROR(S, RET)          do {int _ = sizeof(RET); getsockopt(S, SOL_SOCKET, SO_ERROR, (char*) &RET, &_);} while(false)
+    #define SOCKET_POLL(FDS, COUNT, MSEC)     WSAPoll(FDS, (ULONG) (COUNT), MSEC)
+    #define SOCKET_WOULDBLOCK                 (WSAGetLastError() == WSAEWOULDBLOCK)
     #undef min
     #undef max
 #elif DD_OS_LINUX
@@ -41,15 +54,27 @@
     #include <cstring>
     #include <netdb.h>
     #include <netinet/in.h>
+    #include <fcntl.h>
     #include <sys/ioctl.h>
+    #include <sys/mman.h>
+    #include <netinet/tcp.h>
     #include <sys/socket.h>
     #include <sys/types.h>
+    #include <sys/uio.h>
     #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
     #include <dirent.h>
+    #include <poll.h>
     #include <unistd.h>
+    #include <cerrno>
     #define SOCKET_DATA                       int
     #define SOCKET_NEW                        ::socket(AF_INET, SOCK_STREAM, 0)
     #define SOCKET_SET_KEEPALIVE(S)           do {int _ = 1; ::setsockopt(S, SOL_SOCKET, SO_KEEPALIVE, &_, sizeof(_));} while(false)
+    #define SOCKET_SET_NODELAY(S, ON)         do {int _ = (ON)? 1 : 0; ::setsockopt(S, IPPROTO_TCP, TCP_NODELAY, &_, sizeof(_));} while(false)
+    #define SOCKET_SET_CORK(S, ON)            do {int _ = (ON)? 1 : 0; ::setsockopt(S, IPPROTO_TCP, TCP_CORK, &_, sizeof(_));} while(false)
+    #define SOCKET_SET_REUSEADDR(S)           do {int _ = 1; ::setsockopt(S, SOL_SOCKET, SO_REUSEADDR, &_, sizeof(_));} while(false)
+    #define SOCKET_SET_REUSEPORT(S, RET)      do {int _ = 1; RET = (::setsockopt(S, SOL_SOCKET, SO_REUSEPORT, &_, sizeof(_)) == 0);} while(false)
     #define SOCKET_SET_TIMEOUT(S, MSEC, RET)  do {fd_set fd; FD_ZERO(&fd); FD_SET(S, &fd); \
                                               struct timeval _ = {0, (MSEC) * 1000}; \
                                               RET = ::select(S + 1, &fd, nullptr, nullptr, &_);} while(false)
@@ -61,12 +86,226 @@
     #define SOCKET_SEND(S, BUF, LEN)          ::send(S, BUF, LEN, MSG_NOSIGNAL)
     #define SOCKET_RECV(S, BUF, LEN)          ::recv(S, BUF, LEN, MSG_NOSIGNAL)
     #define SOCKET_RECVLEN(S, LEN)            ::ioctl(S, FIONREAD, &LEN)
+    #define SOCKET_SET_NONBLOCK(S)            do {::fcntl(S, F_SETFL, ::fcntl(S, F_GETFL, 0) | O_NONBLOCK);} while(false)
+    #define SOCKET_SET_BLOCK(S)               do {::fcntl(S, F_SETFL, ::fcntl(S, F_GETFL, 0) & ~O_NONBLOCK);} while(false)
+    #define SOCKET_GET_ERROR(S, RET)          do {socklen_t _ = sizeof(RET); ::getsockopt(S, SOL_SOCKET, SO_ERROR, &RET, &_);} while(false)
+    #define SOCKET_POLL(FDS, COUNT, MSEC)     ::poll(FDS, (nfds_t) (COUNT), MSEC)
+    #define SOCKET_WOULDBLOCK                 (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS)
     #define SOCKET_ERROR                      (-1)
 #endif
 typedef SOCKET_DATA SocketData;
 
 namespace Daddy {
 
+static uint64_t nowMsec()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ SharedRingP
+// 같은 머신의 상대방과 공유메모리로 주고받는 SPSC링(방향별 1개씩)
+class SharedRingP
+{
+public:
+    static SharedRingP* create();
+    static SharedRingP* open(utf8s name);
+    ~SharedRingP();
+
+public:
+    uint32_t readable() const;
+    uint32_t read(dump* buffer, uint32_t length);
+    uint32_t write(dumps buffer, uint32_t length);
+    void waitWritable(uint32_t timeout);
+    void unlink();
+    bool isClosed() const;
+
+public:
+    inline utf8s name() const
+    {return mName;}
+
+private:
+    enum {RingMagic = 0x444452, RingSize = 0x100000}; // 1MB(2의 승수)
+    struct Ring
+    {
+        std::atomic<uint32_t> mHead; // 생산자만 갱신
+        uint8_t mPadA[60];
+        std::atomic<uint32_t> mTail; // 소비자만 갱신(futex로 생산자를 깨움)
+        std::atomic<uint32_t> mWaiting; // 생산자가 가득찬 링에서 대기중
+        uint8_t mPadB[56];
+        dump mData[RingSize];
+    };
+    struct Layout
+    {
+        uint32_t mMagic;
+        std::atomic<uint32_t> mClosed;
+        uint8_t mPad[56];
+        Ring mRings[2]; // [0]: 클라이언트→서버, [1]: 서버→클라이언트
+    };
+    SharedRingP(Layout* layout, utf8s name, bool owner);
+
+private:
+    Layout* mLayout;
+    Ring* mSendRing;
+    Ring* mRecvRing;
+    utf8 mName[64];
+    bool mNeedUnlink;
+};
+
+#if DD_OS_LINUX
+    // 공유메모리의 값으로 프로세스간 대기(값이 이미 바뀌었으면 곧바로 반환)
+    static void futexWait(std::atomic<uint32_t>* value, uint32_t expected, uint32_t msec)
+    {
+        struct timespec Timeout;
+        Timeout.tv_sec = time_t(msec / 1000);
+        Timeout.tv_nsec = long(msec % 1000) * 1000000;
+        ::syscall(SYS_futex, (uint32_t*) value, FUTEX_WAIT, expected, &Timeout, nullptr, 0);
+    }
+
+    static void futexWake(std::atomic<uint32_t>* value)
+    {
+        ::syscall(SYS_futex, (uint32_t*) value, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+#endif
+
+SharedRingP* SharedRingP::create()
+{
+    #if DD_OS_LINUX
+        static std::atomic<uint32_t> gLastRingID(0);
+        utf8 NewName[64];
+        snprintf(NewName, sizeof(NewName), "/daddy.%d.%u", (int) getpid(), ++gLastRingID);
+
+        const int NewFile = shm_open(NewName, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(NewFile == -1) return nullptr;
+        if(ftruncate(NewFile, sizeof(Layout)) == 0)
+        {
+            void* NewMap = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, NewFile, 0);
+            ::close(NewFile);
+            if(NewMap != MAP_FAILED)
+            {
+                auto NewLayout = (Layout*) NewMap; // ftruncate로 0초기화됨
+                NewLayout->mMagic = RingMagic;
+                return new SharedRingP(NewLayout, NewName, true);
+            }
+        }
+        else ::close(NewFile);
+        shm_unlink(NewName);
+    #endif
+    return nullptr;
+}
+
+SharedRingP* SharedRingP::open(utf8s name)
+{
+    #if DD_OS_LINUX
+        const int OldFile = shm_open(name, O_RDWR, 0600);
+        if(OldFile == -1) return nullptr;
+        struct stat FileStat;
+        if(fstat(OldFile, &FileStat) == 0 && FileStat.st_size == (off_t) sizeof(Layout))
+        {
+            void* OldMap = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, OldFile, 0);
+            ::close(OldFile);
+            if(OldMap != MAP_FAILED)
+            {
+                auto OldLayout = (Layout*) OldMap;
+                if(OldLayout->mMagic == RingMagic)
+                {
+                    // 양쪽이 매핑했으므로 이름은 바로 제거(이후 어느쪽이 죽어도 남지 않도록)
+                    shm_unlink(name);
+                    return new SharedRingP(OldLayout, name, false);
+                }
+                munmap(OldMap, sizeof(Layout));
+            }
+        }
+        else ::close(OldFile);
+    #endif
+    return nullptr;
+}
+
+SharedRingP::SharedRingP(Layout* layout, utf8s name, bool owner)
+{
+    mLayout = layout;
+    mSendRing = &layout->mRings[(owner)? 0 : 1];
+    mRecvRing = &layout->mRings[(owner)? 1 : 0];
+    strncpy(mName, name, sizeof(mName) - 1);
+    mName[sizeof(mName) - 1] = '\0';
+    mNeedUnlink = owner;
+}
+
+SharedRingP::~SharedRingP()
+{
+    #if DD_OS_LINUX
+        mLayout->mClosed.store(1, std::memory_order_release);
+        futexWake(&mLayout->mRings[0].mTail); // 대기중인 상대방이 종료를 확인하도록
+        futexWake(&mLayout->mRings[1].mTail);
+        munmap(mLayout, sizeof(Layout));
+        unlink();
+    #endif
+}
+
+uint32_t SharedRingP::readable() const
+{
+    return mRecvRing->mHead.load(std::memory_order_acquire) - mRecvRing->mTail.load(std::memory_order_relaxed);
+}
+
+uint32_t SharedRingP::read(dump* buffer, uint32_t length)
+{
+    const uint32_t Head = mRecvRing->mHead.load(std::memory_order_acquire);
+    const uint32_t Tail = mRecvRing->mTail.load(std::memory_order_relaxed);
+    const uint32_t Length = std::min(Head - Tail, length);
+    const uint32_t Pos = Tail & (RingSize - 1);
+    const uint32_t FirstLength = std::min(Length, RingSize - Pos);
+    memcpy(buffer, &mRecvRing->mData[Pos], FirstLength);
+    memcpy(&buffer[FirstLength], &mRecvRing->mData[0], Length - FirstLength);
+    mRecvRing->mTail.store(Tail + Length, std::memory_order_seq_cst);
+    #if DD_OS_LINUX
+        if(0 < Length && mRecvRing->mWaiting.load(std::memory_order_seq_cst) != 0)
+            futexWake(&mRecvRing->mTail);
+    #endif
+    return Length;
+}
+
+uint32_t SharedRingP::write(dumps buffer, uint32_t length)
+{
+    const uint32_t Head = mSendRing->mHead.load(std::memory_order_relaxed);
+    const uint32_t Tail = mSendRing->mTail.load(std::memory_order_acquire);
+    const uint32_t Length = std::min(RingSize - (Head - Tail), length);
+    const uint32_t Pos = Head & (RingSize - 1);
+    const uint32_t FirstLength = std::min(Length, RingSize - Pos);
+    memcpy(&mSendRing->mData[Pos], buffer, FirstLength);
+    memcpy(&mSendRing->mData[0], &buffer[FirstLength], Length - FirstLength);
+    mSendRing->mHead.store(Head + Length, std::memory_order_release);
+    return Length;
+}
+
+void SharedRingP::waitWritable(uint32_t timeout)
+{
+    #if DD_OS_LINUX
+        // 소비자가 mTail을 옮기면서 깨워줌
+        const uint32_t Tail = mSendRing->mTail.load(std::memory_order_seq_cst);
+        mSendRing->mWaiting.store(1, std::memory_order_seq_cst);
+        if(mSendRing->mHead.load(std::memory_order_relaxed) - Tail == RingSize && !isClosed())
+            futexWait(&mSendRing->mTail, Tail, timeout);
+        mSendRing->mWaiting.store(0, std::memory_order_relaxed);
+    #endif
+}
+
+void SharedRingP::unlink()
+{
+    #if DD_OS_LINUX
+        if(mNeedUnlink)
+        {
+            shm_unlink(mName);
+            mNeedUnlink = false;
+        }
+    #endif
+}
+
+bool SharedRingP::isClosed() const
+{
+    return (mLayout->mClosed.load(std::memory_order_acquire) != 0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ SocketAgentP
 class SocketAgentP : public dEscaper
@@ -81,15 +320,56 @@ public:
 
 public:
     virtual uint32_t count() const;
-    virtual bool sendTo(uint32_t id, const dBinary& binary, bool sizefield);
-    virtual bool sendAll(const dBinary& binary, bool sizefield);
+    virtual bool sendTo(uint32_t id, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield);
+    virtual bool sendAll(dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield);
+    virtual uint32_t sendSome(const uint32_t* ids, uint32_t count, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield);
     virtual dBinary recvFrom(uint32_t id);
     virtual void recvAll(dSocket::RecvCB cb);
+    virtual void setDelivery(dSocket::DeliveryType type);
+    virtual bool flush();
+    virtual uint32_t queued() const;
+    virtual bool ping();
+    virtual uint32_t latency() const;
+    virtual bool shareLocalRing();
     virtual void kick(uint32_t id);
+    virtual void setHeartbeat(uint32_t interval, uint32_t timeout);
+    virtual dSocket::PeerType peerType(uint32_t id) const;
+
+public:
+    bool greet();
+    bool connecting();
+    dBinary takeQueued();
+    void initBeat(uint32_t interval, uint32_t timeout);
+    uint32_t beat(uint64_t nowmsec);
 
 public:
     inline bool isConnected() const
     {return (mSocket != SOCKET_ERROR);}
+    inline bool needBeatTimer() const
+    {return (mBeatInterval != 0 && mBeatTimer == 0);}
+    inline uint32_t beatInterval() const
+    {return mBeatInterval;}
+    inline void setBeatTimer(uint32_t timer)
+    {mBeatTimer = timer;}
+    inline SocketData handle() const
+    {return mSocket;}
+    inline bool isRingRecv() const
+    {return mRingRecv;}
+    inline void beginConnect()
+    {mConnecting = true;}
+
+private:
+    enum ControlCode : uint8_t {RingOffer = 1, RingAccept, RingReject, RingSwitch, Ping, Pong};
+    enum {RingStallMsec = 3000}; // 가득찬 링이 이만큼 비워지지 않으면 상대방이 멈춘 것
+    bool offerRing();
+    bool sendFully(dumps buffer, uint32_t length);
+    bool sendFrame(dumps header, uint32_t headerlength, dumps buffer, uint32_t length, uint32_t flag = 0);
+    bool sendControl(ControlCode code, dumps data = nullptr, uint32_t length = 0);
+    void onControl(dumps payload, uint32_t length);
+    bool writeRing(dumps buffer, uint32_t length);
+    bool readableLength(uint32_t& length);
+    bool readSome(dump* buffer, uint32_t length);
+    void enqueue(dumps buffer, uint32_t length);
 
 DD_escaper(SocketAgentP, dEscaper):
     void _init_(InitType)
@@ -99,12 +379,32 @@ DD_escaper(SocketAgentP, dEscaper):
         mWaitForDumpLength = 0;
         mWaitForDumpPos = 0;
         mWaitForDumps = nullptr;
+        mDelivery = dSocket::DeliveryType::Normal;
+        mSendQueueLength = 0;
+        mSendQueueSize = 0;
+        mSendQueue = nullptr;
+        mWaitForControl = false;
+        mConnecting = false;
+        mPeerType = dSocket::PeerType::Unknown;
+        mRingWanted = false;
+        mRing = nullptr;
+        mRingSend = false;
+        mRingRecv = false;
+        mLatency = 0;
+        mBeatInterval = 0;
+        mBeatTimeout = 0;
+        mLastRecvMsec = 0;
+        mLastBeatMsec = 0;
+        mNextBeatMsec = 0;
+        mBeatTimer = 0;
+        mBeatSelf = false;
         mRefCount = 1;
     }
     void _quit_()
     {
         DD_assert(mRefCount == 0 || mRefCount == 1, "reference count does not match.");
         disconnect();
+        delete[] mSendQueue;
     }
     void _move_(_self_&& rhs)
     {
@@ -113,6 +413,25 @@ DD_escaper(SocketAgentP, dEscaper):
         mWaitForDumpLength = DD_rvalue(rhs.mWaitForDumpLength);
         mWaitForDumpPos = DD_rvalue(rhs.mWaitForDumpPos);
         mWaitForDumps = DD_rvalue(rhs.mWaitForDumps);
+        mDelivery = DD_rvalue(rhs.mDelivery);
+        mSendQueueLength = DD_rvalue(rhs.mSendQueueLength);
+        mSendQueueSize = DD_rvalue(rhs.mSendQueueSize);
+        mSendQueue = DD_rvalue(rhs.mSendQueue);
+        mWaitForControl = DD_rvalue(rhs.mWaitForControl);
+        mConnecting = DD_rvalue(rhs.mConnecting);
+        mPeerType = DD_rvalue(rhs.mPeerType);
+        mRingWanted = DD_rvalue(rhs.mRingWanted);
+        mRing = DD_rvalue(rhs.mRing);
+        mRingSend = DD_rvalue(rhs.mRingSend);
+        mRingRecv = DD_rvalue(rhs.mRingRecv);
+        mLatency = DD_rvalue(rhs.mLatency);
+        mBeatInterval = DD_rvalue(rhs.mBeatInterval);
+        mBeatTimeout = DD_rvalue(rhs.mBeatTimeout);
+        mLastRecvMsec = DD_rvalue(rhs.mLastRecvMsec);
+        mLastBeatMsec = DD_rvalue(rhs.mLastBeatMsec);
+        mNextBeatMsec = DD_rvalue(rhs.mNextBeatMsec);
+        mBeatTimer = DD_rvalue(rhs.mBeatTimer);
+        mBeatSelf = DD_rvalue(rhs.mBeatSelf);
         mRefCount = DD_rvalue(rhs.mRefCount);
     }
     SocketData mSocket;
@@ -120,6 +439,25 @@ DD_escaper(SocketAgentP, dEscaper):
     uint32_t mWaitForDumpLength;
     uint32_t mWaitForDumpPos;
     dump* mWaitForDumps;
+    dSocket::DeliveryType mDelivery;
+    uint32_t mSendQueueLength;
+    uint32_t mSendQueueSize;
+    dump* mSendQueue;
+    bool mWaitForControl;
+    bool mConnecting; // 비동기 connect의 완료를 기다리는 중
+    dSocket::PeerType mPeerType; // 상대방이 빈 프레임으로 컨트롤프레임을 안다고 알려오면 Current
+    bool mRingWanted; // 상대방이 알려오면 링을 제안
+    SharedRingP* mRing;
+    bool mRingSend;
+    bool mRingRecv;
+    uint32_t mLatency;
+    uint32_t mBeatInterval; // 0이면 하트비트없음
+    uint32_t mBeatTimeout;
+    uint64_t mLastRecvMsec; // 마지막으로 무엇이든 받은 시각
+    uint64_t mLastBeatMsec; // 마지막으로 ping을 보낸 시각
+    uint64_t mNextBeatMsec; // 스스로 확인하는 다음 시각(클라이언트)
+    uint32_t mBeatTimer; // 서버샤드의 타이머휠에 등록된 TimerID(상대방)
+    bool mBeatSelf; // true-recvFrom에서 스스로 확인, false-서버샤드의 타이머휠이 확인
     mutable int32_t mRefCount;
 
 public:
@@ -176,11 +514,19 @@ void SocketAgentP::detach() const
 
 void SocketAgentP::disconnect()
 {
+    // 큐잉분은 takeQueued로 꺼낼 수 있도록 소멸시까지 보관
     if(mWaitForDumps)
     {
         delete[] mWaitForDumps;
         mWaitForDumps = nullptr;
     }
+    if(mRing)
+    {
+        delete mRing;
+        mRing = nullptr;
+        mRingSend = false;
+        mRingRecv = false;
+    }
     if(mSocket != SOCKET_ERROR)
     {
         SOCKET_DELETE(mSocket);
@@ -191,45 +537,94 @@ void SocketAgentP::disconnect()
 
 uint32_t SocketAgentP::count() const
 {
-    return (isConnected())? 1 : 0;
+    return (isConnected() && !mConnecting)? 1 : 0;
 }
 
-bool SocketAgentP::sendTo(uint32_t, const dBinary& binary, bool sizefield)
+bool SocketAgentP::sendTo(uint32_t, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield)
 {
     if(mSocket != SOCKET_ERROR)
     {
-        const uint32_t Length = binary.length();
-        if(sizefield)
+        const uint32_t Length = headerlength + binary.length();
+        if(mDelivery == dSocket::DeliveryType::Throughput)
+        {
+            if(sizefield)
+                enqueue((dumps) &Length, 4);
+            if(0 < headerlength)
+                enqueue(header, headerlength);
+            enqueue(binary.buffer(), binary.length());
+            if(mSendQueueLength < 0x10000) // 64KB까지는 flush를 기다림
+                return true;
+            return flush();
+        }
+        else if(mRingSend)
         {
-            if(0 <= SOCKET_SEND(mSocket, &Length, 4))
-            if(0 <= SOCKET_SEND(mSocket, binary.buffer(), Length))
+            if((!sizefield || writeRing((dumps) &Length, 4))
+                && (headerlength == 0 || writeRing(header, headerlength))
+                && writeRing(binary.buffer(), binary.length()))
                 return true;
         }
-        else if(0 <= SOCKET_SEND(mSocket, binary.buffer(), Length))
+        else if(sizefield)
+        {
+            if(sendFrame(header, headerlength, binary.buffer(), binary.length()))
+                return true;
+        }
+        else if((headerlength == 0 || sendFully(header, headerlength)) && sendFully(binary.buffer(), binary.length()))
             return true;
         disconnect();
     }
     return false;
 }
 
-bool SocketAgentP::sendAll(const dBinary& binary, bool sizefield)
+bool SocketAgentP::sendAll(dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield)
+{
+    return sendTo(0, header, headerlength, binary, sizefield);
+}
+
+uint32_t SocketAgentP::sendSome(const uint32_t* ids, uint32_t count, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield)
 {
-    return sendTo(0, binary, sizefield);
+    uint32_t Result = 0;
+    for(uint32_t i = 0; i < count; ++i)
+        if(sendTo(ids[i], header, headerlength, binary, sizefield))
+            Result++;
+    return Result;
 }
 
 dBinary SocketAgentP::recvFrom(uint32_t)
 {
+    if(mConnecting)
+        return dBinary();
+    if(mBeatSelf)
+    {
+        const uint64_t NowMsec = nowMsec();
+        if(mNextBeatMsec <= NowMsec)
+        {
+            const uint32_t NextMsec = beat(NowMsec);
+            mNextBeatMsec = NowMsec + NextMsec;
+            mBeatSelf = (NextMsec != 0);
+        }
+    }
     if(mSocket != SOCKET_ERROR)
     {
         if(mWaitForDumps == nullptr)
         {
             uint32_t RecvLength = 0;
-            if(0 <= SOCKET_RECVLEN(mSocket, RecvLength))
+            if(readableLength(RecvLength))
             {
                 if(4 <= RecvLength)
                 {
-                    if(0 <= SOCKET_RECV(mSocket, &mWaitForDumpLength, 4))
+                    if(readSome((dump*) &mWaitForDumpLength, 4))
                     {
+                        if(mWaitForDumpLength == 0) // 빈 프레임은 상대방의 인사
+                        {
+                            mPeerType = dSocket::PeerType::Current;
+                            if(mRingWanted && !offerRing())
+                                disconnect();
+                            return dBinary();
+                        }
+                        if(mPeerType == dSocket::PeerType::Unknown) // 인사없이 온 프레임은 이전 버전
+                            mPeerType = dSocket::PeerType::Legacy;
+                        mWaitForControl = !!(mWaitForDumpLength & 0x80000000); // 컨트롤프레임
+                        mWaitForDumpLength &= 0x7FFFFFFF;
                         mWaitForDumpPos = 0;
                         mWaitForDumps = new dump[mWaitForDumpLength];
                     }
@@ -241,18 +636,24 @@ dBinary SocketAgentP::recvFrom(uint32_t)
         if(mWaitForDumps != nullptr)
         {
             uint32_t RecvLength = 0;
-            if(0 <= SOCKET_RECVLEN(mSocket, RecvLength))
+            if(readableLength(RecvLength))
             {
                 if(0 < RecvLength)
                 {
                     if(mWaitForDumpLength - mWaitForDumpPos < RecvLength)
                         RecvLength = mWaitForDumpLength - mWaitForDumpPos;
-                    if(0 <= SOCKET_RECV(mSocket, &mWaitForDumps[mWaitForDumpPos], RecvLength))
+                    if(readSome(&mWaitForDumps[mWaitForDumpPos], RecvLength))
                     {
                         if((mWaitForDumpPos += RecvLength) == mWaitForDumpLength)
                         {
                             dump* OldDumps = mWaitForDumps;
                             mWaitForDumps = nullptr;
+                            if(mWaitForControl)
+                            {
+                                onControl(OldDumps, mWaitForDumpLength);
+                                delete[] OldDumps;
+                                return dBinary();
+                            }
                             return dBinary::fromInternal(OldDumps, mWaitForDumpLength);
                         }
                     }
@@ -273,219 +674,1686 @@ void SocketAgentP::recvAll(dSocket::RecvCB cb)
         cb(0, Result);
 }
 
-void SocketAgentP::kick(uint32_t)
+void SocketAgentP::setDelivery(dSocket::DeliveryType type)
 {
-    disconnect();
+    if(mDelivery == dSocket::DeliveryType::Throughput && type != dSocket::DeliveryType::Throughput)
+        flush();
+    mDelivery = type;
+    if(mSocket != SOCKET_ERROR)
+        SOCKET_SET_NODELAY(mSocket, type == dSocket::DeliveryType::LowLatency);
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// ■ ServerAgentP
-class ServerAgentP : public SocketAgentP
+bool SocketAgentP::flush()
 {
-public:
-    uint32_t count() const override;
-    bool sendTo(uint32_t id, const dBinary& binary, bool sizefield) override;
-    bool sendAll(const dBinary& binary, bool sizefield) override;
-    dBinary recvFrom(uint32_t id) override;
-    void recvAll(dSocket::RecvCB cb) override;
-    void kick(uint32_t id) override;
+    if(mSocket == SOCKET_ERROR)
+        return false;
+    if(mSendQueueLength == 0)
+        return true;
 
-DD_escaper(ServerAgentP, SocketAgentP):
-    void _init_(InitType type)
+    if(mRingSend)
     {
-        SocketAgentP::_init_(type);
-        mPeers = (type == InitType::Create)? new std::map<uint32_t, SocketAgentP*>() : nullptr;
-        mLastAcceptID = 0;
-        mInterrupted = false;
-        mAcceptor = nullptr;
+        const bool Result = writeRing(mSendQueue, mSendQueueLength);
+        if(Result) mSendQueueLength = 0;
+        else disconnect();
+        return Result;
     }
-    void _quit_()
+
+    // 코르크로 막아두고 일괄발송하여 꽉 찬 세그먼트로만 전송
+    SOCKET_SET_CORK(mSocket, true);
+    const bool Result = sendFully(mSendQueue, mSendQueueLength);
+    if(!Result)
     {
-        mPeerMutex.lock();
-        {
-            for(const auto& iSocket : *mPeers)
-                if(iSocket.second)
-                    iSocket.second->detach();
-            delete mPeers;
-        }
-        mPeerMutex.unlock();
+        disconnect();
+        return false;
+    }
+    mSendQueueLength = 0;
+    SOCKET_SET_CORK(mSocket, false);
+    return true;
+}
 
-        if(mAcceptor)
-        {
-            mInterrupted = true;
-            mAcceptor->join();
-            delete mAcceptor;
-        }
-        SocketAgentP::_quit_();
+uint32_t SocketAgentP::queued() const
+{
+    return mSendQueueLength;
+}
+
+bool SocketAgentP::ping()
+{
+    if(mSocket == SOCKET_ERROR)
+        return false;
+    const int64_t NowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if(sendControl(Ping, (dumps) &NowNs, 8))
+        return true;
+    disconnect();
+    return false;
+}
+
+uint32_t SocketAgentP::latency() const
+{
+    return mLatency;
+}
+
+void SocketAgentP::setHeartbeat(uint32_t interval, uint32_t timeout)
+{
+    initBeat(interval, timeout);
+    mNextBeatMsec = 0;
+    mBeatSelf = (interval != 0);
+}
+
+void SocketAgentP::initBeat(uint32_t interval, uint32_t timeout)
+{
+    mBeatInterval = interval;
+    mBeatTimeout = (timeout == 0)? interval * 3 : std::max(timeout, interval);
+    mLastRecvMsec = mLastBeatMsec = nowMsec();
+}
+
+uint32_t SocketAgentP::beat(uint64_t nowmsec)
+{
+    // 조용한 상대방에게만 ping, 그 회신(pong)도 수신이므로 살아있으면 타임아웃전에 갱신됨
+    if(mSocket == SOCKET_ERROR || mBeatInterval == 0)
+        return 0;
+    if(mPeerType != dSocket::PeerType::Current) // ping을 모르는 상대방은 조용할 수 있으므로 판정하지 않음
+        return mBeatInterval;
+    const uint64_t Idle = (mLastRecvMsec < nowmsec)? nowmsec - mLastRecvMsec : 0;
+    if(mBeatTimeout <= Idle)
+    {
+        disconnect();
+        return 0;
     }
-    void _move_(_self_&& rhs)
+    if(mBeatInterval <= Idle && mLastBeatMsec + mBeatInterval <= nowmsec)
     {
-        SocketAgentP::_move_(DD_rvalue(rhs));
-        mPeers = DD_rvalue(rhs.mPeers);
-        mPeerMutex = DD_rvalue(rhs.mPeerMutex);
-        mLastAcceptID = DD_rvalue(rhs.mLastAcceptID);
-        mInterrupted = DD_rvalue(rhs.mInterrupted);
-        mAcceptor = DD_rvalue(rhs.mAcceptor);
+        mLastBeatMsec = nowmsec;
+        if(!ping())
+            return 0;
     }
-    std::map<uint32_t, SocketAgentP*>* mPeers;
-    dMutex mPeerMutex;
-    uint32_t mLastAcceptID;
-    bool mInterrupted;
-    std::thread* mAcceptor;
+    return (uint32_t) std::max(std::min(uint64_t(mBeatInterval), mBeatTimeout - Idle), uint64_t(1));
+}
 
-public:
-    DD_passage_(ServerAgentP, SocketData socket, dSocket::AssignCB cb)_with_super(socket, cb)
-    {
-        mPeers = new std::map<uint32_t, SocketAgentP*>();
-        mLastAcceptID = 0;
-        mInterrupted = false;
-        mAcceptor = new std::thread([](ServerAgentP* self)->void
+bool SocketAgentP::shareLocalRing()
+{
+    #if DD_OS_LINUX
+        if(mSocket == SOCKET_ERROR || mRing)
+            return false;
+
+        // 루프백이거나 내 주소와 상대 주소가 같으면 같은 머신
+        struct sockaddr_in LocalAddr, PeerAddr;
+        socklen_t LocalSize = sizeof(LocalAddr), PeerSize = sizeof(PeerAddr);
+        if(::getsockname(mSocket, (struct sockaddr*) &LocalAddr, &LocalSize) != 0
+            || ::getpeername(mSocket, (struct sockaddr*) &PeerAddr, &PeerSize) != 0)
+            return false;
+        const bool IsLoopback = ((ntohl(PeerAddr.sin_addr.s_addr) >> 24) == 127);
+        if(!IsLoopback && LocalAddr.sin_addr.s_addr != PeerAddr.sin_addr.s_addr)
+            return false;
+
+        if(mPeerType != dSocket::PeerType::Current) // 인사가 오면 제안
         {
-            while(!self->mInterrupted)
-            {
-                int Result = 0;
-                SOCKET_SET_TIMEOUT(self->mSocket, 100, Result);
-                if(0 < Result)
-                {
-                    struct sockaddr_in Addr;
-                    memset(&Addr, 0, sizeof(Addr));
-                    int AddrSize = sizeof(Addr);
-                    SocketData NewSocket = SOCKET_ACCEPT(self->mSocket, (struct sockaddr*) &Addr, &AddrSize);
-                    if(NewSocket == SOCKET_ERROR) return;
-                    SOCKET_SET_KEEPALIVE(NewSocket);
-
-                    self->mPeerMutex.lock();
-                    {
-                        DD_assert(self->mPeers, "mPeers cannot be nullptr");
-                        uint32_t NewAcceptID = ++self->mLastAcceptID;
-                        (*self->mPeers)[NewAcceptID] = new SocketAgentP(NewSocket, nullptr);
-                    }
-                    self->mPeerMutex.unlock();
+            mRingWanted = true;
+            return true;
+        }
+        if(offerRing())
+            return (mRing != nullptr);
+        disconnect();
+    #endif
+    return false;
+}
 
-                    if(self->mAssignCB)
-                        self->mAssignCB(dSocket::AssignType::Entrance, self->mLastAcceptID);
-                }
-                else if(Result == 0) // TimeOut
-                    continue;
-                else return; // Error
-            }
-        }, this);
-    }
-};
+void SocketAgentP::kick(uint32_t)
+{
+    disconnect();
+}
 
-uint32_t ServerAgentP::count() const
+dSocket::PeerType SocketAgentP::peerType(uint32_t) const
 {
-    return uint32_t(mPeers->size());
+    return mPeerType;
 }
 
-bool ServerAgentP::sendTo(uint32_t id, const dBinary& binary, bool sizefield)
+bool SocketAgentP::connecting()
 {
-    bool Result = false;
-    mPeerMutex.lock();
+    if(!mConnecting)
+        return false;
+    struct pollfd Poll;
+    Poll.fd = mSocket;
+    Poll.events = POLLOUT;
+    Poll.revents = 0;
+    const int Ready = SOCKET_POLL(&Poll, 1, 0);
+    if(Ready == 0)
+        return true;
+
+    // 완료되면 이후는 다른 클라이언트처럼 블로킹으로
+    int ErrorCode = 0;
+    if(0 < Ready)
+        SOCKET_GET_ERROR(mSocket, ErrorCode);
+    mConnecting = false;
+    if(Ready < 0 || ErrorCode != 0)
+        disconnect();
+    else
     {
-        DD_assert(mPeers, "mPeers cannot be nullptr");
-        auto CurSocket = mPeers->find(id);
-        if(CurSocket != mPeers->end())
-        {
-            Result = CurSocket->second->sendTo(0, binary, sizefield);
-            if(!Result) mPeers->erase(CurSocket);
-        }
+        SOCKET_SET_BLOCK(mSocket);
+        greet();
+    }
+    return false;
+}
+
+dBinary SocketAgentP::takeQueued()
+{
+    // 끊겨도 큐잉분은 사이즈필드가 붙은 온전한 프레임들이므로 다른 연결로 재발송 가능
+    dBinary Result;
+    if(0 < mSendQueueLength)
+    {
+        Result = dBinary::fromInternal(mSendQueue, mSendQueueLength);
+        mSendQueue = nullptr;
+        mSendQueueLength = 0;
+        mSendQueueSize = 0;
     }
-    mPeerMutex.unlock();
     return Result;
 }
 
-bool ServerAgentP::sendAll(const dBinary& binary, bool sizefield)
+bool SocketAgentP::greet()
 {
-    bool Result = false;
-    mPeerMutex.lock();
+    // 빈 프레임은 이전 버전도 무시하므로 컨트롤프레임을 안다는 표시로 사용
+    const uint32_t Empty = 0;
+    if(sendFully((dumps) &Empty, 4))
+        return true;
+    disconnect();
+    return false;
+}
+
+bool SocketAgentP::offerRing()
+{
+    mRingWanted = false;
+    #if DD_OS_LINUX
+        if(!(mRing = SharedRingP::create()))
+            return true; // 링없이 TCP로 계속
+        return sendControl(RingOffer, (dumps) mRing->name(), uint32_t(strlen(mRing->name()) + 1));
+    #else
+        return true;
+    #endif
+}
+
+bool SocketAgentP::sendFully(dumps buffer, uint32_t length)
+{
+    while(0 < length)
     {
-        DD_assert(mPeers, "mPeers cannot be nullptr");
-        int SuccessCount = 0, FailureCount = 0;
-        for(auto iSocket = mPeers->begin(); iSocket != mPeers->end();)
+        const auto Sent = SOCKET_SEND(mSocket, buffer, length);
+        if(Sent <= 0) return false;
+        buffer += Sent;
+        length -= (uint32_t) Sent;
+    }
+    return true;
+}
+
+bool SocketAgentP::sendFrame(dumps header, uint32_t headerlength, dumps buffer, uint32_t length, uint32_t flag)
+{
+    // 사이즈필드, 헤더, 바이너리를 한번의 시스템콜로 발송(Nagle + Delayed-ACK 지연방지)
+    const uint32_t SizeField = (headerlength + length) | flag;
+    #if DD_OS_LINUX
+        struct iovec Parts[3];
+        Parts[0].iov_base = (void*) &SizeField;
+        Parts[0].iov_len = 4;
+        Parts[1].iov_base = (void*) header;
+        Parts[1].iov_len = headerlength;
+        Parts[2].iov_base = (void*) buffer;
+        Parts[2].iov_len = length;
+        struct msghdr Message;
+        memset(&Message, 0, sizeof(Message));
+        Message.msg_iov = Parts;
+        Message.msg_iovlen = 3;
+
+        ssize_t Sent = ::sendmsg(mSocket, &Message, MSG_NOSIGNAL);
+        if(Sent < 0) return false;
+        for(int i = 0; i < 3; ++i) // 부분발송된 나머지
         {
-            const bool CurResult = iSocket->second->sendTo(0, binary, sizefield);
-            if(!CurResult)
-            {
-                iSocket = mPeers->erase(iSocket);
-                FailureCount++;
-            }
-            else
+            const uint32_t PartLength = (uint32_t) Parts[i].iov_len;
+            if(Sent < (ssize_t) PartLength)
             {
-                iSocket++;
-                SuccessCount++;
+                if(!sendFully(((dumps) Parts[i].iov_base) + Sent, PartLength - (uint32_t) Sent))
+                    return false;
+                Sent = 0;
             }
+            else Sent -= PartLength;
         }
-        Result = (0 < SuccessCount && FailureCount == 0);
-    }
-    mPeerMutex.unlock();
-    return Result;
+        return true;
+    #else
+        if(headerlength + length <= 4096 - 4)
+        {
+            dump Frame[4096];
+            memcpy(&Frame[0], &SizeField, 4);
+            memcpy(&Frame[4], header, headerlength);
+            memcpy(&Frame[4 + headerlength], buffer, length);
+            return sendFully(Frame, 4 + headerlength + length);
+        }
+        return sendFully((dumps) &SizeField, 4)
+            && (headerlength == 0 || sendFully(header, headerlength)) && sendFully(buffer, length);
+    #endif
 }
 
-dBinary ServerAgentP::recvFrom(uint32_t id)
+bool SocketAgentP::sendControl(ControlCode code, dumps data, uint32_t length)
 {
-    dBinary Result;
-    mPeerMutex.lock();
+    // 컨트롤프레임은 사이즈필드의 최상위비트로 구분(링전환 이후에는 링으로)
+    dump Payload[256];
+    DD_assert(length < sizeof(Payload), "control payload is too long.");
+    if(mPeerType != dSocket::PeerType::Current) // 이전 버전은 사이즈필드를 2GB로 읽으므로 보내지 않음
+        return true;
+    Payload[0] = code;
+    if(0 < length)
+        memcpy(&Payload[1], data, length);
+    if(mRingSend)
     {
-        DD_assert(mPeers, "mPeers cannot be nullptr");
-        auto CurSocket = mPeers->find(id);
-        if(CurSocket != mPeers->end())
-            Result = CurSocket->second->recvFrom(0);
+        const uint32_t SizeField = (1 + length) | 0x80000000;
+        return writeRing((dumps) &SizeField, 4) && writeRing(Payload, 1 + length);
     }
-    mPeerMutex.unlock();
-    return Result;
+    return sendFrame(nullptr, 0, Payload, 1 + length, 0x80000000);
 }
 
-void ServerAgentP::recvAll(dSocket::RecvCB cb)
+void SocketAgentP::onControl(dumps payload, uint32_t length)
 {
-    std::stack< std::pair<uint32_t, dBinary> > CallStack;
+    if(length == 0) return;
+    switch(payload[0])
+    {
+    case RingOffer: // 서버측: 링을 열고 수락
+        if(!mRing && 1 < length && payload[length - 1] == '\0')
+            mRing = SharedRingP::open((utf8s) &payload[1]);
+        if(mRing)
+        {
+            flush(); // 큐잉분은 TCP로 먼저
+            if(sendControl(RingAccept))
+                mRingSend = true;
+            else disconnect();
+        }
+        else if(!sendControl(RingReject))
+            disconnect();
+        break;
+    case RingAccept: // 클라이언트측: TCP의 마지막을 알리고 링으로 전환
+        if(mRing)
+        {
+            mRing->unlink();
+            flush();
+            if(sendControl(RingSwitch))
+                mRingSend = mRingRecv = true;
+            else disconnect();
+        }
+        break;
+    case RingReject:
+        delete mRing;
+        mRing = nullptr;
+        break;
+    case RingSwitch: // 서버측: 이후의 수신은 링으로
+        if(mRing)
+            mRingRecv = true;
+        break;
+    case Ping: // 받은 그대로 회신
+        if(length == 1 + 8 && !sendControl(Pong, &payload[1], 8))
+            disconnect();
+        break;
+    case Pong:
+        if(length == 1 + 8)
+        {
+            int64_t SentNs = 0;
+            memcpy(&SentNs, &payload[1], 8);
+            const int64_t NowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            mLatency = uint32_t(std::max(int64_t(0), NowNs - SentNs) / 1000);
+        }
+        break;
+    }
+}
 
-    DD_assert(cb, "cb cannot be nullptr");
-    mPeerMutex.lock();
+bool SocketAgentP::writeRing(dumps buffer, uint32_t length)
+{
+    // 링이 가득차면 상대방이 비울때까지 잠들고, 너무 오래 걸리면 실패(호출자는 잠금중이므로)
+    if(mRing->isClosed()) // 읽을 상대방이 없으면 큐잉분을 남기도록 실패
+        return false;
+    uint64_t StallMsec = 0;
+    while(0 < length)
     {
-        DD_assert(mPeers, "mPeers cannot be nullptr");
-        for(auto iSocket : *mPeers)
+        const uint32_t Written = mRing->write(buffer, length);
+        if(Written == 0)
         {
-            dBinary NewBinary = iSocket.second->recvFrom(0);
-            if(0 < NewBinary.length())
-                CallStack.push(std::make_pair(iSocket.first, NewBinary));
+            if(mRing->isClosed())
+                return false;
+            const uint64_t NowMsec = nowMsec();
+            if(StallMsec == 0)
+                StallMsec = NowMsec + RingStallMsec;
+            else if(StallMsec <= NowMsec)
+                return false;
+            mRing->waitWritable(uint32_t(StallMsec - NowMsec));
+            continue;
         }
+        StallMsec = 0;
+        buffer += Written;
+        length -= Written;
     }
-    mPeerMutex.unlock();
+    return true;
+}
 
-    while(!CallStack.empty())
+bool SocketAgentP::readableLength(uint32_t& length)
+{
+    if(mRingRecv)
     {
-        cb(CallStack.top().first, CallStack.top().second);
-        CallStack.pop();
+        if(0 < (length = mRing->readable()))
+            return true;
+        if(mRing->isClosed())
+            return false;
+        #if DD_OS_LINUX
+            // 링이 비었으면 TCP로 상대방의 종료여부 확인
+            dump Peek = 0;
+            if(::recv(mSocket, &Peek, 1, MSG_PEEK | MSG_DONTWAIT) == 0)
+                return false;
+        #endif
+        return true;
     }
+    if(SOCKET_RECVLEN(mSocket, length) < 0)
+        return false;
+    #if DD_OS_LINUX
+        // 받을 것이 없으면 상대방의 종료여부 확인
+        dump Peek = 0;
+        if(length == 0 && ::recv(mSocket, &Peek, 1, MSG_PEEK | MSG_DONTWAIT) == 0)
+            return false;
+    #endif
+    return true;
 }
 
-void ServerAgentP::kick(uint32_t id)
+bool SocketAgentP::readSome(dump* buffer, uint32_t length)
 {
-    mPeerMutex.lock();
+    if(mBeatInterval != 0) // 무엇이든 받았으면 살아있음
+        mLastRecvMsec = nowMsec();
+    if(mRingRecv)
+        return (mRing->read(buffer, length) == length);
+    return (0 <= SOCKET_RECV(mSocket, buffer, length));
+}
+
+void SocketAgentP::enqueue(dumps buffer, uint32_t length)
+{
+    if(mSendQueueSize - mSendQueueLength < length)
     {
-        DD_assert(mPeers, "mPeers cannot be nullptr");
-        auto CurSocket = mPeers->find(id);
-        if(CurSocket != mPeers->end())
-            mPeers->erase(CurSocket);
+        uint32_t NewSize = (mSendQueueSize)? mSendQueueSize : 256;
+        while(NewSize - mSendQueueLength < length)
+            NewSize <<= 1; // 2의 승수
+        dump* NewQueue = new dump[NewSize];
+        if(mSendQueue)
+        {
+            memcpy(NewQueue, mSendQueue, mSendQueueLength);
+            delete[] mSendQueue;
+        }
+        mSendQueue = NewQueue;
+        mSendQueueSize = NewSize;
     }
-    mPeerMutex.unlock();
+    memcpy(&mSendQueue[mSendQueueLength], buffer, length);
+    mSendQueueLength += length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// ■ dSocket
-bool dSocket::openClient(dLiteral host, uint16_t port, AssignCB cb)
+// ■ PeerTableP
+// 세대번호를 붙인 슬롯맵(ID = 세대 << 16 | 인덱스), 조회는 전역락 없이 해당 슬롯만 잠금
+// 샤드별로 인덱스구간[base, base + capacity)을 나눠가짐
+class PeerTableP
 {
-    SocketAgentP::checkNetwork(true);
+public:
+    PeerTableP(uint32_t base = 0, uint32_t capacity = 0x10000);
+    ~PeerTableP();
+
+public:
+    uint32_t add(SocketAgentP* agent);
+    void remove(uint32_t id);
+    uint32_t count() const;
+
+    // 살아있는 ID면 슬롯을 잠그고 cb(agent)를 호출, cb가 false를 반환하면 제거
+    template<typename TYPE>
+    bool with(uint32_t id, TYPE cb) const
     {
-        if(const struct hostent* Host = gethostbyname(host.buildNative()))
+        const uint32_t Index = (id & IndexMask) - mBase;
+        Slot* CurSlot = find(Index);
+        if(!CurSlot) return false;
+        bool Called = false;
+        SocketAgentP* OldAgent = nullptr;
+        CurSlot->mMutex.lock();
         {
-            struct sockaddr_in Addr;
-            memset(&Addr, 0, sizeof(Addr));
-            Addr.sin_family = AF_INET;
-            #if DD_OS_WINDOWS
-                Addr.sin_addr.S_un.S_un_b.s_b1 = (Host->h_addr_list[0][0] & 0xFF);
-                Addr.sin_addr.S_un.S_un_b.s_b2 = (Host->h_addr_list[0][1] & 0xFF);
+            if(CurSlot->mAgent && CurSlot->mGeneration == (id >> IndexBits))
+            {
+                Called = true;
+                if(!cb(CurSlot->mAgent))
+                    OldAgent = release(CurSlot);
+            }
+        }
+        CurSlot->mMutex.unlock();
+        if(OldAgent)
+            retire(OldAgent, Index);
+        return Called;
+    }
+
+    // 모든 상대방마다 슬롯을 잠그고 cb(id, agent)를 호출, cb가 false를 반환하면 제거
+    template<typename TYPE>
+    void each(TYPE cb) const
+    {
+        const uint32_t SlotCount = mSlotCount.load(std::memory_order_acquire);
+        for(uint32_t i = 0; i < SlotCount; ++i)
+        {
+            Slot* CurSlot = at(i);
+            SocketAgentP* OldAgent = nullptr;
+            CurSlot->mMutex.lock();
+            {
+                if(CurSlot->mAgent)
+                    if(!cb((CurSlot->mGeneration << IndexBits) | (mBase + i), CurSlot->mAgent))
+                        OldAgent = release(CurSlot);
+            }
+            CurSlot->mMutex.unlock();
+            if(OldAgent)
+                retire(OldAgent, i);
+        }
+    }
+
+private:
+    enum {IndexBits = 16, IndexMask = (1 << IndexBits) - 1, ChunkBits = 8, ChunkSize = 1 << ChunkBits,
+        MaxChunks = (1 << IndexBits) >> ChunkBits};
+    struct Slot
+    {
+        std::mutex mMutex;
+        uint32_t mGeneration;
+        SocketAgentP* mAgent;
+    };
+    Slot* find(uint32_t index) const;
+    Slot* at(uint32_t index) const;
+    SocketAgentP* release(Slot* slot) const;
+    void retire(SocketAgentP* agent, uint32_t index) const;
+
+private:
+    const uint32_t mBase;
+    const uint32_t mCapacity;
+    std::atomic<Slot*> mChunks[MaxChunks]; // 청크는 해제전까지 옮겨지지 않음
+    std::atomic<uint32_t> mSlotCount;
+    mutable std::atomic<uint32_t> mPeerCount;
+    mutable std::mutex mFreeMutex;
+    mutable std::vector<uint32_t> mFreeIndices;
+};
+
+PeerTableP::PeerTableP(uint32_t base, uint32_t capacity) : mBase(base), mCapacity(capacity)
+{
+    for(int i = 0; i < MaxChunks; ++i)
+        mChunks[i] = nullptr;
+    mSlotCount = 0;
+    mPeerCount = 0;
+}
+
+PeerTableP::~PeerTableP()
+{
+    each([](uint32_t, SocketAgentP*)->bool {return false;});
+    for(int i = 0; i < MaxChunks; ++i)
+        delete[] mChunks[i].load();
+}
+
+uint32_t PeerTableP::add(SocketAgentP* agent)
+{
+    uint32_t NewIndex = 0;
+    Slot* NewSlot = nullptr;
+    std::lock_guard<std::mutex> Guard(mFreeMutex);
+    if(!mFreeIndices.empty())
+    {
+        NewIndex = mFreeIndices.back();
+        mFreeIndices.pop_back();
+        NewSlot = at(NewIndex);
+    }
+    else
+    {
+        NewIndex = mSlotCount.load(std::memory_order_relaxed);
+        if(NewIndex == mCapacity) return 0; // 가득참
+        if(!mChunks[NewIndex >> ChunkBits].load(std::memory_order_relaxed))
+        {
+            Slot* NewChunk = new Slot[ChunkSize];
+            for(int i = 0; i < ChunkSize; ++i)
+            {
+                NewChunk[i].mGeneration = 1;
+                NewChunk[i].mAgent = nullptr;
+            }
+            mChunks[NewIndex >> ChunkBits].store(NewChunk, std::memory_order_release);
+        }
+        NewSlot = at(NewIndex);
+    }
+
+    uint32_t NewID = 0;
+    NewSlot->mMutex.lock();
+    {
+        NewSlot->mAgent = agent;
+        NewID = (NewSlot->mGeneration << IndexBits) | (mBase + NewIndex);
+    }
+    NewSlot->mMutex.unlock();
+    if(NewIndex == mSlotCount.load(std::memory_order_relaxed))
+        mSlotCount.store(NewIndex + 1, std::memory_order_release);
+    mPeerCount++;
+    return NewID;
+}
+
+void PeerTableP::remove(uint32_t id)
+{
+    with(id, [](SocketAgentP*)->bool {return false;});
+}
+
+uint32_t PeerTableP::count() const
+{
+    return mPeerCount;
+}
+
+PeerTableP::Slot* PeerTableP::find(uint32_t index) const
+{
+    if(mSlotCount.load(std::memory_order_acquire) <= index)
+        return nullptr;
+    return at(index);
+}
+
+PeerTableP::Slot* PeerTableP::at(uint32_t index) const
+{
+    return &mChunks[index >> ChunkBits].load(std::memory_order_acquire)[index & (ChunkSize - 1)];
+}
+
+SocketAgentP* PeerTableP::release(Slot* slot) const
+{
+    // 세대를 올려서 이전 ID를 무효화(0은 건너뜀)
+    SocketAgentP* OldAgent = slot->mAgent;
+    slot->mAgent = nullptr;
+    slot->mGeneration = (slot->mGeneration + 1) & IndexMask;
+    if(slot->mGeneration == 0)
+        slot->mGeneration = 1;
+    return OldAgent;
+}
+
+void PeerTableP::retire(SocketAgentP* agent, uint32_t index) const
+{
+    agent->detach();
+    mPeerCount--;
+    std::lock_guard<std::mutex> Guard(mFreeMutex);
+    mFreeIndices.push_back(index);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ ServerAgentP
+// 샤드가 0개면 호출자스레드가 상대방을 직접 읽고, N개면 샤드별 I/O스레드가 읽어서 수신함에 보관
+class ServerAgentP : public SocketAgentP
+{
+public:
+    static SocketData listenShard(uint16_t port);
+
+public:
+    uint32_t count() const override;
+    bool sendTo(uint32_t id, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield) override;
+    bool sendAll(dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield) override;
+    uint32_t sendSome(const uint32_t* ids, uint32_t count, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield) override;
+    dBinary recvFrom(uint32_t id) override;
+    void recvAll(dSocket::RecvCB cb) override;
+    void setDelivery(dSocket::DeliveryType type) override;
+    bool flush() override;
+    uint32_t queued() const override;
+    bool ping() override;
+    uint32_t latency() const override;
+    bool shareLocalRing() override;
+    void kick(uint32_t id) override;
+    void setHeartbeat(uint32_t interval, uint32_t timeout) override;
+    dSocket::PeerType peerType(uint32_t id) const override;
+
+private:
+    struct Shard
+    {
+        SocketData mListener; // SOCKET_ERROR면 0번 샤드가 대신 수락해서 배분
+        PeerTableP* mPeers;
+        std::thread* mWorker;
+        std::mutex mInboxMutex;
+        std::deque< std::pair<uint32_t, dBinary> > mInbox;
+        std::vector<uint32_t> mLeaved; // 끊겨서 제거된 상대방(수신함과 함께 보호)
+        dTimerWheel mBeats; // 상대방별 하트비트(수신하는 스레드만 사용)
+    };
+    Shard* shardOf(uint32_t id) const;
+    bool acceptPeer(SocketData listener, uint32_t shard);
+    bool checkPeer(uint32_t shard, uint32_t id, SocketAgentP* peer, std::vector<uint32_t>& leaved);
+    void runAcceptor();
+    void runShard(uint32_t shard);
+
+    // 모든 샤드의 상대방마다 cb(id, agent)를 호출, cb가 false를 반환하면 제거
+    template<typename TYPE>
+    void eachPeer(TYPE cb) const
+    {
+        for(uint32_t i = 0; i < mShardCount; ++i)
+            mShards[i].mPeers->each(cb);
+    }
+
+DD_escaper(ServerAgentP, SocketAgentP):
+    void _init_(InitType type)
+    {
+        SocketAgentP::_init_(type);
+        mShards = nullptr;
+        mShardCount = 0;
+        mShardCapacity = 0;
+        mThreaded = false;
+        mDistributing = false;
+        mNextShard = 0;
+        mInterrupted = false;
+    }
+    void _quit_()
+    {
+        // 0번 샤드가 다른 샤드에 배분할 수 있으므로 모두 멈춘 후 해제
+        mInterrupted = true;
+        for(uint32_t i = 0; i < mShardCount; ++i)
+        {
+            if(mShards[i].mWorker)
+            {
+                mShards[i].mWorker->join();
+                delete mShards[i].mWorker;
+            }
+        }
+        for(uint32_t i = 0; i < mShardCount; ++i)
+        {
+            delete mShards[i].mPeers;
+            if(0 < i && mShards[i].mListener != SOCKET_ERROR)
+                SOCKET_DELETE(mShards[i].mListener);
+        }
+        delete[] mShards;
+        SocketAgentP::_quit_();
+    }
+    void _move_(_self_&& rhs)
+    {
+        SocketAgentP::_move_(DD_rvalue(rhs));
+        mShards = DD_rvalue(rhs.mShards);
+        mShardCount = DD_rvalue(rhs.mShardCount);
+        mShardCapacity = DD_rvalue(rhs.mShardCapacity);
+        mThreaded = DD_rvalue(rhs.mThreaded);
+        mDistributing = DD_rvalue(rhs.mDistributing);
+        mNextShard = DD_rvalue(rhs.mNextShard);
+        mPeerMutex = DD_rvalue(rhs.mPeerMutex);
+        mInterrupted = DD_rvalue(rhs.mInterrupted);
+    }
+    Shard* mShards;
+    uint32_t mShardCount;
+    uint32_t mShardCapacity; // 샤드별 인덱스구간의 크기
+    bool mThreaded; // true-샤드별 I/O스레드가 수신, false-호출자스레드가 수신
+    bool mDistributing; // true-0번 샤드가 모두 수락해서 라운드로빈으로 배분
+    uint32_t mNextShard;
+    mutable dMutex mPeerMutex; // 전송방식의 변경과 입장만 동기화
+    bool mInterrupted;
+
+public:
+    DD_passage_(ServerAgentP, SocketData socket, dSocket::AssignCB cb, uint16_t port, uint32_t shards, bool reuseport)_with_super(socket, cb)
+    {
+        mShardCount = std::max(shards, uint32_t(1));
+        mShardCapacity = 0x10000 / mShardCount;
+        mThreaded = (0 < shards);
+        mDistributing = false;
+        mNextShard = 0;
+        mInterrupted = false;
+        mShards = new Shard[mShardCount];
+        for(uint32_t i = 0; i < mShardCount; ++i)
+        {
+            mShards[i].mListener = (i == 0)? socket : ((reuseport)? listenShard(port) : SOCKET_ERROR);
+            mShards[i].mPeers = new PeerTableP(i * mShardCapacity, mShardCapacity);
+            mShards[i].mWorker = nullptr;
+            if(mShards[i].mListener == SOCKET_ERROR)
+                mDistributing = true;
+        }
+
+        // SO_REUSEPORT를 못쓰면 추가 리스너를 닫고 0번 샤드가 수락을 전담
+        if(mDistributing)
+        for(uint32_t i = 1; i < mShardCount; ++i)
+        {
+            if(mShards[i].mListener != SOCKET_ERROR)
+                SOCKET_DELETE(mShards[i].mListener);
+            mShards[i].mListener = SOCKET_ERROR;
+        }
+
+        if(mThreaded)
+        {
+            for(uint32_t i = 0; i < mShardCount; ++i)
+                mShards[i].mWorker = new std::thread([](ServerAgentP* self, uint32_t shard)->void
+                    {self->runShard(shard);}, this, i);
+        }
+        else mShards[0].mWorker = new std::thread([](ServerAgentP* self)->void
+            {self->runAcceptor();}, this);
+    }
+};
+
+SocketData ServerAgentP::listenShard(uint16_t port)
+{
+    struct sockaddr_in Addr;
+    memset(&Addr, 0, sizeof(Addr));
+    Addr.sin_family = AF_INET;
+    Addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    Addr.sin_port = htons(port);
+
+    SocketData NewSocket = SOCKET_NEW;
+    if(NewSocket != SOCKET_ERROR)
+    {
+        bool ReusePort = false;
+        SOCKET_SET_KEEPALIVE(NewSocket);
+        SOCKET_SET_REUSEADDR(NewSocket);
+        SOCKET_SET_REUSEPORT(NewSocket, ReusePort);
+        if(ReusePort)
+        if(SOCKET_BIND(NewSocket, (struct sockaddr*) &Addr, sizeof(Addr)) != SOCKET_ERROR)
+        if(SOCKET_LISTEN(NewSocket, SOMAXCONN) != SOCKET_ERROR)
+            return NewSocket;
+        SOCKET_DELETE(NewSocket);
+    }
+    return SOCKET_ERROR;
+}
+
+uint32_t ServerAgentP::count() const
+{
+    uint32_t Result = 0;
+    for(uint32_t i = 0; i < mShardCount; ++i)
+        Result += mShards[i].mPeers->count();
+    return Result;
+}
+
+bool ServerAgentP::sendTo(uint32_t id, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield)
+{
+    bool Result = false;
+    if(Shard* CurShard = shardOf(id))
+        CurShard->mPeers->with(id, [&](SocketAgentP* peer)->bool
+            {
+                Result = peer->sendTo(0, header, headerlength, binary, sizefield);
+                return true; // 실패한 상대방은 끊긴채로 남았다가 수신측에서 Leaved로 정리
+            });
+    return Result;
+}
+
+bool ServerAgentP::sendAll(dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield)
+{
+    int SuccessCount = 0, FailureCount = 0;
+    eachPeer([&](uint32_t, SocketAgentP* peer)->bool
+        {
+            const bool CurResult = peer->sendTo(0, header, headerlength, binary, sizefield);
+            (CurResult)? SuccessCount++ : FailureCount++;
+            return true;
+        });
+    return (0 < SuccessCount && FailureCount == 0);
+}
+
+uint32_t ServerAgentP::sendSome(const uint32_t* ids, uint32_t count, dumps header, uint32_t headerlength, const dBinary& binary, bool sizefield)
+{
+    // 헤더와 바이너리는 한번만 만들어진 것을 상대방마다 그대로 발송
+    uint32_t Result = 0;
+    for(uint32_t i = 0; i < count; ++i)
+        if(Shard* CurShard = shardOf(ids[i]))
+            CurShard->mPeers->with(ids[i], [&](SocketAgentP* peer)->bool
+                {
+                    if(peer->sendTo(0, header, headerlength, binary, sizefield))
+                        Result++;
+                    return true;
+                });
+    return Result;
+}
+
+dBinary ServerAgentP::recvFrom(uint32_t id)
+{
+    dBinary Result;
+    if(Shard* CurShard = shardOf(id))
+    {
+        if(mThreaded)
+        {
+            std::lock_guard<std::mutex> Guard(CurShard->mInboxMutex);
+            for(auto it = CurShard->mInbox.begin(); it != CurShard->mInbox.end(); ++it)
+            {
+                if(it->first == id)
+                {
+                    Result = it->second;
+                    CurShard->mInbox.erase(it);
+                    break;
+                }
+            }
+        }
+        else CurShard->mPeers->with(id, [&Result](SocketAgentP* peer)->bool
+            {
+                Result = peer->recvFrom(0);
+                return true;
+            });
+    }
+    return Result;
+}
+
+void ServerAgentP::recvAll(dSocket::RecvCB cb)
+{
+    std::vector< std::pair<uint32_t, dBinary> > CallList;
+    std::vector<uint32_t> LeavedList;
+
+    DD_assert(cb, "cb cannot be nullptr");
+    if(mThreaded)
+    {
+        std::deque< std::pair<uint32_t, dBinary> > Inbox;
+        for(uint32_t i = 0; i < mShardCount; ++i)
+        {
+            mShards[i].mInboxMutex.lock();
+            Inbox.swap(mShards[i].mInbox);
+            LeavedList.insert(LeavedList.end(), mShards[i].mLeaved.begin(), mShards[i].mLeaved.end());
+            mShards[i].mLeaved.clear();
+            mShards[i].mInboxMutex.unlock();
+            CallList.insert(CallList.end(), Inbox.begin(), Inbox.end());
+            Inbox.clear();
+        }
+    }
+    else
+    {
+        mShards[0].mPeers->each([this, &CallList, &LeavedList](uint32_t id, SocketAgentP* peer)->bool
+            {
+                dBinary NewBinary = peer->recvFrom(0);
+                if(0 < NewBinary.length())
+                    CallList.push_back(std::make_pair(id, NewBinary));
+                return checkPeer(0, id, peer, LeavedList);
+            });
+        mShards[0].mBeats.advance();
+    }
+
+    // 끊긴 상대방은 남은 수신분의 뒤에 알림
+    for(auto& iCall : CallList)
+        cb(iCall.first, iCall.second);
+    if(mAssignCB)
+        for(auto iLeaved : LeavedList)
+            mAssignCB(dSocket::AssignType::Leaved, iLeaved);
+}
+
+void ServerAgentP::setDelivery(dSocket::DeliveryType type)
+{
+    mPeerMutex.lock();
+    {
+        mDelivery = type;
+        eachPeer([type](uint32_t, SocketAgentP* peer)->bool
+            {
+                peer->setDelivery(type);
+                return true;
+            });
+    }
+    mPeerMutex.unlock();
+}
+
+bool ServerAgentP::flush()
+{
+    bool Result = true;
+    if(mDelivery == dSocket::DeliveryType::Throughput)
+    eachPeer([&Result](uint32_t, SocketAgentP* peer)->bool
+        {
+            if(!peer->flush())
+                Result = false;
+            return true;
+        });
+    return Result;
+}
+
+uint32_t ServerAgentP::queued() const
+{
+    uint32_t Result = 0;
+    eachPeer([&Result](uint32_t, SocketAgentP* peer)->bool
+        {
+            Result += peer->queued();
+            return true;
+        });
+    return Result;
+}
+
+bool ServerAgentP::ping()
+{
+    bool Result = false;
+    eachPeer([&Result](uint32_t, SocketAgentP* peer)->bool
+        {
+            if(peer->ping())
+                Result = true;
+            return true;
+        });
+    return Result;
+}
+
+uint32_t ServerAgentP::latency() const
+{
+    uint32_t Result = 0;
+    eachPeer([&Result](uint32_t, SocketAgentP* peer)->bool
+        {
+            Result = std::max(Result, peer->latency());
+            return true;
+        });
+    return Result;
+}
+
+bool ServerAgentP::shareLocalRing()
+{
+    return false; // 링은 클라이언트가 제안하고 접속된 상대방이 수락
+}
+
+void ServerAgentP::kick(uint32_t id)
+{
+    if(Shard* CurShard = shardOf(id))
+        CurShard->mPeers->remove(id);
+}
+
+void ServerAgentP::setHeartbeat(uint32_t interval, uint32_t timeout)
+{
+    mPeerMutex.lock();
+    {
+        initBeat(interval, timeout);
+        eachPeer([this](uint32_t, SocketAgentP* peer)->bool
+            {
+                peer->initBeat(mBeatInterval, mBeatTimeout);
+                return true;
+            });
+    }
+    mPeerMutex.unlock();
+}
+
+dSocket::PeerType ServerAgentP::peerType(uint32_t id) const
+{
+    dSocket::PeerType Result = dSocket::PeerType::Unknown;
+    if(Shard* CurShard = shardOf(id))
+        CurShard->mPeers->with(id, [&Result](SocketAgentP* peer)->bool
+            {
+                Result = peer->peerType(0);
+                return true;
+            });
+    return Result;
+}
+
+ServerAgentP::Shard* ServerAgentP::shardOf(uint32_t id) const
+{
+    DD_assert(mShards, "mShards cannot be nullptr");
+    const uint32_t ShardIndex = (id & 0xFFFF) / mShardCapacity;
+    return (ShardIndex < mShardCount)? &mShards[ShardIndex] : nullptr;
+}
+
+bool ServerAgentP::acceptPeer(SocketData listener, uint32_t shard)
+{
+    struct sockaddr_in Addr;
+    memset(&Addr, 0, sizeof(Addr));
+    int AddrSize = sizeof(Addr);
+    SocketData NewSocket = SOCKET_ACCEPT(listener, (struct sockaddr*) &Addr, &AddrSize);
+    if(NewSocket == SOCKET_ERROR) return false;
+    SOCKET_SET_KEEPALIVE(NewSocket);
+
+    uint32_t NewAcceptID = 0;
+    mPeerMutex.lock();
+    {
+        const uint32_t TargetShard = (mDistributing)? mNextShard++ % mShardCount : shard;
+        auto NewPeer = new SocketAgentP(NewSocket, nullptr);
+        NewPeer->greet(); // 실패하면 끊긴채로 추가되었다가 Leaved로 정리
+        NewPeer->setDelivery(mDelivery);
+        if(mBeatInterval != 0)
+            NewPeer->initBeat(mBeatInterval, mBeatTimeout);
+        if((NewAcceptID = mShards[TargetShard].mPeers->add(NewPeer)) == 0)
+            NewPeer->detach(); // 슬롯이 가득참
+    }
+    mPeerMutex.unlock();
+
+    if(NewAcceptID != 0 && mAssignCB)
+        mAssignCB(dSocket::AssignType::Entrance, NewAcceptID);
+    return true;
+}
+
+bool ServerAgentP::checkPeer(uint32_t shard, uint32_t id, SocketAgentP* peer, std::vector<uint32_t>& leaved)
+{
+    // 끊긴 상대방은 제거후 Leaved로
+    if(!peer->isConnected())
+    {
+        leaved.push_back(id);
+        return false;
+    }
+
+    // 상대방마다 하나의 타이머, 만료되면 슬롯을 잠그고 확인후 다음 확인까지의 시간으로 재등록
+    if(peer->needBeatTimer())
+    {
+        PeerTableP* Peers = mShards[shard].mPeers;
+        peer->setBeatTimer(mShards[shard].mBeats.start(peer->beatInterval(), [Peers, id]()->uint32_t
+            {
+                uint32_t NextMsec = 0;
+                Peers->with(id, [&NextMsec](SocketAgentP* peer)->bool
+                    {
+                        if((NextMsec = peer->beat(nowMsec())) == 0)
+                            peer->setBeatTimer(0);
+                        return true;
+                    });
+                return NextMsec;
+            }));
+    }
+    return true;
+}
+
+void ServerAgentP::runAcceptor()
+{
+    while(!mInterrupted)
+    {
+        int Result = 0;
+        SOCKET_SET_TIMEOUT(mSocket, 100, Result);
+        if(0 < Result)
+        {
+            if(!acceptPeer(mSocket, 0))
+                return;
+        }
+        else if(Result == 0) // TimeOut
+            continue;
+        else return; // Error
+    }
+}
+
+void ServerAgentP::runShard(uint32_t shard)
+{
+    Shard& CurShard = mShards[shard];
+    std::vector<struct pollfd> Polls;
+    std::vector<uint32_t> PollIDs; // 0은 리스너
+    std::vector< std::pair<uint32_t, dBinary> > Frames;
+    std::vector<uint32_t> Leaved;
+    while(!mInterrupted)
+    {
+        Polls.clear();
+        PollIDs.clear();
+        bool RingRecv = false;
+        if(CurShard.mListener != SOCKET_ERROR)
+        {
+            struct pollfd NewPoll;
+            NewPoll.fd = CurShard.mListener;
+            NewPoll.events = POLLIN;
+            NewPoll.revents = 0;
+            Polls.push_back(NewPoll);
+            PollIDs.push_back(0);
+        }
+        CurShard.mPeers->each([&](uint32_t id, SocketAgentP* peer)->bool
+            {
+                if(!checkPeer(shard, id, peer, Leaved))
+                    return false;
+                struct pollfd NewPoll;
+                NewPoll.fd = peer->handle();
+                NewPoll.events = POLLIN;
+                NewPoll.revents = 0;
+                Polls.push_back(NewPoll);
+                PollIDs.push_back(id);
+                RingRecv |= peer->isRingRecv();
+                return true;
+            });
+        if(!Leaved.empty())
+        {
+            CurShard.mInboxMutex.lock();
+            CurShard.mLeaved.insert(CurShard.mLeaved.end(), Leaved.begin(), Leaved.end());
+            CurShard.mInboxMutex.unlock();
+            Leaved.clear();
+        }
+
+        // 링으로 받는 상대방은 소켓이 조용하므로 짧게 대기하며 확인
+        // 다른 샤드가 배분한 상대방은 다음 주기에 합류
+        const int Wait = (RingRecv)? 1 : 10;
+        if(Polls.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(Wait));
+            continue;
+        }
+        if(SOCKET_POLL(&Polls[0], Polls.size(), Wait) < 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        for(size_t i = 0, iend = Polls.size(); i < iend; ++i)
+        {
+            if(PollIDs[i] == 0)
+            {
+                if(Polls[i].revents & POLLIN)
+                    acceptPeer(CurShard.mListener, shard);
+            }
+            else if(Polls[i].revents != 0 || RingRecv)
+            {
+                const uint32_t CurID = PollIDs[i];
+                CurShard.mPeers->with(CurID, [&Frames, CurID](SocketAgentP* peer)->bool
+                    {
+                        for(dBinary NewBinary; 0 < (NewBinary = peer->recvFrom(0)).length();)
+                            Frames.push_back(std::make_pair(CurID, NewBinary));
+                        return true;
+                    });
+            }
+        }
+
+        if(!Frames.empty())
+        {
+            CurShard.mInboxMutex.lock();
+            for(auto& iFrame : Frames)
+                CurShard.mInbox.push_back(iFrame);
+            CurShard.mInboxMutex.unlock();
+            Frames.clear();
+        }
+        CurShard.mBeats.advance();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ AsyncAgentP
+// 논블로킹소켓과 대기중인 작업들(준비확인과 완료통지는 모두 dAsyncSocket::poll에서)
+class AsyncAgentP : public dEscaper
+{
+public:
+    static uint32_t poll(uint32_t timeout);
+    static uint32_t pendings();
+
+public:
+    void attach() const;
+    void detach() const;
+    void connect(dLiteral host, uint16_t port, dAsyncSocket::DoneCB cb);
+    bool listen(uint16_t port);
+    void accept(dAsyncSocket::AcceptCB cb);
+    void send(const dBinary& binary, dAsyncSocket::DoneCB cb);
+    void recv(dAsyncSocket::RecvCB cb);
+    void close();
+
+public:
+    inline bool isConnected() const
+    {return (mSocket != SOCKET_ERROR && mState == State::Connected);}
+
+private:
+    enum class State {Idle, Connecting, Connected, Listening};
+    struct Sending
+    {
+        dBinary mBinary;
+        uint32_t mSizeField;
+        uint32_t mPos;
+        dAsyncSocket::DoneCB mCB;
+    };
+    typedef std::function<void()> CompletionCB;
+    static std::vector<AsyncAgentP*>& watchings();
+    static std::deque<CompletionCB>& completions();
+    void watch();
+    short events() const;
+    uint32_t countPendings() const;
+    void onEvents(short revents);
+    void onConnect();
+    void onAccept();
+    void onRead();
+    void onWrite();
+
+DD_escaper(AsyncAgentP, dEscaper):
+    void _init_(InitType)
+    {
+        mSocket = SOCKET_ERROR;
+        mState = State::Idle;
+        mWatched = false;
+        mConnectCB = nullptr;
+        mWaitForSizeField = 0;
+        mWaitForSizePos = 0;
+        mWaitForDumpPos = 0;
+        mWaitForDumps = nullptr;
+        mRefCount = 1;
+    }
+    void _quit_()
+    {
+        DD_assert(mRefCount == 0 || mRefCount == 1, "reference count does not match.");
+        delete[] mWaitForDumps;
+        if(mSocket != SOCKET_ERROR)
+        {
+            SOCKET_DELETE(mSocket);
+            SocketAgentP::checkNetwork(false);
+        }
+    }
+    void _move_(_self_&& rhs)
+    {
+        mSocket = DD_rvalue(rhs.mSocket);
+        mState = DD_rvalue(rhs.mState);
+        mWatched = DD_rvalue(rhs.mWatched);
+        mConnectCB = DD_rvalue(rhs.mConnectCB);
+        mAcceptCBs = DD_rvalue(rhs.mAcceptCBs);
+        mSendings = DD_rvalue(rhs.mSendings);
+        mRecvCBs = DD_rvalue(rhs.mRecvCBs);
+        mWaitForSizeField = DD_rvalue(rhs.mWaitForSizeField);
+        mWaitForSizePos = DD_rvalue(rhs.mWaitForSizePos);
+        mWaitForDumpPos = DD_rvalue(rhs.mWaitForDumpPos);
+        mWaitForDumps = DD_rvalue(rhs.mWaitForDumps);
+        mRefCount = DD_rvalue(rhs.mRefCount);
+    }
+    SocketData mSocket;
+    State mState;
+    bool mWatched;
+    dAsyncSocket::DoneCB mConnectCB;
+    std::deque<dAsyncSocket::AcceptCB> mAcceptCBs;
+    std::deque<Sending> mSendings;
+    std::deque<dAsyncSocket::RecvCB> mRecvCBs;
+    uint32_t mWaitForSizeField;
+    uint32_t mWaitForSizePos;
+    uint32_t mWaitForDumpPos;
+    dump* mWaitForDumps;
+    mutable int32_t mRefCount;
+
+public:
+    DD_passage(AsyncAgentP, SocketData socket)
+    {
+        _init_(InitType::Create);
+
+        SocketAgentP::checkNetwork(true);
+        mSocket = socket;
+        mState = State::Connected;
+    }
+};
+
+uint32_t AsyncAgentP::poll(uint32_t timeout)
+{
+    // 할일이 없는 소켓은 루프에서 제외
+    auto& Watchings = watchings();
+    for(size_t i = 0; i < Watchings.size();)
+    {
+        if(Watchings[i]->countPendings() == 0)
+        {
+            AsyncAgentP* OldAgent = Watchings[i];
+            Watchings[i] = Watchings.back();
+            Watchings.pop_back();
+            OldAgent->mWatched = false;
+            OldAgent->detach();
+        }
+        else i++;
+    }
+
+    // 준비된 소켓의 처리
+    std::vector<struct pollfd> Polls;
+    std::vector<AsyncAgentP*> Agents;
+    for(auto iAgent : Watchings)
+    {
+        if(const short Events = iAgent->events())
+        {
+            struct pollfd NewPoll;
+            NewPoll.fd = iAgent->mSocket;
+            NewPoll.events = Events;
+            NewPoll.revents = 0;
+            Polls.push_back(NewPoll);
+            Agents.push_back(iAgent);
+            iAgent->attach();
+        }
+    }
+    const int Wait = (completions().empty())? (int) timeout : 0;
+    if(!Polls.empty())
+    {
+        if(0 < SOCKET_POLL(&Polls[0], Polls.size(), Wait))
+        {
+            for(size_t i = 0, iend = Polls.size(); i < iend; ++i)
+                if(Polls[i].revents != 0)
+                    Agents[i]->onEvents(Polls[i].revents);
+        }
+    }
+    else if(0 < Wait)
+        std::this_thread::sleep_for(std::chrono::milliseconds(Wait));
+    for(auto iAgent : Agents)
+        iAgent->detach();
+
+    // 완료통지(통지중에 요청된 작업의 통지는 다음 poll에서)
+    std::deque<CompletionCB> Completions;
+    Completions.swap(completions());
+    for(auto& iCompletion : Completions)
+        iCompletion();
+    return uint32_t(Completions.size());
+}
+
+uint32_t AsyncAgentP::pendings()
+{
+    uint32_t Result = uint32_t(completions().size());
+    for(auto iAgent : watchings())
+        Result += iAgent->countPendings();
+    return Result;
+}
+
+void AsyncAgentP::attach() const
+{
+    mRefCount++;
+}
+
+void AsyncAgentP::detach() const
+{
+    if(--mRefCount == 0)
+        delete this;
+}
+
+void AsyncAgentP::connect(dLiteral host, uint16_t port, dAsyncSocket::DoneCB cb)
+{
+    DD_assert(mSocket == SOCKET_ERROR, "this agent is already in use.");
+    SocketAgentP::checkNetwork(true);
+    if(const struct hostent* Host = gethostbyname(host.buildNative()))
+    {
+        struct sockaddr_in Addr;
+        memset(&Addr, 0, sizeof(Addr));
+        Addr.sin_family = AF_INET;
+        #if DD_OS_WINDOWS
+            Addr.sin_addr.S_un.S_un_b.s_b1 = (Host->h_addr_list[0][0] & 0xFF);
+            Addr.sin_addr.S_un.S_un_b.s_b2 = (Host->h_addr_list[0][1] & 0xFF);
+            Addr.sin_addr.S_un.S_un_b.s_b3 = (Host->h_addr_list[0][2] & 0xFF);
+            Addr.sin_addr.S_un.S_un_b.s_b4 = (Host->h_addr_list[0][3] & 0xFF);
+        #elif DD_OS_LINUX
+            Addr.sin_addr.s_addr = *((long int*) Host->h_addr_list[0]);
+        #else
+            #error [daddy] this platform is not ready!
+        #endif
+        Addr.sin_port = htons(port);
+
+        SocketData NewSocket = SOCKET_NEW;
+        if(NewSocket != SOCKET_ERROR)
+        {
+            SOCKET_SET_KEEPALIVE(NewSocket);
+            SOCKET_SET_NONBLOCK(NewSocket);
+            mSocket = NewSocket;
+            if(SOCKET_CONNECT(NewSocket, (struct sockaddr*) &Addr, sizeof(Addr)) != SOCKET_ERROR)
+            {
+                mState = State::Connected;
+                if(cb) completions().push_back([cb]()->void {cb(true);});
+                return;
+            }
+            else if(SOCKET_WOULDBLOCK)
+            {
+                mState = State::Connecting;
+                mConnectCB = (cb)? cb : [](bool)->void {};
+                watch();
+                return;
+            }
+            SOCKET_DELETE(NewSocket);
+            mSocket = SOCKET_ERROR;
+        }
+    }
+    SocketAgentP::checkNetwork(false);
+    if(cb) completions().push_back([cb]()->void {cb(false);});
+}
+
+bool AsyncAgentP::listen(uint16_t port)
+{
+    DD_assert(mSocket == SOCKET_ERROR, "this agent is already in use.");
+    SocketAgentP::checkNetwork(true);
+    {
+        struct sockaddr_in Addr;
+        memset(&Addr, 0, sizeof(Addr));
+        Addr.sin_family = AF_INET;
+        Addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        Addr.sin_port = htons(port);
+
+        SocketData NewSocket = SOCKET_NEW;
+        if(NewSocket != SOCKET_ERROR)
+        {
+            SOCKET_SET_REUSEADDR(NewSocket);
+            SOCKET_SET_NONBLOCK(NewSocket);
+            if(SOCKET_BIND(NewSocket, (struct sockaddr*) &Addr, sizeof(Addr)) != SOCKET_ERROR)
+            if(SOCKET_LISTEN(NewSocket, SOMAXCONN) != SOCKET_ERROR)
+            {
+                mSocket = NewSocket;
+                mState = State::Listening;
+                return true;
+            }
+            SOCKET_DELETE(NewSocket);
+        }
+    }
+    SocketAgentP::checkNetwork(false);
+    return false;
+}
+
+void AsyncAgentP::accept(dAsyncSocket::AcceptCB cb)
+{
+    DD_assert(cb, "cb cannot be nullptr");
+    if(mSocket != SOCKET_ERROR && mState == State::Listening)
+    {
+        mAcceptCBs.push_back(cb);
+        watch();
+    }
+    else completions().push_back([cb]()->void {cb(dAsyncSocket());});
+}
+
+void AsyncAgentP::send(const dBinary& binary, dAsyncSocket::DoneCB cb)
+{
+    if(isConnected())
+    {
+        Sending NewSending;
+        NewSending.mBinary = binary;
+        NewSending.mSizeField = binary.length();
+        NewSending.mPos = 0;
+        NewSending.mCB = cb;
+        mSendings.push_back(DD_rvalue(NewSending));
+        watch();
+        if(mSendings.size() == 1) // 밀린게 없으면 곧바로 발송시도
+            onWrite();
+    }
+    else if(cb) completions().push_back([cb]()->void {cb(false);});
+}
+
+void AsyncAgentP::recv(dAsyncSocket::RecvCB cb)
+{
+    DD_assert(cb, "cb cannot be nullptr");
+    if(isConnected())
+    {
+        mRecvCBs.push_back(cb);
+        watch();
+    }
+    else completions().push_back([cb]()->void {cb(dBinary());});
+}
+
+void AsyncAgentP::close()
+{
+    // 대기중인 작업들은 모두 실패로 통지
+    auto& Completions = completions();
+    if(mConnectCB)
+    {
+        auto OldCB = DD_rvalue(mConnectCB);
+        mConnectCB = nullptr;
+        Completions.push_back([OldCB]()->void {OldCB(false);});
+    }
+    for(auto& iAcceptCB : mAcceptCBs)
+    {
+        auto OldCB = DD_rvalue(iAcceptCB);
+        Completions.push_back([OldCB]()->void {OldCB(dAsyncSocket());});
+    }
+    mAcceptCBs.clear();
+    for(auto& iSending : mSendings)
+    {
+        if(auto OldCB = DD_rvalue(iSending.mCB))
+            Completions.push_back([OldCB]()->void {OldCB(false);});
+    }
+    mSendings.clear();
+    for(auto& iRecvCB : mRecvCBs)
+    {
+        auto OldCB = DD_rvalue(iRecvCB);
+        Completions.push_back([OldCB]()->void {OldCB(dBinary());});
+    }
+    mRecvCBs.clear();
+
+    delete[] mWaitForDumps;
+    mWaitForDumps = nullptr;
+    mWaitForSizePos = 0;
+    mWaitForDumpPos = 0;
+    if(mSocket != SOCKET_ERROR)
+    {
+        SOCKET_DELETE(mSocket);
+        mSocket = SOCKET_ERROR;
+        SocketAgentP::checkNetwork(false);
+    }
+    mState = State::Idle;
+}
+
+std::vector<AsyncAgentP*>& AsyncAgentP::watchings()
+{
+    static std::vector<AsyncAgentP*> _;
+    return _;
+}
+
+std::deque<AsyncAgentP::CompletionCB>& AsyncAgentP::completions()
+{
+    static std::deque<CompletionCB> _;
+    return _;
+}
+
+void AsyncAgentP::watch()
+{
+    // 루프가 참조를 가지므로 작업이 끝날때까지 소멸되지 않음
+    if(!mWatched)
+    {
+        mWatched = true;
+        attach();
+        watchings().push_back(this);
+    }
+}
+
+short AsyncAgentP::events() const
+{
+    if(mSocket == SOCKET_ERROR)
+        return 0;
+    switch(mState)
+    {
+    case State::Connecting:
+        return POLLOUT;
+    case State::Listening:
+        return (mAcceptCBs.empty())? 0 : POLLIN;
+    case State::Connected:
+        return ((mRecvCBs.empty())? 0 : POLLIN) | ((mSendings.empty())? 0 : POLLOUT);
+    default:
+        return 0;
+    }
+}
+
+uint32_t AsyncAgentP::countPendings() const
+{
+    return ((mConnectCB)? 1 : 0) + uint32_t(mAcceptCBs.size() + mSendings.size() + mRecvCBs.size());
+}
+
+void AsyncAgentP::onEvents(short revents)
+{
+    switch(mState)
+    {
+    case State::Connecting:
+        onConnect();
+        break;
+    case State::Listening:
+        onAccept();
+        break;
+    case State::Connected:
+        if(!mRecvCBs.empty() && (revents & (POLLIN | POLLHUP | POLLERR)))
+            onRead();
+        if(!mSendings.empty() && (revents & (POLLOUT | POLLHUP | POLLERR)))
+            onWrite();
+        if(revents & POLLNVAL)
+            close();
+        break;
+    default:
+        break;
+    }
+}
+
+void AsyncAgentP::onConnect()
+{
+    int ErrorCode = 0;
+    #if DD_OS_WINDOWS
+        int ErrorSize = sizeof(ErrorCode);
+        getsockopt(mSocket, SOL_SOCKET, SO_ERROR, (char*) &ErrorCode, &ErrorSize);
+    #else
+        socklen_t ErrorSize = sizeof(ErrorCode);
+        ::getsockopt(mSocket, SOL_SOCKET, SO_ERROR, &ErrorCode, &ErrorSize);
+    #endif
+    if(ErrorCode == 0)
+    {
+        auto OldCB = DD_rvalue(mConnectCB);
+        mConnectCB = nullptr;
+        mState = State::Connected;
+        completions().push_back([OldCB]()->void {OldCB(true);});
+    }
+    else close();
+}
+
+void AsyncAgentP::onAccept()
+{
+    while(!mAcceptCBs.empty())
+    {
+        struct sockaddr_in Addr;
+        memset(&Addr, 0, sizeof(Addr));
+        int AddrSize = sizeof(Addr);
+        SocketData NewSocket = SOCKET_ACCEPT(mSocket, (struct sockaddr*) &Addr, &AddrSize);
+        if(NewSocket == SOCKET_ERROR)
+        {
+            if(!SOCKET_WOULDBLOCK) close();
+            return;
+        }
+        SOCKET_SET_KEEPALIVE(NewSocket);
+        SOCKET_SET_NONBLOCK(NewSocket);
+
+        auto NewAgent = new AsyncAgentP(NewSocket);
+        auto OldCB = DD_rvalue(mAcceptCBs.front());
+        mAcceptCBs.pop_front();
+        completions().push_back([OldCB, NewAgent]()->void {OldCB(dAsyncSocket((ptr_u) NewAgent));});
+    }
+}
+
+void AsyncAgentP::onRead()
+{
+    while(!mRecvCBs.empty())
+    {
+        // 사이즈필드
+        if(mWaitForSizePos < 4)
+        {
+            const int Received = SOCKET_RECV(mSocket, ((dump*) &mWaitForSizeField) + mWaitForSizePos, 4 - mWaitForSizePos);
+            if(Received <= 0)
+            {
+                if(Received == 0 || !SOCKET_WOULDBLOCK) close();
+                return;
+            }
+            if((mWaitForSizePos += Received) < 4)
+                continue;
+            mWaitForDumpPos = 0;
+            mWaitForDumps = new dump[(mWaitForSizeField & 0x7FFFFFFF) + 1];
+        }
+
+        // 바이너리
+        const uint32_t Length = mWaitForSizeField & 0x7FFFFFFF;
+        if(mWaitForDumpPos < Length)
+        {
+            const int Received = SOCKET_RECV(mSocket, &mWaitForDumps[mWaitForDumpPos], Length - mWaitForDumpPos);
+            if(Received <= 0)
+            {
+                if(Received == 0 || !SOCKET_WOULDBLOCK) close();
+                return;
+            }
+            if((mWaitForDumpPos += Received) < Length)
+                continue;
+        }
+        dump* OldDumps = mWaitForDumps;
+        mWaitForDumps = nullptr;
+        mWaitForSizePos = 0;
+
+        // 컨트롤프레임(핑, 링전환)과 빈 프레임은 건너뜀
+        if((mWaitForSizeField & 0x80000000) || Length == 0)
+        {
+            delete[] OldDumps;
+            continue;
+        }
+        auto OldCB = DD_rvalue(mRecvCBs.front());
+        mRecvCBs.pop_front();
+        dBinary NewBinary = dBinary::fromInternal(OldDumps, Length);
+        completions().push_back([OldCB, NewBinary]()->void {OldCB(NewBinary);});
+    }
+}
+
+void AsyncAgentP::onWrite()
+{
+    while(!mSendings.empty())
+    {
+        Sending& CurSending = mSendings.front();
+        const uint32_t Length = CurSending.mBinary.length();
+        int Sent = 0;
+        if(CurSending.mPos == 0 && Length <= 4096 - 4) // 작은 프레임은 한번의 시스템콜로
+        {
+            dump Frame[4096];
+            memcpy(&Frame[0], &CurSending.mSizeField, 4);
+            memcpy(&Frame[4], CurSending.mBinary.buffer(), Length);
+            Sent = SOCKET_SEND(mSocket, Frame, 4 + Length);
+        }
+        else if(CurSending.mPos < 4)
+            Sent = SOCKET_SEND(mSocket, ((dumps) &CurSending.mSizeField) + CurSending.mPos, 4 - CurSending.mPos);
+        else Sent = SOCKET_SEND(mSocket, CurSending.mBinary.buffer() + CurSending.mPos - 4, Length + 4 - CurSending.mPos);
+        if(Sent <= 0)
+        {
+            if(Sent < 0 && !SOCKET_WOULDBLOCK) close();
+            return;
+        }
+        if((CurSending.mPos += Sent) == 4 + Length)
+        {
+            if(auto OldCB = DD_rvalue(CurSending.mCB))
+                completions().push_back([OldCB]()->void {OldCB(true);});
+            mSendings.pop_front();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dSocket
+bool dSocket::openClient(dLiteral host, uint16_t port, AssignCB cb, bool nowait)
+{
+    SocketAgentP::checkNetwork(true);
+    {
+        if(const struct hostent* Host = gethostbyname(host.buildNative()))
+        {
+            struct sockaddr_in Addr;
+            memset(&Addr, 0, sizeof(Addr));
+            Addr.sin_family = AF_INET;
+            #if DD_OS_WINDOWS
+                Addr.sin_addr.S_un.S_un_b.s_b1 = (Host->h_addr_list[0][0] & 0xFF);
+                Addr.sin_addr.S_un.S_un_b.s_b2 = (Host->h_addr_list[0][1] & 0xFF);
                 Addr.sin_addr.S_un.S_un_b.s_b3 = (Host->h_addr_list[0][2] & 0xFF);
                 Addr.sin_addr.S_un.S_un_b.s_b4 = (Host->h_addr_list[0][3] & 0xFF);
             #elif DD_OS_LINUX
@@ -499,12 +2367,22 @@ bool dSocket::openClient(dLiteral host, uint16_t port, AssignCB cb)
             if(NewSocket != SOCKET_ERROR)
             {
                 SOCKET_SET_KEEPALIVE(NewSocket);
-                if(SOCKET_CONNECT(NewSocket, (struct sockaddr*) &Addr, sizeof(Addr)) != SOCKET_ERROR)
+                if(nowait)
+                    SOCKET_SET_NONBLOCK(NewSocket);
+                const bool Connected = (SOCKET_CONNECT(NewSocket, (struct sockaddr*) &Addr, sizeof(Addr)) != SOCKET_ERROR);
+                if(Connected || (nowait && SOCKET_WOULDBLOCK))
                 {
                     mRefAgent->detach();
                     mRefAgent = new SocketAgentP(NewSocket, cb);
                     SocketAgentP::checkNetwork(false);
-                    return true;
+                    if(!Connected) // 완료는 connecting에서 확인
+                    {
+                        mRefAgent->beginConnect();
+                        return true;
+                    }
+                    if(nowait)
+                        SOCKET_SET_BLOCK(NewSocket);
+                    return mRefAgent->greet();
                 }
                 SOCKET_DELETE(NewSocket);
             }
@@ -515,7 +2393,7 @@ bool dSocket::openClient(dLiteral host, uint16_t port, AssignCB cb)
     return false;
 }
 
-bool dSocket::openServer(uint16_t port, AssignCB cb)
+bool dSocket::openServer(uint16_t port, AssignCB cb, uint32_t shards)
 {
     SocketAgentP::checkNetwork(true);
     {
@@ -529,13 +2407,21 @@ bool dSocket::openServer(uint16_t port, AssignCB cb)
         if(NewSocket != SOCKET_ERROR)
         {
             SOCKET_SET_KEEPALIVE(NewSocket);
+            SOCKET_SET_REUSEADDR(NewSocket); // 재시작시 TIME_WAIT중인 같은 포트로 복귀
+
+            // SO_REUSEPORT는 bind후에 설정하여 사용중인 포트는 일반 bind처럼 실패시킴
             if(SOCKET_BIND(NewSocket, (struct sockaddr*) &Addr, sizeof(Addr)) != SOCKET_ERROR)
-            if(SOCKET_LISTEN(NewSocket, SOMAXCONN) != SOCKET_ERROR)
             {
-                mRefAgent->detach();
-                mRefAgent = new ServerAgentP(NewSocket, cb);
-                SocketAgentP::checkNetwork(false);
-                return true;
+                bool ReusePort = false;
+                if(1 < shards)
+                    SOCKET_SET_REUSEPORT(NewSocket, ReusePort); // 실패시 0번 샤드가 배분
+                if(SOCKET_LISTEN(NewSocket, SOMAXCONN) != SOCKET_ERROR)
+                {
+                    mRefAgent->detach();
+                    mRefAgent = new ServerAgentP(NewSocket, cb, port, shards, ReusePort);
+                    SocketAgentP::checkNetwork(false);
+                    return true;
+                }
             }
             SOCKET_DELETE(NewSocket);
         }
@@ -559,12 +2445,27 @@ uint32_t dSocket::count() const
 
 bool dSocket::sendTo(uint32_t id, const dBinary& binary, bool sizefield)
 {
-    return mRefAgent->sendTo(id, binary, sizefield);
+    return mRefAgent->sendTo(id, nullptr, 0, binary, sizefield);
+}
+
+bool dSocket::sendTo(uint32_t id, dumps header, uint32_t headerlength, const dBinary& binary)
+{
+    return mRefAgent->sendTo(id, header, headerlength, binary, true);
 }
 
 bool dSocket::sendAll(const dBinary& binary, bool sizefield)
 {
-    return mRefAgent->sendAll(binary, sizefield);
+    return mRefAgent->sendAll(nullptr, 0, binary, sizefield);
+}
+
+bool dSocket::sendAll(dumps header, uint32_t headerlength, const dBinary& binary)
+{
+    return mRefAgent->sendAll(header, headerlength, binary, true);
+}
+
+uint32_t dSocket::sendSome(const uint32_t* ids, uint32_t count, dumps header, uint32_t headerlength, const dBinary& binary)
+{
+    return mRefAgent->sendSome(ids, count, header, headerlength, binary, true);
 }
 
 dBinary dSocket::recvFrom(uint32_t id)
@@ -577,11 +2478,61 @@ void dSocket::recvAll(RecvCB cb)
     mRefAgent->recvAll(cb);
 }
 
+void dSocket::setDelivery(DeliveryType type)
+{
+    mRefAgent->setDelivery(type);
+}
+
+bool dSocket::flush()
+{
+    return mRefAgent->flush();
+}
+
+uint32_t dSocket::queued() const
+{
+    return mRefAgent->queued();
+}
+
+bool dSocket::ping()
+{
+    return mRefAgent->ping();
+}
+
+uint32_t dSocket::latency() const
+{
+    return mRefAgent->latency();
+}
+
+bool dSocket::shareLocalRing()
+{
+    return mRefAgent->shareLocalRing();
+}
+
 void dSocket::kick(uint32_t id)
 {
     mRefAgent->kick(id);
 }
 
+void dSocket::setHeartbeat(uint32_t interval, uint32_t timeout)
+{
+    mRefAgent->setHeartbeat(interval, timeout);
+}
+
+dSocket::PeerType dSocket::peerType(uint32_t id) const
+{
+    return mRefAgent->peerType(id);
+}
+
+bool dSocket::connecting()
+{
+    return mRefAgent->connecting();
+}
+
+dBinary dSocket::takeQueued()
+{
+    return mRefAgent->takeQueued();
+}
+
 const dSocket& dSocket::blank()
 {DD_global_direct(dSocket, _, (ptr_u) new SocketAgentP()); return _;}
 
@@ -615,6 +2566,96 @@ DD_passage_define_alone(dSocket, ptr_u agent)
     mRefAgent = (SocketAgentP*) agent;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dAsyncSocket
+void dAsyncSocket::connect(dLiteral host, uint16_t port, DoneCB cb)
+{
+    mRefAgent->detach();
+    mRefAgent = new AsyncAgentP();
+    mRefAgent->connect(host, port, cb);
+}
+
+bool dAsyncSocket::listen(uint16_t port)
+{
+    auto NewAgent = new AsyncAgentP();
+    if(NewAgent->listen(port))
+    {
+        mRefAgent->detach();
+        mRefAgent = NewAgent;
+        return true;
+    }
+    NewAgent->detach();
+    return false;
+}
+
+void dAsyncSocket::accept(AcceptCB cb)
+{
+    mRefAgent->accept(cb);
+}
+
+void dAsyncSocket::send(const dBinary& binary, DoneCB cb)
+{
+    mRefAgent->send(binary, cb);
+}
+
+void dAsyncSocket::recv(RecvCB cb)
+{
+    mRefAgent->recv(cb);
+}
+
+void dAsyncSocket::close()
+{
+    mRefAgent->close();
+}
+
+bool dAsyncSocket::isConnected() const
+{
+    return mRefAgent->isConnected();
+}
+
+uint32_t dAsyncSocket::poll(uint32_t timeout)
+{
+    return AsyncAgentP::poll(timeout);
+}
+
+uint32_t dAsyncSocket::pendings()
+{
+    return AsyncAgentP::pendings();
+}
+
+const dAsyncSocket& dAsyncSocket::blank()
+{DD_global_direct(dAsyncSocket, _, (ptr_u) new AsyncAgentP()); return _;}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dAsyncSocket::escaper
+void dAsyncSocket::_init_(InitType type)
+{
+    if(type == InitType::Create)
+        (mRefAgent = blank().mRefAgent)->attach();
+    else mRefAgent = nullptr;
+}
+
+void dAsyncSocket::_quit_()
+{
+    if(mRefAgent)
+        mRefAgent->detach();
+}
+
+void dAsyncSocket::_move_(_self_&& rhs)
+{
+    mRefAgent = rhs.mRefAgent;
+}
+
+void dAsyncSocket::_copy_(const _self_& rhs)
+{
+    (mRefAgent = rhs.mRefAgent)->attach();
+}
+
+DD_passage_define_alone(dAsyncSocket, ptr_u agent)
+{
+    mRefAgent = (AsyncAgentP*) agent;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ dUtility
 ptr_u dUtility::runProcess(dLiteral exepath, dLiteral args, dLiteral runtype, dLiteral runpath)
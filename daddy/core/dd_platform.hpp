@@ -7,16 +7,24 @@
 #include "dd_binary.hpp"
 #include "dd_string.hpp"
 #include <functional>
+#if DD_BUILD_COROUTINE
+    #include <coroutine>
+    #include <exception>
+    #include <memory>
+#endif
 
 namespace Daddy {
 
 class SocketAgentP;
+class AsyncAgentP;
 
 /// @brief 소켓객체
 class dSocket
 {
 public:
     enum class AssignType {Entrance, Leaved};
+    enum class DeliveryType {Normal, LowLatency, Throughput};
+    enum class PeerType {Unknown, Legacy, Current};
     typedef std::function<void(AssignType type, uint32_t id)> AssignCB;
     typedef std::function<void(uint32_t id, const dBinary& binary)> RecvCB;
 
@@ -25,14 +33,23 @@ public: // 사용성
     /// @param host       호스트주소
     /// @param port       포트번호
     /// @param cb         연결상황수신용 콜백함수
-    /// @return           true-성공, false-실패
-    bool openClient(dLiteral host, uint16_t port, AssignCB cb = nullptr);
+    /// @param nowait     true-connect의 완료를 기다리지 않음(주소해석은 동기)
+    /// @return           true-성공(nowait면 진행중일 수 있음), false-실패
+    /// @see              connecting
+    bool openClient(dLiteral host, uint16_t port, AssignCB cb = nullptr, bool nowait = false);
+
+    /// @brief            nowait로 시작한 connect의 진행확인(기다리지 않음)
+    /// @return           true-진행중(송수신불가), false-끝남(성공여부는 count로 확인)
+    bool connecting();
 
     /// @brief            서버로 객체생성(bind + listen)
     /// @param port       포트번호
-    /// @param cb         연결상황수신용 콜백함수
+    /// @param cb         연결상황수신용 콜백함수(샤드가 있으면 Entrance는 I/O스레드에서,
+    ///                   Leaved는 recvAll의 호출자가 해당 상대방의 남은 수신분 뒤에 받음)
+    /// @param shards     I/O스레드의 수량(0-recvFrom/recvAll의 호출자가 직접 수신,
+    ///                   N-SO_REUSEPORT로 N개의 리스너와 스레드가 상대방을 나눠서 수신)
     /// @return           true-성공, false-실패
-    bool openServer(uint16_t port, AssignCB cb = nullptr);
+    bool openServer(uint16_t port, AssignCB cb = nullptr, uint32_t shards = 0);
 
     /// @brief            객체소멸
     void close();
@@ -48,12 +65,36 @@ public: // 사용성
     /// @return           true-성공, false-실패
     bool sendTo(uint32_t id, const dBinary& binary, bool sizefield);
 
+    /// @brief            특정 상대방에게 헤더를 붙여서 바이너리 발송(복사없이 한 프레임으로)
+    /// @param id         상대방의 번호(상대가 서버면 0, 상대가 클라이언트면 0~N)
+    /// @param header     바이너리 앞에 붙일 헤더
+    /// @param headerlength 헤더의 길이
+    /// @param binary     발송할 바이너리
+    /// @return           true-성공, false-실패
+    bool sendTo(uint32_t id, dumps header, uint32_t headerlength, const dBinary& binary);
+
     /// @brief            모든 상대방에게 바이너리 발송
     /// @param binary     발송할 바이너리
     /// @param sizefield  true-사이즈필드(uint32_t) 사용, false-사이즈필드 미사용
     /// @return           true-모두 성공, false-모두 성공이 아님
     bool sendAll(const dBinary& binary, bool sizefield);
 
+    /// @brief            모든 상대방에게 헤더를 붙여서 바이너리 발송(복사없이 한 프레임으로)
+    /// @param header     바이너리 앞에 붙일 헤더
+    /// @param headerlength 헤더의 길이
+    /// @param binary     발송할 바이너리
+    /// @return           true-모두 성공, false-모두 성공이 아님
+    bool sendAll(dumps header, uint32_t headerlength, const dBinary& binary);
+
+    /// @brief            여러 상대방에게 헤더를 붙여서 바이너리 발송(한번 만든 프레임을 공유)
+    /// @param ids        상대방의 번호들
+    /// @param count      상대방의 수량
+    /// @param header     바이너리 앞에 붙일 헤더
+    /// @param headerlength 헤더의 길이
+    /// @param binary     발송할 바이너리
+    /// @return           발송에 성공한 상대방의 수량
+    uint32_t sendSome(const uint32_t* ids, uint32_t count, dumps header, uint32_t headerlength, const dBinary& binary);
+
     /// @brief            특정 상대방에게서 바이너리 수취
     /// @param id         상대방의 번호(상대가 서버면 0, 상대가 클라이언트면 0~N)
     /// @return           수취된 바이너리
@@ -63,10 +104,49 @@ public: // 사용성
     /// @param cb         데이터수신용 콜백함수(1회성)
     void recvAll(RecvCB cb);
 
+    /// @brief            전송방식 지정(서버는 이후 접속하는 상대방에게도 적용)
+    /// @param type       Normal-기본, LowLatency-TCP_NODELAY 및 즉시발송, Throughput-큐잉후 flush시 일괄발송
+    void setDelivery(DeliveryType type);
+
+    /// @brief            큐잉된 바이너리를 일괄발송(Throughput전용, 그외에는 무시)
+    /// @return           true-성공, false-실패한 상대방이 있음
+    bool flush();
+
+    /// @brief            큐잉되어 발송을 기다리는 바이트수(Throughput전용)
+    /// @return           바이트수(서버는 모든 상대방의 합)
+    uint32_t queued() const;
+
+    /// @brief            큐잉되어 발송을 기다리는 프레임들을 꺼냄(Throughput전용, 클라이언트전용)
+    /// @return           사이즈필드가 붙은 프레임들(다른 연결에 sizefield없이 그대로 발송가능)
+    dBinary takeQueued();
+
+    /// @brief            왕복지연 측정요청(회신이 오면 latency에 반영)
+    /// @return           true-성공, false-실패
+    bool ping();
+
+    /// @brief            마지막으로 측정된 왕복지연
+    /// @return           마이크로초(서버는 상대방중 최대값, 0이면 미측정)
+    uint32_t latency() const;
+
+    /// @brief            같은 머신의 서버와 연결된 경우 공유메모리 링전송으로 전환요청(클라이언트전용)
+    /// @return           true-요청됨(상대방이 인사해오면 제안하고, 수락하면 이후 송수신은 링으로), false-대상아님
+    /// @see              링과 ping은 컨트롤프레임을 아는 상대방에게만(이전 버전과는 TCP로만 통신)
+    bool shareLocalRing();
+
     /// @brief            특정 상대방과의 연결해제
     /// @param id         상대방의 번호(상대가 서버면 0, 상대가 클라이언트면 0~N)
     void kick(uint32_t id);
 
+    /// @brief            하트비트 지정(서버는 이후 접속하는 상대방에게도 적용)
+    /// @param interval   수신이 없을때 Ping을 보내는 주기(밀리초, 0이면 해제)
+    /// @param timeout    이 시간동안 수신이 없으면 연결해제(밀리초, 0이면 interval의 3배, ping을 모르는 이전 버전은 제외)
+    void setHeartbeat(uint32_t interval, uint32_t timeout = 0);
+
+    /// @brief            상대방의 버전구분(접속직후 보내오는 인사로 판단)
+    /// @param id         상대방의 번호(상대가 서버면 0, 상대가 클라이언트면 0~N)
+    /// @return           Unknown-아직 모름, Legacy-인사없이 프레임을 보낸 이전 버전, Current-인사를 보낸 이번 버전
+    PeerType peerType(uint32_t id = 0) const;
+
 private:
     static const dSocket& blank();
 
@@ -81,6 +161,164 @@ private:
     DD_passage_declare_alone(dSocket, ptr_u agent); // move only
 };
 
+/// @brief 비동기소켓(완료통지형, 프레임은 dSocket의 사이즈필드방식과 호환)
+/// @see dSocket
+class dAsyncSocket
+{
+public:
+    typedef std::function<void(bool success)> DoneCB;
+    typedef std::function<void(dAsyncSocket peer)> AcceptCB;
+    typedef std::function<void(dBinary binary)> RecvCB;
+
+public: // 사용성(콜백형)
+    /// @brief            연결요청(주소해석은 동기, 연결은 비동기)
+    /// @param host       호스트주소
+    /// @param port       포트번호
+    /// @param cb         완료통지용 콜백함수(true-성공, false-실패)
+    void connect(dLiteral host, uint16_t port, DoneCB cb);
+
+    /// @brief            서버로 객체생성(bind + listen)
+    /// @param port       포트번호
+    /// @return           true-성공, false-실패
+    bool listen(uint16_t port);
+
+    /// @brief            접속자 하나의 수락요청(여러번 요청하면 순서대로 수락)
+    /// @param cb         완료통지용 콜백함수(실패시 연결되지 않은 소켓)
+    void accept(AcceptCB cb);
+
+    /// @brief            한 프레임의 발송요청(여러번 요청하면 순서대로 발송)
+    /// @param binary     발송할 바이너리(발송이 끝날때까지 참조됨)
+    /// @param cb         완료통지용 콜백함수(true-성공, false-실패)
+    void send(const dBinary& binary, DoneCB cb = nullptr);
+
+    /// @brief            한 프레임의 수신요청(여러번 요청하면 순서대로 수신)
+    /// @param cb         완료통지용 콜백함수(실패나 연결종료시 빈 바이너리)
+    void recv(RecvCB cb);
+
+    /// @brief            연결해제(대기중인 작업들은 실패로 통지됨)
+    void close();
+
+    /// @brief            연결여부
+    /// @return           true-연결됨, false-연결되지 않음
+    bool isConnected() const;
+
+    /// @brief            I/O루프 구동(준비된 소켓을 처리하고 완료된 작업들을 통지)
+    /// @param timeout    처리할 것이 없을때 기다릴 최대시간(밀리초)
+    /// @return           통지된 작업의 수
+    /// @see              pendings
+    static uint32_t poll(uint32_t timeout);
+
+    /// @brief            완료되지 않았거나 통지를 기다리는 작업의 수
+    /// @return           작업의 수
+    static uint32_t pendings();
+
+#if DD_BUILD_COROUTINE
+public: // 사용성(코루틴형)
+    /// @brief 코루틴에서 co_await로 완료를 기다리는 대기객체(재개는 poll을 부른 스레드에서)
+    template<typename TYPE>
+    class Awaiter
+    {
+    public:
+        bool await_ready() const {return mState->mDone;}
+        void await_suspend(std::coroutine_handle<> handle) {mState->mHandle = handle;}
+        TYPE await_resume() {return DD_rvalue(mState->mResult);}
+
+    public:
+        struct State
+        {
+            bool mDone = false;
+            TYPE mResult {};
+            std::coroutine_handle<> mHandle;
+            void complete(TYPE result)
+            {
+                mResult = DD_rvalue(result);
+                mDone = true;
+                if(mHandle) mHandle.resume();
+            }
+        };
+        std::shared_ptr<State> mState = std::make_shared<State>();
+    };
+
+    /// @brief            co_await용 connect
+    /// @return           true-성공, false-실패
+    Awaiter<bool> connecting(dLiteral host, uint16_t port);
+
+    /// @brief            co_await용 accept
+    /// @return           접속한 상대방(실패시 연결되지 않은 소켓)
+    Awaiter<dAsyncSocket> accepting();
+
+    /// @brief            co_await용 send
+    /// @return           true-성공, false-실패
+    Awaiter<bool> sending(const dBinary& binary);
+
+    /// @brief            co_await용 recv
+    /// @return           수신된 바이너리(실패나 연결종료시 빈 바이너리)
+    Awaiter<dBinary> receiving();
+#endif
+
+private:
+    static const dAsyncSocket& blank();
+    friend class AsyncAgentP;
+
+DD_escaper_alone(dAsyncSocket): // 객체사이클
+    void _init_(InitType type);
+    void _quit_();
+    void _move_(_self_&& rhs);
+    void _copy_(const _self_& rhs);
+    AsyncAgentP* mRefAgent;
+
+private:
+    DD_passage_declare_alone(dAsyncSocket, ptr_u agent); // move only
+};
+
+#if DD_BUILD_COROUTINE
+    /// @brief 비동기소켓용 코루틴(호출즉시 실행되고 끝나면 스스로 소멸)
+    class dAsyncTask
+    {
+    public:
+        struct promise_type
+        {
+            dAsyncTask get_return_object() {return {};}
+            std::suspend_never initial_suspend() noexcept {return {};}
+            std::suspend_never final_suspend() noexcept {return {};}
+            void return_void() {}
+            void unhandled_exception() {std::terminate();}
+        };
+    };
+
+    inline dAsyncSocket::Awaiter<bool> dAsyncSocket::connecting(dLiteral host, uint16_t port)
+    {
+        Awaiter<bool> NewAwaiter;
+        auto CurState = NewAwaiter.mState;
+        connect(host, port, [CurState](bool success)->void {CurState->complete(success);});
+        return NewAwaiter;
+    }
+
+    inline dAsyncSocket::Awaiter<dAsyncSocket> dAsyncSocket::accepting()
+    {
+        Awaiter<dAsyncSocket> NewAwaiter;
+        auto CurState = NewAwaiter.mState;
+        accept([CurState](dAsyncSocket peer)->void {CurState->complete(DD_rvalue(peer));});
+        return NewAwaiter;
+    }
+
+    inline dAsyncSocket::Awaiter<bool> dAsyncSocket::sending(const dBinary& binary)
+    {
+        Awaiter<bool> NewAwaiter;
+        auto CurState = NewAwaiter.mState;
+        send(binary, [CurState](bool success)->void {CurState->complete(success);});
+        return NewAwaiter;
+    }
+
+    inline dAsyncSocket::Awaiter<dBinary> dAsyncSocket::receiving()
+    {
+        Awaiter<dBinary> NewAwaiter;
+        auto CurState = NewAwaiter.mState;
+        recv([CurState](dBinary binary)->void {CurState->complete(DD_rvalue(binary));});
+        return NewAwaiter;
+    }
+#endif
+
 /// @brief 유틸리티
 class dUtility
 {
@@ -7,29 +7,298 @@
 #include "dd_binary.hpp"
 #include "dd_platform.hpp"
 #include "dd_string.hpp"
+#include "dd_thread.hpp"
 #include "dd_zoker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <map>
+#include <mutex>
+#include <random>
 #include <string>
 #include <thread>
 #include <stack>
+#include <tuple>
+#include <vector>
 
 namespace Daddy {
 
+typedef std::function<bool(dTelepath::TeleID tele, const dBinary& frame, bool framed)> RouteCB;
+
+// 실크의 프레임은 [kind:1]로 시작하고, Call/Reply/Fault는 [callid:4], Hello는 [session:8]이 이어짐
+// Subscribe/Unsubscribe는 [topic], Publish는 [topiclength:2][topic]이 이어짐
+// 종류바이트는 서버의 인사를 받은 클라이언트가 Hello를 보내고 서버가 이를 돌려준 이후에만 사용,
+// 그전이나 이전 버전의 상대방과는 종류바이트없이 메시지만 주고받음
+enum FrameKind : uint8_t {KindMessage = 0, KindCall, KindReply, KindFault, KindHello,
+    KindSubscribe, KindUnsubscribe, KindPublish};
+
+static uint64_t nowMsec()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ 게이트 조크메시지의 스키마(바이너리 프로토콜을 모르는 게이트용)
+#define GATE_NODE_FIELDS(FIELD) \
+    FIELD(utf8s, component) \
+    FIELD(uint8_t, gate) \
+    FIELD(utf8s, id) \
+    FIELD(utf8s, type)
+DD_zoke_schema(GateNodeP, GATE_NODE_FIELDS);
+
+#define GATE_SILK_FIELDS(FIELD) \
+    FIELD(int32_t, id) \
+    FIELD(utf8s, type)
+DD_zoke_schema(GateSilkP, GATE_SILK_FIELDS); // connect_sub, disconnected
+
+#define GATE_ADDRESS_FIELDS(FIELD) \
+    FIELD(utf8s, ip4) \
+    FIELD(uint16_t, port)
+DD_zoke_schema(GateAddressP, GATE_ADDRESS_FIELDS);
+
+#define GATE_CONNECTED_FIELDS(FIELD) \
+    FIELD(GateAddressP, address) \
+    FIELD(int32_t, id) \
+    FIELD(utf8s, type)
+DD_zoke_schema(GateConnectedP, GATE_CONNECTED_FIELDS);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ SilkCounterP
+class SilkCounterP
+{
+public:
+    SilkCounterP()
+    {
+        mReportedMessages = 0;
+        mReportedBytes = 0;
+        mReportedFailures = 0;
+    }
+    ~SilkCounterP()
+    {
+    }
+
+public:
+    inline void onSent(uint32_t length, bool success)
+    {
+        if(success)
+        {
+            mSentMessages.fetch_add(1, std::memory_order_relaxed);
+            mSentBytes.fetch_add(length, std::memory_order_relaxed);
+        }
+        else mFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void onReceived(uint32_t length)
+    {
+        mRecvMessages.fetch_add(1, std::memory_order_relaxed);
+        mRecvBytes.fetch_add(length, std::memory_order_relaxed);
+    }
+
+public:
+    std::atomic<uint64_t> mSentMessages {0};
+    std::atomic<uint64_t> mSentBytes {0};
+    std::atomic<uint64_t> mRecvMessages {0};
+    std::atomic<uint64_t> mRecvBytes {0};
+    std::atomic<uint64_t> mFailures {0};
+    uint64_t mReportedMessages; // 게이트에 마지막으로 보고한 값(델타계산용)
+    uint64_t mReportedBytes;
+    uint64_t mReportedFailures;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ TopicTrieP
+// 토픽의 글자마다 노드를 따라가며, 끝이 '*'인 구독은 그 앞까지의 노드에 접두사로 등록
+class TopicTrieP
+{
+public:
+    TopicTrieP()
+    {
+        mNodes.emplace_back();
+    }
+
+public:
+    bool add(utf8s_nn topic, uint32_t length, uint32_t id)
+    {
+        const bool IsPrefix = (0 < length && topic[length - 1] == '*');
+        Node& CurNode = mNodes[reach(topic, (IsPrefix)? length - 1 : length)];
+        std::vector<uint32_t>& IDs = (IsPrefix)? CurNode.mPrefixIDs : CurNode.mExactIDs;
+        if(std::find(IDs.begin(), IDs.end(), id) != IDs.end())
+            return false;
+        IDs.push_back(id);
+        mTopicsOfID[id].push_back(std::string(topic, length));
+        return true;
+    }
+
+    bool sub(utf8s_nn topic, uint32_t length, uint32_t id)
+    {
+        auto CurTopics = mTopicsOfID.find(id);
+        if(CurTopics == mTopicsOfID.end())
+            return false;
+        auto CurTopic = std::find(CurTopics->second.begin(), CurTopics->second.end(), std::string(topic, length));
+        if(CurTopic == CurTopics->second.end())
+            return false;
+        CurTopics->second.erase(CurTopic);
+        if(CurTopics->second.empty())
+            mTopicsOfID.erase(CurTopics);
+        detach(topic, length, id);
+        return true;
+    }
+
+    void subAll(uint32_t id)
+    {
+        auto CurTopics = mTopicsOfID.find(id);
+        if(CurTopics == mTopicsOfID.end())
+            return;
+        for(const auto& iTopic : CurTopics->second)
+            detach(iTopic.c_str(), (uint32_t) iTopic.length(), id);
+        mTopicsOfID.erase(CurTopics);
+    }
+
+    void match(utf8s_nn topic, uint32_t length, std::vector<uint32_t>& ids) const
+    {
+        // 지나가는 노드마다 접두사 구독을, 끝난 노드에서 정확한 구독을 수집
+        int32_t CurIndex = 0;
+        for(uint32_t i = 0; CurIndex != -1; ++i)
+        {
+            const Node& CurNode = mNodes[CurIndex];
+            ids.insert(ids.end(), CurNode.mPrefixIDs.begin(), CurNode.mPrefixIDs.end());
+            if(i == length)
+            {
+                ids.insert(ids.end(), CurNode.mExactIDs.begin(), CurNode.mExactIDs.end());
+                break;
+            }
+            auto NextNode = CurNode.mChildren.find((uint8_t) topic[i]);
+            CurIndex = (NextNode != CurNode.mChildren.end())? NextNode->second : -1;
+        }
+        std::sort(ids.begin(), ids.end()); // 여러 구독에 걸린 상대도 1회만
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+
+private:
+    int32_t reach(utf8s_nn topic, uint32_t length)
+    {
+        int32_t CurIndex = 0;
+        for(uint32_t i = 0; i < length; ++i)
+        {
+            auto NextNode = mNodes[CurIndex].mChildren.find((uint8_t) topic[i]);
+            if(NextNode != mNodes[CurIndex].mChildren.end())
+                CurIndex = NextNode->second;
+            else
+            {
+                int32_t NewIndex = (int32_t) mNodes.size();
+                if(!mFreeNodes.empty())
+                {
+                    NewIndex = mFreeNodes.back();
+                    mFreeNodes.pop_back();
+                }
+                else mNodes.emplace_back();
+                mNodes[CurIndex].mChildren[(uint8_t) topic[i]] = NewIndex;
+                CurIndex = NewIndex;
+            }
+        }
+        return CurIndex;
+    }
+
+    void detach(utf8s_nn topic, uint32_t length, uint32_t id)
+    {
+        const bool IsPrefix = (0 < length && topic[length - 1] == '*');
+        const uint32_t Length = (IsPrefix)? length - 1 : length;
+        std::vector<int32_t> Path(1, 0); // 루트부터 지나온 노드
+        for(uint32_t i = 0; i < Length; ++i)
+        {
+            auto NextNode = mNodes[Path.back()].mChildren.find((uint8_t) topic[i]);
+            if(NextNode == mNodes[Path.back()].mChildren.end())
+                return;
+            Path.push_back(NextNode->second);
+        }
+        std::vector<uint32_t>& IDs = (IsPrefix)? mNodes[Path.back()].mPrefixIDs : mNodes[Path.back()].mExactIDs;
+        auto CurID = std::find(IDs.begin(), IDs.end(), id);
+        if(CurID == IDs.end())
+            return;
+        *CurID = IDs.back();
+        IDs.pop_back();
+
+        // 비게 된 노드는 잎부터 부모에서 떼어내고 번호는 다음 생성때 재사용
+        for(uint32_t i = Length; 0 < i; --i)
+        {
+            Node& CurNode = mNodes[Path[i]];
+            if(!CurNode.mChildren.empty() || !CurNode.mExactIDs.empty() || !CurNode.mPrefixIDs.empty())
+                break;
+            mNodes[Path[i - 1]].mChildren.erase((uint8_t) topic[i - 1]);
+            CurNode = Node();
+            mFreeNodes.push_back(Path[i]);
+        }
+    }
+
+private:
+    struct Node
+    {
+        std::map<uint8_t, int32_t> mChildren;
+        std::vector<uint32_t> mExactIDs;
+        std::vector<uint32_t> mPrefixIDs;
+    };
+    std::vector<Node> mNodes; // 0번이 루트
+    std::vector<int32_t> mFreeNodes; // 떼어낸 노드의 번호
+    std::map<uint32_t, std::vector<std::string>> mTopicsOfID; // 상대가 떠날때의 정리용
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ TeleClientP
 class TeleClientP
 {
+public:
+    enum class LinkEvent {None, Connected, Reconnected};
+
 public:
     bool connectTo(utf8s hostname, uint16_t port)
     {
-        return mConnected = mSocket.openClient(dString(hostname), port);
+        mConnected = mSocket.openClient(dString(hostname), port);
+        if(mConnected)
+            prepare(false);
+        return mConnected;
     }
 
     void disconnect()
     {
         mSocket.close();
         mConnected = false;
+        mConnecting = false;
+        mGreeting = false;
+        mRaw = false;
+        mAcked = false;
+    }
+
+    LinkEvent linkTo(utf8s hostname, uint16_t port)
+    {
+        // 이후 연결이 끊기면 스스로 재접속
+        mTargetHost = hostname;
+        mTargetPort = port;
+        mRetryDelay = 0;
+        if(mConnected || mConnecting)
+            disconnect();
+        return resume();
+    }
+
+    void unlink()
+    {
+        mTargetPort = 0;
+        mOutbox.clear();
+        mOutboxLength = 0;
+        mUnsent.clear();
+        disconnect();
+    }
+
+    LinkEvent retry()
+    {
+        if(mConnecting)
+            return settle();
+        if(mConnected || mTargetPort == 0 || nowMsec() < mRetryMsec)
+            return LinkEvent::None;
+        return resume();
     }
 
     bool sendBinary(const dBinary& binary)
@@ -38,30 +307,266 @@ public:
         return mConnected;
     }
 
+    bool sendBinary(dumps header, uint32_t headerlength, const dBinary& binary)
+    {
+        if(mConnected && !mGreeting)
+        {
+            if(mRaw) // 이전 버전의 서버에게는 메시지만 종류바이트없이
+            {
+                if(headerlength < 1 || header[0] != KindMessage)
+                    return false;
+                header++;
+                headerlength--;
+            }
+            const uint32_t OldQueued = mSocket.queued();
+            if(mSocket.sendTo(0, header, headerlength, binary))
+                return true;
+            const bool Queued = (OldQueued < mSocket.queued()); // 큐잉된채 flush만 실패
+            lose();
+            if(Queued && mTargetPort != 0)
+                return true;
+        }
+        if(mTargetPort == 0)
+            return false;
+
+        // 재접속까지 보관(호출자의 버퍼는 보장되지 않으므로 복사)
+        const uint32_t FrameLength = headerlength + binary.length();
+        if(mOutboxLimit < mOutboxLength + FrameLength)
+            return false;
+        dBinary NewFrame;
+        NewFrame.add(header, headerlength).add(binary.buffer(), binary.length());
+        mOutbox.push_back(NewFrame);
+        mOutboxLength += FrameLength;
+        return true;
+    }
+
+    void sendTopic(bool subscribe, const std::string& topic)
+    {
+        // 구독목록은 접속할 때마다 다시 알리므로 끊긴동안은 목록만 갱신
+        auto CurTopic = std::find(mTopics.begin(), mTopics.end(), topic);
+        if(subscribe == (CurTopic != mTopics.end()))
+            return;
+        if(subscribe)
+            mTopics.push_back(topic);
+        else mTopics.erase(CurTopic);
+        const dump Header[1] = {(dump) ((subscribe)? KindSubscribe : KindUnsubscribe)};
+        if(mConnected && !mGreeting && !mRaw
+            && !mSocket.sendTo(0, Header, 1, dBinary::fromExternal((dumps) topic.c_str(), (uint32_t) topic.length())))
+            lose();
+    }
+
     dBinary recvBinary()
     {
         return mSocket.recvFrom(0);
     }
 
-    bool nextReceive()
+    void flush()
     {
-        bool NeedUpdate = false;
-        mSocket.recvAll([this, &NeedUpdate](uint32_t id, const dBinary& binary)->void
+        if(mConnected && mDelivery == dSocket::DeliveryType::Throughput && !mSocket.flush())
+            lose();
+    }
+
+    void ping()
+    {
+        if(mConnected && !mSocket.ping())
+            lose();
+    }
+
+    LinkEvent nextReceive(const RouteCB& route)
+    {
+        mSocket.recvAll([this, &route](uint32_t id, const dBinary& binary)->void
             {
-                NeedUpdate |= mReceiveCB(id, dTelepath::ReceiveType::Message, binary);
+                // 서버가 Hello를 돌려준 이후의 수신만 실크프레임
+                if(!mAcked && !mGreeting && !mRaw && binary.length() == 9
+                    && binary.buffer()[0] == KindHello && !memcmp(&binary.buffer()[1], &mSession, 8))
+                    mAcked = true;
+                else route(id, binary, mAcked);
             });
-        return NeedUpdate;
+        if(mConnected && mSocket.count() == 0) // 상대방의 종료
+        {
+            lose();
+            return LinkEvent::None;
+        }
+        return settle();
+    }
+
+private:
+    enum {ConnectMsec = 3000, GreetMsec = 1000}; // connect의 한도, 인사가 이만큼 없으면 이전 버전의 서버
+
+    void prepare(bool localring)
+    {
+        mSocket.setDelivery(mDelivery);
+        if(mBeatInterval != 0)
+            mSocket.setHeartbeat(mBeatInterval, mBeatTimeout);
+        if(localring) // 같은 머신의 서버라면 공유메모리 링으로 전환
+            mSocket.shareLocalRing();
+    }
+
+    LinkEvent resume()
+    {
+        // 메인틱을 막지 않도록 connect는 기다리지 않고 매 틱마다 확인
+        if(mSocket.openClient((dLiteral) mTargetHost, mTargetPort, nullptr, true))
+        {
+            mConnecting = true;
+            mConnectMsec = nowMsec() + ConnectMsec;
+            return settle();
+        }
+        lose();
+        return LinkEvent::None;
+    }
+
+    LinkEvent settle()
+    {
+        if(mConnecting)
+        {
+            if(mSocket.connecting())
+            {
+                if(mConnectMsec <= nowMsec())
+                    lose();
+                return LinkEvent::None;
+            }
+            mConnecting = false;
+            if(mSocket.count() == 0)
+            {
+                lose();
+                return LinkEvent::None;
+            }
+
+            // 서버의 인사로 실크프레임을 아는지 확인할때까지 발송분은 보관
+            mConnected = true;
+            prepare(true);
+            mGreeting = true;
+            mGreetMsec = nowMsec() + GreetMsec;
+        }
+        if(!mGreeting)
+            return LinkEvent::None;
+        const dSocket::PeerType Type = mSocket.peerType();
+        if(Type == dSocket::PeerType::Unknown && nowMsec() < mGreetMsec)
+            return LinkEvent::None;
+        mGreeting = false;
+        mRaw = (Type != dSocket::PeerType::Current);
+
+        // 세션과 구독을 알리고 끊긴동안 보관된 메시지를 순서대로 재발송
+        bool Result = true;
+        if(!mRaw)
+        {
+            dump Hello[9] = {KindHello};
+            memcpy(&Hello[1], &mSession, 8);
+            Result = mSocket.sendTo(0, Hello, 9, dBinary());
+            const dump Subscribe[1] = {KindSubscribe};
+            for(size_t i = 0, iend = mTopics.size(); Result && i < iend; ++i)
+                Result = mSocket.sendTo(0, Subscribe, 1, dBinary::fromExternal((dumps) mTopics[i].c_str(), (uint32_t) mTopics[i].length()));
+        }
+        if(Result && 0 < mUnsent.length())
+        {
+            // 끊길때 큐잉되어 있던 프레임은 같은 방식의 서버에게만(사이즈필드 포함)
+            if(mUnsentRaw == mRaw)
+                Result = mSocket.sendTo(0, mUnsent, false);
+            else mLostFrames += countFrames(mUnsent);
+            if(Result)
+                mUnsent.clear();
+        }
+        while(Result && !mOutbox.empty())
+        {
+            const dBinary& CurFrame = mOutbox.front();
+            if(!mRaw)
+                Result = mSocket.sendTo(0, CurFrame, true);
+            else if(CurFrame.buffer()[0] == KindMessage) // 이전 버전에게 호출은 보낼 수 없으므로 버림
+                Result = mSocket.sendTo(0, &CurFrame.buffer()[1], CurFrame.length() - 1, dBinary());
+            if(Result)
+            {
+                mOutboxLength -= CurFrame.length();
+                mOutbox.pop_front();
+            }
+        }
+        if(Result)
+        {
+            mRetryDelay = 0;
+            const bool Resumed = mLinked;
+            mLinked = true;
+            return (Resumed)? LinkEvent::Reconnected : LinkEvent::Connected;
+        }
+        lose();
+        return LinkEvent::None;
+    }
+
+    void lose()
+    {
+        // 큐잉된채 보내지 못한 프레임은 재접속후에 재발송
+        const dBinary Unsent = mSocket.takeQueued();
+        if(0 < Unsent.length())
+        {
+            if(mTargetPort == 0)
+                mLostFrames += countFrames(Unsent);
+            else
+            {
+                mUnsent.add(Unsent.buffer(), Unsent.length());
+                mUnsentRaw = mRaw;
+            }
+        }
+
+        // 지터가 섞인 지수적 백오프(100ms ~ 5000ms)
+        disconnect();
+        static std::minstd_rand Random((uint32_t) std::random_device()());
+        mRetryDelay = (mRetryDelay == 0)? 100 : std::min(mRetryDelay * 2, (uint32_t) 5000);
+        mRetryMsec = nowMsec() + mRetryDelay / 2 + Random() % (mRetryDelay / 2 + 1);
+    }
+
+    static uint32_t countFrames(const dBinary& frames)
+    {
+        uint32_t Result = 0;
+        for(uint32_t Pos = 0, Size = 0; Pos + 4 <= frames.length(); Pos += 4 + Size, ++Result)
+            memcpy(&Size, &frames.buffer()[Pos], 4);
+        return Result;
     }
 
 public:
     inline bool isConnected() const
     {return mConnected;}
+    inline const dTelepath::ReceiveCB& receiveCB() const
+    {return mReceiveCB;}
+    inline void setReceiveCB(dTelepath::ReceiveCB cb)
+    {mReceiveCB = cb;}
+    inline uint32_t queued() const
+    {return mSocket.queued() + mUnsent.length() + mOutboxLength;}
+    inline uint32_t takeLostFrames()
+    {const uint32_t Result = mLostFrames; mLostFrames = 0; return Result;}
+    inline uint32_t latency() const
+    {return mSocket.latency();}
+    inline void setOutboxLimit(uint32_t limit)
+    {mOutboxLimit = limit;}
+    void setHeartbeat(uint32_t interval, uint32_t timeout)
+    {
+        // 재접속할 때마다 새 소켓에 다시 적용
+        mBeatInterval = interval;
+        mBeatTimeout = timeout;
+        if(mConnected)
+            mSocket.setHeartbeat(interval, timeout);
+    }
 
 DD_escaper_alone(TeleClientP):
     void _init_(InitType)
     {
         mReceiveCB = nullptr;
+        mDelivery = dSocket::DeliveryType::Normal;
         mConnected = false;
+        mConnecting = false;
+        mConnectMsec = 0;
+        mGreeting = false;
+        mRaw = false;
+        mAcked = false;
+        mGreetMsec = 0;
+        mUnsentRaw = false;
+        mLostFrames = 0;
+        mLinked = false;
+        mTargetPort = 0;
+        mSession = (uint64_t(std::random_device()()) << 32) | std::random_device()();
+        mRetryDelay = 0;
+        mRetryMsec = 0;
+        mOutboxLength = 0;
+        mOutboxLimit = 0;
+        mBeatInterval = 0;
+        mBeatTimeout = 0;
     }
     void _quit_()
     {
@@ -70,23 +575,91 @@ DD_escaper_alone(TeleClientP):
     {
         mSocket = DD_rvalue(rhs.mSocket);
         mReceiveCB = DD_rvalue(rhs.mReceiveCB);
+        mDelivery = DD_rvalue(rhs.mDelivery);
         mConnected = DD_rvalue(rhs.mConnected);
+        mConnecting = DD_rvalue(rhs.mConnecting);
+        mConnectMsec = DD_rvalue(rhs.mConnectMsec);
+        mGreeting = DD_rvalue(rhs.mGreeting);
+        mRaw = DD_rvalue(rhs.mRaw);
+        mAcked = DD_rvalue(rhs.mAcked);
+        mGreetMsec = DD_rvalue(rhs.mGreetMsec);
+        mLinked = DD_rvalue(rhs.mLinked);
+        mTargetHost = DD_rvalue(rhs.mTargetHost);
+        mTargetPort = DD_rvalue(rhs.mTargetPort);
+        mSession = DD_rvalue(rhs.mSession);
+        mRetryDelay = DD_rvalue(rhs.mRetryDelay);
+        mRetryMsec = DD_rvalue(rhs.mRetryMsec);
+        mUnsent = DD_rvalue(rhs.mUnsent);
+        mUnsentRaw = DD_rvalue(rhs.mUnsentRaw);
+        mLostFrames = DD_rvalue(rhs.mLostFrames);
+        mOutbox = DD_rvalue(rhs.mOutbox);
+        mOutboxLength = DD_rvalue(rhs.mOutboxLength);
+        mOutboxLimit = DD_rvalue(rhs.mOutboxLimit);
+        mBeatInterval = DD_rvalue(rhs.mBeatInterval);
+        mBeatTimeout = DD_rvalue(rhs.mBeatTimeout);
+        mTopics = DD_rvalue(rhs.mTopics);
     }
     void _copy_(const _self_& rhs)
     {
         mSocket = rhs.mSocket;
         mReceiveCB = rhs.mReceiveCB;
+        mDelivery = rhs.mDelivery;
         mConnected = rhs.mConnected;
+        mConnecting = rhs.mConnecting;
+        mConnectMsec = rhs.mConnectMsec;
+        mGreeting = rhs.mGreeting;
+        mRaw = rhs.mRaw;
+        mAcked = rhs.mAcked;
+        mGreetMsec = rhs.mGreetMsec;
+        mLinked = rhs.mLinked;
+        mTargetHost = rhs.mTargetHost;
+        mTargetPort = rhs.mTargetPort;
+        mSession = rhs.mSession;
+        mRetryDelay = rhs.mRetryDelay;
+        mRetryMsec = rhs.mRetryMsec;
+        mUnsent = rhs.mUnsent;
+        mUnsentRaw = rhs.mUnsentRaw;
+        mLostFrames = rhs.mLostFrames;
+        mOutbox = rhs.mOutbox;
+        mOutboxLength = rhs.mOutboxLength;
+        mOutboxLimit = rhs.mOutboxLimit;
+        mBeatInterval = rhs.mBeatInterval;
+        mBeatTimeout = rhs.mBeatTimeout;
+        mTopics = rhs.mTopics;
     }
     dSocket mSocket;
     dTelepath::ReceiveCB mReceiveCB;
+    dSocket::DeliveryType mDelivery;
     bool mConnected;
+    bool mConnecting; // 재접속의 connect가 끝나기를 기다리는 중
+    uint64_t mConnectMsec;
+    bool mGreeting; // 접속후 서버의 인사를 기다리는 중(그동안의 발송분은 보관)
+    bool mRaw; // 이전 버전의 서버라 메시지만 종류바이트없이 주고받음
+    bool mAcked; // 서버가 Hello를 돌려주었음(그전의 수신은 종류바이트없음)
+    uint64_t mGreetMsec;
+    bool mLinked; // 한번이라도 연결된 적이 있음(이후는 Reconnected)
+    dString mTargetHost;
+    uint16_t mTargetPort; // 0이면 재접속하지 않음
+    uint64_t mSession;
+    uint32_t mRetryDelay;
+    uint64_t mRetryMsec;
+    dBinary mUnsent; // 끊길때 소켓에 큐잉되어 있던 프레임들(Throughput전용)
+    bool mUnsentRaw;
+    uint32_t mLostFrames; // 재발송할 수 없어 버려진 프레임수(발송실패로 집계)
+    std::deque<dBinary> mOutbox; // 끊긴동안 발송된 프레임
+    uint32_t mOutboxLength;
+    uint32_t mOutboxLimit;
+    uint32_t mBeatInterval;
+    uint32_t mBeatTimeout;
+    std::vector<std::string> mTopics; // 구독중인 토픽(접속시 재전송)
 
 public:
-    DD_passage_alone(TeleClientP, dTelepath::ReceiveCB cb)
+    DD_passage_alone(TeleClientP, dTelepath::ReceiveCB cb, dSocket::DeliveryType delivery, uint32_t outboxlimit)
     {
+        _init_(InitType::Create);
         mReceiveCB = cb;
-        mConnected = false;
+        mDelivery = delivery;
+        mOutboxLimit = outboxlimit;
     }
 };
 
@@ -98,21 +671,24 @@ public:
     bool bindTo(uint16_t port)
     {
         mSavedPort = port;
-        if(!mReceiveCB)
-            return mSocket.openServer(port);
-        return mSocket.openServer(port,
+        if(!mSocket.openServer(port,
             [this](dSocket::AssignType type, uint32_t id)->void
             {
                 switch(type)
                 {
-                case dSocket::AssignType::Entrance:
-                    mReceiveCB(id, dTelepath::ReceiveType::Connected, dBinary());
+                case dSocket::AssignType::Entrance: // Connected는 Hello나 첫 프레임을 받거나 인사기한이 지난 후에
+                    mEnteredMutex.lock();
+                    mEntered.push_back(id);
+                    mEnteredMutex.unlock();
                     break;
-                case dSocket::AssignType::Leaved:
-                    mReceiveCB(id, dTelepath::ReceiveType::Disconnected, dBinary());
+                case dSocket::AssignType::Leaved: // recvAll중에 오므로 수신분과 함께 처리
+                    mLeaved.push_back(id);
                     break;
                 }
-            });
+            }, mShards))
+            return false;
+        mSocket.setDelivery(mDelivery);
+        return true;
     }
 
     uint32_t numClient() const
@@ -120,34 +696,167 @@ public:
         return mSocket.count();
     }
 
-    bool sendBinary(dTelepath::TeleID tele, const dBinary& binary)
+    bool sendBinary(dTelepath::TeleID tele, dumps header, uint32_t headerlength, const dBinary& binary)
+    {
+        auto CurFraming = mFramings.find(tele);
+        if(CurFraming != mFramings.end() && CurFraming->second == Framing::Framed)
+            return mSocket.sendTo(tele, header, headerlength, binary);
+        // Hello전이나 이전 버전의 상대방에게는 메시지만 종류바이트없이
+        if(headerlength < 1 || header[0] != KindMessage)
+            return false;
+        return mSocket.sendTo(tele, header + 1, headerlength - 1, binary);
+    }
+
+    bool sendBinaryAll(dumps header, uint32_t headerlength, const dBinary& binary)
+    {
+        // Entrance가 오기전의 상대방은 Hello전이므로 아는 상대방에게만
+        takeEntered();
+        uint32_t Count = mSocket.sendSome(mFramedTeles.data(), (uint32_t) mFramedTeles.size(), header, headerlength, binary);
+        if(0 < headerlength && header[0] == KindMessage && !mRawTeles.empty())
+            Count += mSocket.sendSome(mRawTeles.data(), (uint32_t) mRawTeles.size(), header + 1, headerlength - 1, binary);
+        return (Count == mFramedTeles.size() + mRawTeles.size());
+    }
+
+    uint32_t sendBinarySome(const std::vector<dTelepath::TeleID>& teles, dumps header, uint32_t headerlength, const dBinary& binary)
     {
-        return mSocket.sendTo(tele, binary, true);
+        return mSocket.sendSome(teles.data(), (uint32_t) teles.size(), header, headerlength, binary);
     }
 
-    bool sendBinaryAll(const dBinary& binary)
+    void flush()
     {
-        return mSocket.sendAll(binary, true);
+        if(mDelivery == dSocket::DeliveryType::Throughput)
+            mSocket.flush();
     }
 
-    bool nextReceive()
+    void ping()
+    {
+        mSocket.ping();
+    }
+
+    inline void setHeartbeat(uint32_t interval, uint32_t timeout)
+    {mSocket.setHeartbeat(interval, timeout);}
+
+    bool nextReceive(const RouteCB& route)
     {
         bool NeedUpdate = false;
-        mSocket.recvAll([this, &NeedUpdate](uint32_t id, const dBinary& binary)->void
+        takeEntered();
+        mSocket.recvAll([this, &NeedUpdate, &route](uint32_t id, const dBinary& binary)->void
             {
-                NeedUpdate |= mReceiveCB(id, dTelepath::ReceiveType::Message, binary);
+                // 첫 프레임이 인사한 상대방의 Hello면 실크프레임, 아니면 이전 버전
+                auto CurFraming = enterTele(id);
+                if(CurFraming->second == Framing::Pending)
+                {
+                    if(binary.length() == 9 && binary.buffer()[0] == KindHello
+                        && mSocket.peerType(id) != dSocket::PeerType::Legacy)
+                    {
+                        CurFraming->second = Framing::Framed;
+                        eraseTele(mRawTeles, id);
+                        mFramedTeles.push_back(id);
+                        mSocket.sendTo(id, binary, true); // Hello를 돌려주어 이후는 실크프레임임을 알림
+                    }
+                    else
+                    {
+                        CurFraming->second = Framing::Raw;
+                        mLegacies.push_back(id); // Hello를 모르므로 첫 프레임을 Hello로 간주(말이 없으면 expireGreetings)
+                    }
+                }
+                NeedUpdate |= route(id, binary, CurFraming->second == Framing::Framed);
             });
+        expireGreetings();
         return NeedUpdate;
     }
 
+    void takeLeaved(std::vector<dTelepath::TeleID>& leaved)
+    {
+        for(const auto iLeaved : mLeaved)
+        {
+            mFramings.erase(iLeaved);
+            mGreetings.erase(std::remove_if(mGreetings.begin(), mGreetings.end(),
+                [iLeaved](const std::pair<uint64_t, dTelepath::TeleID>& greeting)->bool
+                {return greeting.second == iLeaved;}), mGreetings.end()); // TeleID는 재사용됨
+            eraseTele(mFramedTeles, iLeaved);
+            eraseTele(mRawTeles, iLeaved);
+        }
+        leaved.insert(leaved.end(), mLeaved.begin(), mLeaved.end());
+        mLeaved.clear();
+    }
+
+    void takeLegacies(std::vector<dTelepath::TeleID>& legacies)
+    {
+        legacies.insert(legacies.end(), mLegacies.begin(), mLegacies.end());
+        mLegacies.clear();
+    }
+
+private:
+    enum {GreetMsec = 1000}; // 첫 프레임이 이만큼 없으면 먼저 말하지 않는 이전 버전의 클라이언트
+    enum class Framing : uint8_t {Pending, Raw, Framed};
+
+    void takeEntered()
+    {
+        // Hello전까지는 이전 버전처럼 종류바이트없이 보냄
+        mEnteredMutex.lock();
+        for(const auto iEntered : mEntered)
+            enterTele(iEntered);
+        mEntered.clear();
+        mEnteredMutex.unlock();
+    }
+
+    std::map<dTelepath::TeleID, Framing>::iterator enterTele(dTelepath::TeleID tele)
+    {
+        // Entrance보다 수신이 먼저 올 수 있으므로 양쪽에서 등록
+        auto Result = mFramings.emplace(tele, Framing::Pending);
+        if(Result.second)
+        {
+            mRawTeles.push_back(tele);
+            mGreetings.emplace_back(nowMsec() + GreetMsec, tele);
+        }
+        return Result.first;
+    }
+
+    void expireGreetings()
+    {
+        // 수신을 모두 분류한 후에도 인사가 없으면 이전 버전으로 확정하여 Connected
+        const uint64_t NowMsec = nowMsec();
+        while(!mGreetings.empty() && mGreetings.front().first <= NowMsec)
+        {
+            auto CurFraming = mFramings.find(mGreetings.front().second);
+            if(CurFraming != mFramings.end() && CurFraming->second == Framing::Pending)
+            {
+                CurFraming->second = Framing::Raw;
+                mLegacies.push_back(CurFraming->first);
+            }
+            mGreetings.pop_front();
+        }
+    }
+
+    static void eraseTele(std::vector<dTelepath::TeleID>& teles, dTelepath::TeleID tele)
+    {
+        auto CurTele = std::find(teles.begin(), teles.end(), tele);
+        if(CurTele != teles.end())
+        {
+            *CurTele = teles.back();
+            teles.pop_back();
+        }
+    }
+
 public:
     inline uint16_t port() const
     {return mSavedPort;}
+    inline const dTelepath::ReceiveCB& receiveCB() const
+    {return mReceiveCB;}
+    inline void setReceiveCB(dTelepath::ReceiveCB cb)
+    {mReceiveCB = cb;}
+    inline uint32_t queued() const
+    {return mSocket.queued();}
+    inline uint32_t latency() const
+    {return mSocket.latency();}
 
 DD_escaper_alone(TeleServerP):
     void _init_(InitType)
     {
         mReceiveCB = nullptr;
+        mDelivery = dSocket::DeliveryType::Normal;
+        mShards = 0;
         mSavedPort = 0;
     }
     void _quit_()
@@ -157,134 +866,450 @@ DD_escaper_alone(TeleServerP):
     {
         mSocket = DD_rvalue(rhs.mSocket);
         mReceiveCB = DD_rvalue(rhs.mReceiveCB);
+        mDelivery = DD_rvalue(rhs.mDelivery);
+        mShards = DD_rvalue(rhs.mShards);
         mSavedPort = DD_rvalue(rhs.mSavedPort);
+        mLeaved = DD_rvalue(rhs.mLeaved);
+        mLegacies = DD_rvalue(rhs.mLegacies);
+        mEnteredMutex = DD_rvalue(rhs.mEnteredMutex);
+        mEntered = DD_rvalue(rhs.mEntered);
+        mFramings = DD_rvalue(rhs.mFramings);
+        mGreetings = DD_rvalue(rhs.mGreetings);
+        mFramedTeles = DD_rvalue(rhs.mFramedTeles);
+        mRawTeles = DD_rvalue(rhs.mRawTeles);
     }
     void _copy_(const _self_& rhs)
     {
         mSocket = rhs.mSocket;
         mReceiveCB = rhs.mReceiveCB;
+        mDelivery = rhs.mDelivery;
+        mShards = rhs.mShards;
         mSavedPort = rhs.mSavedPort;
+        mLeaved = rhs.mLeaved;
+        mLegacies = rhs.mLegacies;
+        mEntered = rhs.mEntered;
+        mFramings = rhs.mFramings;
+        mGreetings = rhs.mGreetings;
+        mFramedTeles = rhs.mFramedTeles;
+        mRawTeles = rhs.mRawTeles;
     }
     dSocket mSocket;
     dTelepath::ReceiveCB mReceiveCB;
+    dSocket::DeliveryType mDelivery;
+    uint32_t mShards;
     uint16_t mSavedPort;
+    std::vector<dTelepath::TeleID> mLeaved; // 끊겨서 Disconnected를 기다리는 상대
+    std::vector<dTelepath::TeleID> mLegacies; // 첫 프레임이나 인사기한으로 Connected를 기다리는 이전 버전의 상대
+    dMutex mEnteredMutex; // 샤드가 있으면 Entrance는 I/O스레드에서 옴
+    std::vector<dTelepath::TeleID> mEntered;
+    std::map<dTelepath::TeleID, Framing> mFramings; // 상대방별 첫 프레임으로 정한 프레임방식
+    std::deque<std::pair<uint64_t, dTelepath::TeleID>> mGreetings; // 첫 프레임을 기다리는 상대방(기한순)
+    std::vector<dTelepath::TeleID> mFramedTeles; // Hello를 보낸 상대방
+    std::vector<dTelepath::TeleID> mRawTeles; // Hello전이거나 이전 버전인 상대방
 
 public:
-    DD_passage_alone(TeleServerP, dTelepath::ReceiveCB cb)
+    DD_passage_alone(TeleServerP, dTelepath::ReceiveCB cb, dSocket::DeliveryType delivery, uint32_t shards)
     {
         mReceiveCB = cb;
+        mDelivery = delivery;
+        mShards = shards;
         mSavedPort = 0;
     }
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// ■ TeleGateClientP
-class TeleGateClientP
+// ■ TeleWorkerP
+class TeleWorkerP
 {
 public:
-    TeleGateClientP()
-    {
-        mLastSilk = -1;
-    }
-    ~TeleGateClientP()
-    {
-    }
+    typedef std::function<bool()> TaskCB;
 
 public:
-    inline TeleClientP& gate()
-    {return mGate;}
-
-    void sendToGate_Node(dTelepath::onMarkInCB cb)
-    {
-        dZoker NewZoker;
-        NewZoker("type").setString("node");
-        NewZoker("id").setString(dString(cb((int32_t) dTeleApi::MarkInType::EntityUuid), -1));
-        mGate.sendBinary(NewZoker.build());
-    }
-
-    void sendToGate_AddSilk(dTelepath::SilkID silk)
+    TeleWorkerP(uint32_t count)
     {
-        dZoker NewZoker;
-        NewZoker("type").setString("connect_add");
-        NewZoker("id").setInt32(silk);
-
-        auto CurSilk = mSilks.find(silk);
-        if(CurSilk != mSilks.end())
-        {
-            NewZoker("entry").setString(dString((CurSilk->second.mType == dTelepath::SilkType::Server)? "server" : "client"));
-            NewZoker("protocol").setString(CurSilk->second.mProtocol);
-            if(CurSilk->second.mType == dTelepath::SilkType::Server)
-                NewZoker("port").setUint16(CurSilk->second.mSocket.mServer->port());
-        }
-        mGate.sendBinary(NewZoker.build());
+        mNeedUpdate = false;
+        for(uint32_t i = 0; i < count; ++i)
+            mLanes.push_back(new Lane(this));
     }
-
-    void sendToGate_SubSilk(dTelepath::SilkID silk)
+    ~TeleWorkerP()
     {
-        dZoker NewZoker;
-        NewZoker("type").setString("connect_sub");
-        NewZoker("id").setInt32(silk);
-        mGate.sendBinary(NewZoker.build());
+        for(auto iLane : mLanes)
+            delete iLane; // 남은 작업까지 처리후 종료
     }
 
-    void sendToGate_AddAllSilks()
+public:
+    void post(uint32_t key, TaskCB task)
     {
-        for(const auto& iSilk : mSilks)
-            sendToGate_AddSilk(iSilk.first);
+        // 같은 key는 항상 같은 레인에서 순서대로 처리
+        mLanes[key % mLanes.size()]->push(DD_rvalue(task));
     }
 
-    void sendToGate_Toast(dLiteral text)
+    void waitIdle()
     {
-        dZoker NewZoker;
-        NewZoker("type").setString("toast");
-        NewZoker("text").setString(text);
-        mGate.sendBinary(NewZoker.build());
+        for(auto iLane : mLanes)
+            iLane->waitIdle();
     }
 
-    void sendToGate_SilkFlush(int32_t silk, uint32_t amount, bool all)
+    bool takeNeedUpdate()
     {
-        dZoker NewZoker;
-        NewZoker("type").setString("silk_flush");
-        NewZoker("slik").setInt32(silk);
-        NewZoker("amount").setUint32(amount);
-        NewZoker("all").setUint8(all);
-        mGate.sendBinary(NewZoker.build());
+        return mNeedUpdate.exchange(false);
     }
 
-public:
-    class Silk
+private:
+    class Lane
     {
     public:
-        void initServer(dTelepath::ReceiveCB cb)
+        Lane(TeleWorkerP* owner)
         {
-            DD_assert(mSocket.mAny == nullptr, "you have called a method at the wrong timing.");
-            mSocket.mServer = new TeleServerP(cb);
-            for(int port = 61012; !mSocket.mServer->bindTo(port); ++port);
+            mQuit = false;
+            mBusy = false;
+            mThread = std::thread([this, owner]()->void
+                {
+                    std::unique_lock<std::mutex> Lock(mMutex);
+                    while(true)
+                    {
+                        mWakeUp.wait(Lock, [this]()->bool {return mQuit || !mTasks.empty();});
+                        if(mTasks.empty())
+                            break;
+                        std::deque<TaskCB> CurTasks;
+                        CurTasks.swap(mTasks);
+                        mBusy = true;
+                        Lock.unlock();
+                        for(auto& iTask : CurTasks)
+                            if(iTask())
+                                owner->mNeedUpdate = true;
+                        Lock.lock();
+                        mBusy = false;
+                        if(mTasks.empty())
+                            mIdle.notify_all();
+                    }
+                });
         }
-
-        void initClient(dTelepath::ReceiveCB cb)
+        ~Lane()
         {
-            DD_assert(mSocket.mAny == nullptr, "you have called a method at the wrong timing.");
-            mSocket.mClient = new TeleClientP(cb);
+            mMutex.lock();
+            mQuit = true;
+            mMutex.unlock();
+            mWakeUp.notify_one();
+            mThread.join();
         }
 
-    DD_escaper_alone(Silk):
-        void _init_(InitType)
+    public:
+        void push(TaskCB task)
         {
-            mType = dTelepath::SilkType::Server;
-            mSocket.mAny = nullptr;
+            mMutex.lock();
+            mTasks.push_back(DD_rvalue(task));
+            mMutex.unlock();
+            mWakeUp.notify_one();
         }
-        void _quit_()
+
+        void waitIdle()
         {
-            if(mType == dTelepath::SilkType::Server)
-                delete mSocket.mServer;
-            else delete mSocket.mClient;
+            std::unique_lock<std::mutex> Lock(mMutex);
+            mIdle.wait(Lock, [this]()->bool {return mTasks.empty() && !mBusy;});
         }
-        void _move_(_self_&& rhs)
-        {
-            mType = DD_rvalue(rhs.mType);
+
+    private:
+        std::mutex mMutex;
+        std::condition_variable mWakeUp;
+        std::condition_variable mIdle;
+        std::deque<TaskCB> mTasks;
+        bool mQuit;
+        bool mBusy;
+        std::thread mThread;
+    };
+
+private:
+    std::vector<Lane*> mLanes;
+    std::atomic<bool> mNeedUpdate;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ TeleGateClientP
+class TeleGateClientP
+{
+public:
+    TeleGateClientP()
+    {
+        mLastSilk = -1;
+        mStatsInterval = 1000;
+        mStatsNextMsec = 0;
+        mWorkers = nullptr;
+        mOutboxLimit = 0x100000;
+        mServerShards = 0;
+        mWorkerHost = this;
+        mGateWire = 0;
+    }
+    ~TeleGateClientP()
+    {
+        if(mWorkerHost != this)
+            unshareWorkers();
+        for(auto iGuest : mGuests)
+            iGuest->mWorkerHost = iGuest; // 남은 손님은 워커없이 홀로서기
+        delete mWorkers;
+    }
+
+public:
+    inline TeleClientP& gate()
+    {return mGate;}
+    inline uint8_t gateWire() const
+    {return mGateWire;}
+
+    // 게이트가 Hello로 수락한 바이너리 프로토콜(재접속하면 다시 zoke부터)
+    inline void acceptGate(uint8_t version)
+    {mGateWire = std::min<uint8_t>(version, dTeleGate::Version);}
+    inline void resetGate()
+    {mGateWire = 0;}
+
+    // 게이트메시지는 재사용하는 버퍼에 바로 기록해서 발송(zoke는 key의 오름차순으로)
+    void sendToGate_Frame(dTeleGate::OpType type, const void* fields, uint32_t size, utf8s_nn tail = nullptr, int32_t length = -1)
+    {
+        uint32_t Length = dTeleGate::buildInto(mGateFrame.data(), (uint32_t) mGateFrame.size(), type, fields, size, tail, length);
+        if(mGateFrame.size() < Length)
+        {
+            mGateFrame.resize(Length);
+            dTeleGate::buildInto(mGateFrame.data(), Length, type, fields, size, tail, length);
+        }
+        gate().sendBinary(mGateFrame.data(), Length, dBinary());
+    }
+
+    void sendToGate_Zoke()
+    {
+        gate().sendBinary(mGateWriter.buffer(), mGateWriter.length(), dBinary());
+    }
+
+    void sendToGate_Node(dTelepath::onMarkInCB cb)
+    {
+        utf8s Uuid = cb((int32_t) dTeleApi::MarkInType::EntityUuid);
+        if(gateWire())
+        {
+            sendToGate_Frame(dTeleGate::OpType::Node, nullptr, 0, Uuid);
+            return;
+        }
+        GateNodeP::Writer NewNode;
+        NewNode.component = DD_TELE_COMPONENT_VER; // 바이너리 프로토콜의 제안
+        NewNode.gate = dTeleGate::Version;
+        NewNode.id = Uuid;
+        NewNode.type = "node";
+        mGateWriter.reset();
+        NewNode.write(mGateWriter);
+        sendToGate_Zoke();
+    }
+
+    void sendToGate_AddSilk(dTelepath::SilkID silk)
+    {
+        if(gateWire())
+        {
+            auto CurSilk = mSilks.find(silk);
+            if(CurSilk == mSilks.end())
+                return;
+            dTeleGate::ConnectAdd Fields;
+            Fields.mID = silk;
+            Fields.mEntry = (CurSilk->second.mType == dTelepath::SilkType::Server)?
+                dTeleGate::EntryType::Server : dTeleGate::EntryType::Client;
+            Fields.mPort = (CurSilk->second.mType == dTelepath::SilkType::Server)?
+                CurSilk->second.mSocket.mServer->port() : 0;
+            sendToGate_Frame(dTeleGate::OpType::ConnectAdd, &Fields, sizeof(Fields),
+                CurSilk->second.mProtocol.string(), CurSilk->second.mProtocol.length());
+            return;
+        }
+        auto CurSilk = mSilks.find(silk);
+        const bool HasSilk = (CurSilk != mSilks.end());
+        const bool IsServer = (HasSilk && CurSilk->second.mType == dTelepath::SilkType::Server);
+        mGateWriter.reset();
+        mGateWriter.beginNameable((!HasSilk)? 2 : (IsServer)? 5 : 4);
+        if(HasSilk)
+            mGateWriter.key("entry").setString((IsServer)? "server" : "client");
+        mGateWriter.key("id").setInt32(silk);
+        if(IsServer)
+            mGateWriter.key("port").setUint16(CurSilk->second.mSocket.mServer->port());
+        if(HasSilk)
+            mGateWriter.key("protocol").setString(CurSilk->second.mProtocol.string(), CurSilk->second.mProtocol.length());
+        mGateWriter.key("type").setString("connect_add");
+        mGateWriter.endGroup();
+        sendToGate_Zoke();
+    }
+
+    void sendToGate_SubSilk(dTelepath::SilkID silk)
+    {
+        if(gateWire())
+        {
+            const dTeleGate::ConnectSub Fields = {silk};
+            sendToGate_Frame(dTeleGate::OpType::ConnectSub, &Fields, sizeof(Fields));
+            return;
+        }
+        GateSilkP::Writer NewSilk;
+        NewSilk.id = silk;
+        NewSilk.type = "connect_sub";
+        mGateWriter.reset();
+        NewSilk.write(mGateWriter);
+        sendToGate_Zoke();
+    }
+
+    void sendToGate_AddAllSilks()
+    {
+        for(const auto& iSilk : mSilks)
+            sendToGate_AddSilk(iSilk.first);
+    }
+
+    void sendToGate_Toast(dLiteral text)
+    {
+        if(gateWire())
+        {
+            sendToGate_Frame(dTeleGate::OpType::Toast, nullptr, 0, text.string(), text.length());
+            return;
+        }
+        mGateWriter.reset();
+        mGateWriter.beginNameable(2);
+        mGateWriter.key("text").setString(text);
+        mGateWriter.key("type").setString("toast");
+        mGateWriter.endGroup();
+        sendToGate_Zoke();
+    }
+
+    void sendToGate_SilkStats()
+    {
+        std::vector<dTeleGate::SilkStat>& Reports = mGateReports;
+        Reports.clear();
+        for(auto& iSilk : mSilks)
+        {
+            // 지난 보고이후의 델타만 전달
+            SilkCounterP& Counter = *iSilk.second.mCounter;
+            const uint64_t Messages = Counter.mSentMessages.load(std::memory_order_relaxed);
+            const uint64_t Bytes = Counter.mSentBytes.load(std::memory_order_relaxed);
+            const uint64_t Failures = Counter.mFailures.load(std::memory_order_relaxed);
+            if(Messages == Counter.mReportedMessages && Failures == Counter.mReportedFailures)
+                continue;
+
+            const dTelepath::SilkStats CurStats = stats(iSilk.second);
+            dTeleGate::SilkStat NewReport;
+            NewReport.mID = iSilk.first;
+            NewReport.mMessages = Messages - Counter.mReportedMessages;
+            NewReport.mBytes = Bytes - Counter.mReportedBytes;
+            NewReport.mFailures = Failures - Counter.mReportedFailures;
+            NewReport.mQueued = CurStats.mQueued;
+            NewReport.mLatency = CurStats.mLatency;
+            Reports.push_back(NewReport);
+            Counter.mReportedMessages = Messages;
+            Counter.mReportedBytes = Bytes;
+            Counter.mReportedFailures = Failures;
+        }
+        if(Reports.empty())
+            return;
+
+        if(gateWire())
+        {
+            sendToGate_Frame(dTeleGate::OpType::SilkStats,
+                Reports.data(), uint32_t(sizeof(dTeleGate::SilkStat) * Reports.size()));
+            return;
+        }
+        mGateWriter.reset();
+        mGateWriter.beginNameable(2);
+        mGateWriter.key("silks").beginIndexable((uint32_t) Reports.size());
+        for(const auto& iReport : Reports)
+        {
+            mGateWriter.beginNameable(6);
+            mGateWriter.key("bytes").setUint64(iReport.mBytes);
+            mGateWriter.key("failures").setUint64(iReport.mFailures);
+            mGateWriter.key("id").setInt32(iReport.mID);
+            mGateWriter.key("latency").setUint32(iReport.mLatency);
+            mGateWriter.key("messages").setUint64(iReport.mMessages);
+            mGateWriter.key("queued").setUint32(iReport.mQueued);
+            mGateWriter.endGroup();
+        }
+        mGateWriter.endGroup();
+        mGateWriter.key("type").setString("silk_stats");
+        mGateWriter.endGroup();
+        sendToGate_Zoke();
+    }
+
+public:
+    // 한 프로세스의 여러 컴포넌트가 워커를 공유(게이트에는 컴포넌트마다 따로 연결)
+    void shareWorkers(TeleGateClientP* host)
+    {
+        DD_assert(host != this && host->mWorkerHost == host && mGuests.empty(), "you have called a method at the wrong timing.");
+        if(mWorkerHost != this)
+            unshareWorkers();
+        delete mWorkers;
+        mWorkers = nullptr;
+        mWorkerHost = host;
+        host->mGuests.push_back(this);
+    }
+
+    void unshareWorkers()
+    {
+        auto& Guests = mWorkerHost->mGuests;
+        Guests.erase(std::remove(Guests.begin(), Guests.end(), this), Guests.end());
+        mWorkerHost = this;
+    }
+
+public:
+    class PendingCall
+    {
+    public:
+        dTelepath::TeleID mTele;
+        dTelepath::ReplyCB mReplyCB;
+        uint64_t mDeadline;
+    };
+
+    class TopicSub
+    {
+    public:
+        std::string mTopic;
+        dTelepath::TopicCB mTopicCB; // 핫리로드중에는 nullptr(새 빌드가 subscribe로 다시 지정)
+    };
+
+    class Silk
+    {
+    public:
+        void initServer(dTelepath::ReceiveCB cb, dSocket::DeliveryType delivery, uint32_t shards)
+        {
+            DD_assert(mSocket.mAny == nullptr, "you have called a method at the wrong timing.");
+            mSocket.mServer = new TeleServerP(cb, delivery, shards);
+            for(int port = 61012; !mSocket.mServer->bindTo(port); ++port);
+        }
+
+        void initClient(dTelepath::ReceiveCB cb, dSocket::DeliveryType delivery, uint32_t outboxlimit)
+        {
+            DD_assert(mSocket.mAny == nullptr, "you have called a method at the wrong timing.");
+            mSocket.mClient = new TeleClientP(cb, delivery, outboxlimit);
+        }
+
+    DD_escaper_alone(Silk):
+        void _init_(InitType type)
+        {
+            mType = dTelepath::SilkType::Server;
+            mSocket.mAny = nullptr;
+            mCounter = (type == InitType::Create)? new SilkCounterP() : nullptr;
+            mCalleeCB = nullptr;
+            mLastCall = 0;
+            mNextDeadline = ~uint64_t(0);
+            mParked = false;
+            mLastTopic = 0;
+        }
+        void _quit_()
+        {
+            if(mType == dTelepath::SilkType::Server)
+                delete mSocket.mServer;
+            else delete mSocket.mClient;
+            delete mCounter;
+        }
+        void _move_(_self_&& rhs)
+        {
+            mType = DD_rvalue(rhs.mType);
             mProtocol = DD_rvalue(rhs.mProtocol);
             mSocket.mAny = DD_rvalue(rhs.mSocket.mAny);
+            mMutex = DD_rvalue(rhs.mMutex);
+            mCounter = DD_rvalue(rhs.mCounter);
+            mCalleeCB = DD_rvalue(rhs.mCalleeCB);
+            mLastCall = DD_rvalue(rhs.mLastCall);
+            mPendings = DD_rvalue(rhs.mPendings);
+            mNextDeadline = DD_rvalue(rhs.mNextDeadline);
+            mSessions = DD_rvalue(rhs.mSessions);
+            mParked = DD_rvalue(rhs.mParked);
+            mTopics = DD_rvalue(rhs.mTopics);
+            mTopicSubs = DD_rvalue(rhs.mTopicSubs);
+            mLastTopic = DD_rvalue(rhs.mLastTopic);
         }
         void _copy_(const _self_&)
         {
@@ -299,8 +1324,305 @@ public:
             TeleServerP* mServer;
             TeleClientP* mClient;
         } mSocket;
+        dMutex mMutex; // 소켓과 mPendings를 보호(워커스레드의 발송대비)
+        SilkCounterP* mCounter;
+        dTelepath::CallCB mCalleeCB;
+        dTelepath::CallID mLastCall;
+        std::map<dTelepath::CallID, PendingCall> mPendings;
+        uint64_t mNextDeadline; // mPendings중 가장 이른 마감시각
+        std::map<uint64_t, uint64_t> mSessions; // 서버전용, Hello로 받은 세션별 마지막 시각
+        bool mParked; // 핫리로드중 새 빌드의 addSilk를 기다림
+        TopicTrieP mTopics; // Server는 TeleID별 구독, Client는 mTopicSubs의 번호
+        std::map<uint32_t, TopicSub> mTopicSubs; // 클라이언트전용
+        uint32_t mLastTopic;
     };
 
+    Silk* findSilk(dTelepath::SilkID silk)
+    {
+        // 워커스레드에서도 호출되므로 실크의 추가/제거와 동기화
+        Silk* Result = nullptr;
+        mSilksMutex.lock();
+        {
+            auto CurSilk = mSilks.find(silk);
+            if(CurSilk != mSilks.end())
+                Result = &CurSilk->second;
+        }
+        mSilksMutex.unlock();
+        return Result;
+    }
+
+    bool sendFrame(Silk& silk, dTelepath::TeleID tele, dumps header, uint32_t headerlength, const dBinary& binary, bool all = false)
+    {
+        bool Result = false;
+        silk.mMutex.lock();
+        {
+            if(silk.mType == dTelepath::SilkType::Server)
+            {
+                if(all)
+                    Result = silk.mSocket.mServer->sendBinaryAll(header, headerlength, binary);
+                else Result = silk.mSocket.mServer->sendBinary(tele, header, headerlength, binary);
+            }
+            else Result = silk.mSocket.mClient->sendBinary(header, headerlength, binary);
+        }
+        silk.mMutex.unlock();
+        return Result;
+    }
+
+    bool dispatch(dTelepath::SilkID silk, dTelepath::TeleID tele, TeleWorkerP::TaskCB task)
+    {
+        TeleWorkerP* Workers = workers();
+        if(!Workers)
+            return task();
+        // 같은 상대의 메시지는 같은 워커에서 순서대로, 상대가 다르면 병렬로
+        Workers->post((uint32_t(silk) * 0x9E3779B1) ^ tele ^ uint32_t(uintptr_t(this) >> 4), DD_rvalue(task));
+        return false;
+    }
+
+    bool routeFrame(dTelepath::SilkID silkid, Silk& silk, dTelepath::TeleID tele, const dBinary& frame, bool framed)
+    {
+        silk.mCounter->onReceived(frame.length());
+        if(frame.length() < 1)
+            return false;
+
+        const dumps Frame = frame.buffer();
+        if(!framed || Frame[0] == KindMessage) // 이전 버전의 프레임은 통째로 메시지
+        {
+            const dTelepath::ReceiveCB* ReceiveCB = (silk.mType == dTelepath::SilkType::Server)?
+                &silk.mSocket.mServer->receiveCB() : &silk.mSocket.mClient->receiveCB();
+            const dBinary Payload = (framed)? frame.sub(1) : frame;
+            return dispatch(silkid, tele, [ReceiveCB, tele, Payload]()->bool
+                {return (*ReceiveCB)(tele, dTelepath::ReceiveType::Message, Payload);});
+        }
+        if(Frame[0] == KindHello)
+        {
+            if(frame.length() < 9 || silk.mType != dTelepath::SilkType::Server)
+                return false;
+            uint64_t Session = 0;
+            memcpy(&Session, &Frame[1], 8);
+            return onHello(silkid, silk, tele, Session);
+        }
+        if(Frame[0] == KindSubscribe || Frame[0] == KindUnsubscribe)
+        {
+            if(silk.mType != dTelepath::SilkType::Server)
+                return false;
+            silk.mMutex.lock();
+            if(Frame[0] == KindSubscribe)
+                silk.mTopics.add((utf8s_nn) &Frame[1], frame.length() - 1, tele);
+            else silk.mTopics.sub((utf8s_nn) &Frame[1], frame.length() - 1, tele);
+            silk.mMutex.unlock();
+            return false;
+        }
+        if(Frame[0] == KindPublish)
+            return onPublish(silkid, silk, frame);
+        if(frame.length() < 5)
+            return false;
+
+        dTelepath::CallID CurCall = 0;
+        memcpy(&CurCall, &Frame[1], 4);
+        switch(Frame[0])
+        {
+        case KindCall:
+            {
+                // 워커가 호출하는 동안 setCallee로 바뀔 수 있으므로 복사해서 전달
+                silk.mMutex.lock();
+                dTelepath::CallCB CalleeCB = silk.mCalleeCB;
+                silk.mMutex.unlock();
+                if(CalleeCB)
+                {
+                    const dBinary Payload = frame.sub(5);
+                    return dispatch(silkid, tele, [CalleeCB, tele, CurCall, Payload]()->bool
+                        {return CalleeCB(tele, CurCall, Payload);});
+                }
+                dump Header[5] = {KindFault};
+                memcpy(&Header[1], &CurCall, 4);
+                sendFrame(silk, tele, Header, 5, dBinary());
+            }
+            break;
+        case KindReply:
+        case KindFault:
+            {
+                dTelepath::ReplyCB ReplyCB = nullptr;
+                silk.mMutex.lock();
+                {
+                    auto CurPending = silk.mPendings.find(CurCall);
+                    if(CurPending != silk.mPendings.end() && CurPending->second.mTele == tele)
+                    {
+                        ReplyCB = DD_rvalue(CurPending->second.mReplyCB);
+                        silk.mPendings.erase(CurPending);
+                    }
+                }
+                silk.mMutex.unlock();
+                if(ReplyCB) // 없으면 이미 마감된 호출
+                {
+                    const dTelepath::ReplyType Type = (Frame[0] == KindReply)?
+                        dTelepath::ReplyType::Replied : dTelepath::ReplyType::Failed;
+                    const dBinary Payload = (Frame[0] == KindReply)? frame.sub(5) : dBinary();
+                    return dispatch(silkid, tele, [ReplyCB, Type, Payload]()->bool
+                        {return ReplyCB(Type, Payload);});
+                }
+            }
+            break;
+        }
+        return false;
+    }
+
+    bool onHello(dTelepath::SilkID silkid, Silk& silk, dTelepath::TeleID tele, uint64_t session)
+    {
+        // 아는 세션이면 재접속, 오래된 세션은 정리
+        const uint64_t NowMsec = nowMsec();
+        const bool Resumed = (silk.mSessions.find(session) != silk.mSessions.end());
+        silk.mSessions[session] = NowMsec;
+        if(1024 < silk.mSessions.size())
+        {
+            for(auto iSession = silk.mSessions.begin(); iSession != silk.mSessions.end();)
+            {
+                if(iSession->second + 10 * 60 * 1000 < NowMsec)
+                    iSession = silk.mSessions.erase(iSession);
+                else iSession++;
+            }
+        }
+        return dispatchLink(silkid, silk, tele,
+            (Resumed)? dTelepath::ReceiveType::Reconnected : dTelepath::ReceiveType::Connected);
+    }
+
+    bool onPublish(dTelepath::SilkID silkid, Silk& silk, const dBinary& frame)
+    {
+        uint16_t TopicLength = 0;
+        if(silk.mType != dTelepath::SilkType::Client || frame.length() < 3)
+            return false;
+        memcpy(&TopicLength, &frame.buffer()[1], 2);
+        if(frame.length() < 3 + uint32_t(TopicLength))
+            return false;
+
+        // 맞는 구독의 콜백마다 같은 프레임을 공유
+        std::vector<uint32_t> IDs;
+        std::vector<dTelepath::TopicCB> TopicCBs;
+        silk.mMutex.lock();
+        {
+            silk.mTopics.match((utf8s_nn) &frame.buffer()[3], TopicLength, IDs);
+            for(auto iID : IDs)
+            {
+                auto CurSub = silk.mTopicSubs.find(iID);
+                if(CurSub != silk.mTopicSubs.end() && CurSub->second.mTopicCB)
+                    TopicCBs.push_back(CurSub->second.mTopicCB);
+            }
+        }
+        silk.mMutex.unlock();
+
+        bool NeedUpdate = false;
+        for(auto& iTopicCB : TopicCBs)
+        {
+            const dTelepath::TopicCB TopicCB = DD_rvalue(iTopicCB);
+            NeedUpdate |= dispatch(silkid, 0, [TopicCB, frame, TopicLength]()->bool
+                {
+                    dString Topic;
+                    Topic.reset((utf8s_nn) &frame.buffer()[3], TopicLength);
+                    return TopicCB(Topic, frame.sub(3 + TopicLength));
+                });
+        }
+        return NeedUpdate;
+    }
+
+    bool dispatchLink(dTelepath::SilkID silkid, Silk& silk, dTelepath::TeleID tele, dTelepath::ReceiveType type)
+    {
+        const dTelepath::ReceiveCB* ReceiveCB = (silk.mType == dTelepath::SilkType::Server)?
+            &silk.mSocket.mServer->receiveCB() : &silk.mSocket.mClient->receiveCB();
+        if(!*ReceiveCB)
+            return false;
+        return dispatch(silkid, tele, [ReceiveCB, tele, type]()->bool
+            {return (*ReceiveCB)(tele, type, dBinary());});
+    }
+
+    bool dispatchLink(dTelepath::SilkID silkid, Silk& silk, TeleClientP::LinkEvent event)
+    {
+        if(event == TeleClientP::LinkEvent::None)
+            return false;
+        return dispatchLink(silkid, silk, 0, (event == TeleClientP::LinkEvent::Reconnected)?
+            dTelepath::ReceiveType::Reconnected : dTelepath::ReceiveType::Connected);
+    }
+
+    bool failCalls(dTelepath::SilkID silkid, Silk& silk, dTelepath::ReplyType type, uint64_t deadline)
+    {
+        // deadline까지 마감된 호출을 모두 정리후 콜백(콜백중의 call에 안전하도록)
+        std::vector<std::pair<dTelepath::TeleID, dTelepath::ReplyCB>> Expired;
+        silk.mMutex.lock();
+        {
+            uint64_t NextDeadline = ~uint64_t(0);
+            for(auto iPending = silk.mPendings.begin(); iPending != silk.mPendings.end();)
+            {
+                if(iPending->second.mDeadline <= deadline)
+                {
+                    Expired.push_back(std::make_pair(iPending->second.mTele, DD_rvalue(iPending->second.mReplyCB)));
+                    iPending = silk.mPendings.erase(iPending);
+                }
+                else
+                {
+                    NextDeadline = std::min(NextDeadline, iPending->second.mDeadline);
+                    iPending++;
+                }
+            }
+            silk.mNextDeadline = NextDeadline;
+        }
+        silk.mMutex.unlock();
+
+        bool NeedUpdate = false;
+        for(auto& iExpired : Expired)
+        {
+            if(const dTelepath::ReplyCB ReplyCB = DD_rvalue(iExpired.second))
+                NeedUpdate |= dispatch(silkid, iExpired.first, [ReplyCB, type]()->bool
+                    {return ReplyCB(type, dBinary());});
+        }
+        return NeedUpdate;
+    }
+
+    bool expireCalls()
+    {
+        bool NeedUpdate = false;
+        const uint64_t NowMsec = nowMsec();
+        for(auto& iSilk : mSilks)
+            if(iSilk.second.mNextDeadline <= NowMsec)
+                NeedUpdate |= failCalls(iSilk.first, iSilk.second, dTelepath::ReplyType::Timeout, NowMsec);
+        return NeedUpdate;
+    }
+
+    void linkSilk(dTelepath::SilkID silk, utf8s hostname, uint16_t port)
+    {
+        auto CurSilk = mSilks.find(silk);
+        if(CurSilk == mSilks.end() || CurSilk->second.mType != dTelepath::SilkType::Client)
+            return;
+        CurSilk->second.mMutex.lock();
+        const TeleClientP::LinkEvent Event = CurSilk->second.mSocket.mClient->linkTo(hostname, port);
+        CurSilk->second.mMutex.unlock();
+        dispatchLink(silk, CurSilk->second, Event);
+    }
+
+    void disconnectSilk(dTelepath::SilkID silk)
+    {
+        auto CurSilk = mSilks.find(silk);
+        if(CurSilk == mSilks.end() || CurSilk->second.mType != dTelepath::SilkType::Client)
+            return;
+        CurSilk->second.mMutex.lock();
+        CurSilk->second.mSocket.mClient->unlink();
+        CurSilk->second.mMutex.unlock();
+        failCalls(silk, CurSilk->second, dTelepath::ReplyType::Failed, ~uint64_t(0));
+        dispatchLink(silk, CurSilk->second, 0, dTelepath::ReceiveType::Disconnected);
+    }
+
+    bool retryForAllSilks()
+    {
+        bool NeedUpdate = false;
+        for(auto& iSilk : mSilks)
+        {
+            if(iSilk.second.mType != dTelepath::SilkType::Client)
+                continue;
+            iSilk.second.mMutex.lock();
+            const TeleClientP::LinkEvent Event = iSilk.second.mSocket.mClient->retry();
+            iSilk.second.mMutex.unlock();
+            NeedUpdate |= dispatchLink(iSilk.first, iSilk.second, Event);
+        }
+        return NeedUpdate;
+    }
+
     TeleServerP* linkedServer(dTelepath::SilkID silk)
     {
         auto CurSilk = mSilks.find(silk);
@@ -321,89 +1643,447 @@ public:
         return CurSilk->second.mSocket.mClient;
     }
 
-    bool nextReceiveForAllSilks()
+    void flushForAllSilks()
     {
-        bool NeedUpdate = false;
-        for(const auto& iSilk : mSilks)
+        for(auto& iSilk : mSilks)
+        {
+            iSilk.second.mMutex.lock();
+            if(iSilk.second.mType == dTelepath::SilkType::Server)
+                iSilk.second.mSocket.mServer->flush();
+            else iSilk.second.mSocket.mClient->flush();
+            iSilk.second.mMutex.unlock();
+        }
+    }
+
+    void pingForAllSilks()
+    {
+        for(auto& iSilk : mSilks)
         {
+            iSilk.second.mMutex.lock();
             if(iSilk.second.mType == dTelepath::SilkType::Server)
-                NeedUpdate |= iSilk.second.mSocket.mServer->nextReceive();
-            else NeedUpdate |= iSilk.second.mSocket.mClient->nextReceive();
+                iSilk.second.mSocket.mServer->ping();
+            else iSilk.second.mSocket.mClient->ping();
+            iSilk.second.mMutex.unlock();
         }
+    }
+
+    void updateStats()
+    {
+        if(mStatsInterval == 0)
+            return;
+        const uint64_t NowMsec = nowMsec();
+        if(NowMsec < mStatsNextMsec)
+            return;
+        mStatsNextMsec = NowMsec + mStatsInterval;
+        sendToGate_SilkStats();
+        pingForAllSilks(); // 다음 보고까지 왕복지연 갱신
+    }
+
+    bool nextReceiveForAllSilks()
+    {
+        bool NeedUpdate = retryForAllSilks(); // 끊긴 클라이언트의 재접속
+        flushForAllSilks(); // 틱에서 모아진 발송분
+        std::vector<std::tuple<dTelepath::TeleID, dBinary, bool>> Frames;
+        std::vector<dTelepath::TeleID> Leaved, Legacies;
+        for(auto& iSilk : mSilks)
+        {
+            // 소켓은 잠근채로 수신만 하고, 처리는 잠금없이(처리중의 발송대비)
+            Silk& CurSilk = iSilk.second;
+            const RouteCB Collect = [&Frames](dTelepath::TeleID tele, const dBinary& frame, bool framed)->bool
+                {Frames.emplace_back(tele, frame, framed); return false;};
+            TeleClientP::LinkEvent Event = TeleClientP::LinkEvent::None;
+            CurSilk.mMutex.lock();
+            if(CurSilk.mType == dTelepath::SilkType::Server)
+            {
+                CurSilk.mSocket.mServer->nextReceive(Collect);
+                CurSilk.mSocket.mServer->takeLegacies(Legacies);
+                CurSilk.mSocket.mServer->takeLeaved(Leaved);
+                for(const auto iLeaved : Leaved)
+                    CurSilk.mTopics.subAll(iLeaved);
+            }
+            else
+            {
+                Event = CurSilk.mSocket.mClient->nextReceive(Collect);
+                if(const uint32_t LostFrames = CurSilk.mSocket.mClient->takeLostFrames())
+                    CurSilk.mCounter->mFailures.fetch_add(LostFrames, std::memory_order_relaxed);
+            }
+            CurSilk.mMutex.unlock();
+
+            NeedUpdate |= dispatchLink(iSilk.first, CurSilk, Event);
+            for(const auto iLegacy : Legacies) // 같은 워커에서 첫 메시지의 앞에
+                NeedUpdate |= dispatchLink(iSilk.first, CurSilk, iLegacy, dTelepath::ReceiveType::Connected);
+            for(const auto& iFrame : Frames)
+                NeedUpdate |= routeFrame(iSilk.first, CurSilk, std::get<0>(iFrame), std::get<1>(iFrame), std::get<2>(iFrame));
+            for(const auto iLeaved : Leaved) // 같은 워커에서 남은 메시지의 뒤에
+                NeedUpdate |= dispatchLink(iSilk.first, CurSilk, iLeaved, dTelepath::ReceiveType::Disconnected);
+            Frames.clear();
+            Leaved.clear();
+            Legacies.clear();
+        }
+        NeedUpdate |= expireCalls();
+        {
+            // 워커의 콜백이 addTimer/subTimer를 호출할 수 있으므로(만료콜백 안의 재진입은 같은 스레드)
+            std::lock_guard<std::recursive_mutex> Lock(mTimersMutex);
+            NeedUpdate |= (0 < mTimers.advance());
+        }
+        if(TeleWorkerP* Workers = workers())
+            NeedUpdate |= Workers->takeNeedUpdate();
+        flushForAllSilks(); // 수신처리중에 모아진 발송분
         return NeedUpdate;
     }
 
-    dTelepath::SilkID addSilk(dTelepath::SilkType type, dLiteral protocol, dTelepath::ReceiveCB cb)
+    dTelepath::SilkID addSilk(dTelepath::SilkType type, dLiteral protocol, dTelepath::ReceiveCB cb, dTelepath::DeliveryType delivery, bool& rebound)
     {
+        // 핫리로드된 새 빌드는 같은 타입과 프로토콜의 실크를 연결째로 이어받음
+        // 빌드마다 스트링풀이 다르므로 내용으로 비교
+        for(auto& iSilk : mSilks)
+        {
+            Silk& OldSilk = iSilk.second;
+            if(OldSilk.mParked && OldSilk.mType == type && OldSilk.mProtocol.length() == protocol.length()
+                && !memcmp(OldSilk.mProtocol.string(), protocol.string(), protocol.length()))
+            {
+                OldSilk.mMutex.lock();
+                {
+                    if(type == dTelepath::SilkType::Server)
+                        OldSilk.mSocket.mServer->setReceiveCB(cb);
+                    else OldSilk.mSocket.mClient->setReceiveCB(cb);
+                    OldSilk.mCalleeCB = nullptr; // 새 빌드가 setCallee로 다시 지정
+                    for(auto& iSub : OldSilk.mTopicSubs) // 구독은 유지하고 콜백만 새 빌드가 subscribe로 다시 지정
+                        iSub.second.mTopicCB = nullptr;
+                    OldSilk.mParked = false;
+                }
+                OldSilk.mMutex.unlock();
+                rebound = true;
+                return iSilk.first;
+            }
+        }
+        rebound = false;
+
+        mSilksMutex.lock();
         Silk& NewSilk = mSilks[++mLastSilk];
+        mSilksMutex.unlock();
         NewSilk.mType = type;
         NewSilk.mProtocol = protocol;
 
+        const dSocket::DeliveryType Delivery =
+            (delivery == dTelepath::DeliveryType::LowLatency)? dSocket::DeliveryType::LowLatency :
+            (delivery == dTelepath::DeliveryType::Throughput)? dSocket::DeliveryType::Throughput : dSocket::DeliveryType::Normal;
         if(type == dTelepath::SilkType::Server)
-            NewSilk.initServer(cb);
-        else NewSilk.initClient(cb);
+            NewSilk.initServer(cb, Delivery, mServerShards);
+        else NewSilk.initClient(cb, Delivery, mOutboxLimit);
         return mLastSilk;
     }
 
     void subSilk(dTelepath::SilkID silk)
     {
+        auto CurSilk = mSilks.find(silk);
+        if(CurSilk == mSilks.end())
+            return;
+        failCalls(silk, CurSilk->second, dTelepath::ReplyType::Failed, ~uint64_t(0));
+        if(TeleWorkerP* Workers = workers()) // 실크를 참조하는 작업이 남지 않도록
+            Workers->waitIdle();
+        mSilksMutex.lock();
         mSilks.erase(silk);
+        mSilksMutex.unlock();
     }
 
-    uint32_t numLinkedTelepath(dTelepath::SilkID silk)
+    void parkSilks()
+    {
+        if(TeleWorkerP* Workers = workers()) // 이전 빌드의 콜백이 모두 끝나도록
+            Workers->waitIdle();
+        for(auto& iSilk : mSilks)
+            iSilk.second.mParked = true;
+        std::lock_guard<std::recursive_mutex> Lock(mTimersMutex);
+        mTimers.clear(); // 이전 빌드의 콜백이므로 새 빌드가 다시 등록
+    }
+
+    bool parkedSilk(dTelepath::SilkID silk) const
     {
         auto CurSilk = mSilks.find(silk);
-        if(CurSilk == mSilks.end())
+        return (CurSilk != mSilks.end() && CurSilk->second.mParked);
+    }
+
+    std::vector<dTelepath::SilkID> parkedSilks() const
+    {
+        std::vector<dTelepath::SilkID> Result;
+        for(const auto& iSilk : mSilks)
+            if(iSilk.second.mParked)
+                Result.push_back(iSilk.first);
+        return Result;
+    }
+
+    uint32_t numLinkedTelepath(dTelepath::SilkID silk)
+    {
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk)
             return 0;
-        if(CurSilk->second.mType == dTelepath::SilkType::Server)
-            return CurSilk->second.mSocket.mServer->numClient();
-        return CurSilk->second.mSocket.mClient->isConnected()? 1 : 0;
+        if(CurSilk->mType == dTelepath::SilkType::Server)
+            return CurSilk->mSocket.mServer->numClient();
+        return CurSilk->mSocket.mClient->isConnected()? 1 : 0;
     }
 
-    bool send(dTelepath::SilkID silk, dTelepath::TeleID tele, const dBinary& binary)
+    bool send(dTelepath::SilkID silk, dTelepath::TeleID tele, const dBinary& binary, bool all)
     {
-        auto CurSilk = mSilks.find(silk);
-        if(CurSilk == mSilks.end())
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk)
             return false;
-        if(CurSilk->second.mType == dTelepath::SilkType::Server)
-            return CurSilk->second.mSocket.mServer->sendBinary(tele, binary);
-        return CurSilk->second.mSocket.mClient->sendBinary(binary);
+        const dump Header[1] = {KindMessage};
+        const bool Result = sendFrame(*CurSilk, tele, Header, 1, binary, all);
+        CurSilk->mCounter->onSent(binary.length(), Result);
+        return Result;
     }
 
-    bool sendAll(dTelepath::SilkID silk, const dBinary& binary)
+    dTelepath::CallID call(dTelepath::SilkID silk, dTelepath::TeleID tele, const dBinary& binary, dTelepath::ReplyCB cb, uint32_t timeout)
     {
-        auto CurSilk = mSilks.find(silk);
-        if(CurSilk == mSilks.end())
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk)
+            return 0;
+
+        // 회신이 발송직후에 도착할 수 있으므로 먼저 등록
+        dTelepath::CallID NewCall = 0;
+        CurSilk->mMutex.lock();
+        {
+            if(++CurSilk->mLastCall == 0) // 0은 실패용
+                ++CurSilk->mLastCall;
+            NewCall = CurSilk->mLastCall;
+            PendingCall& NewPending = CurSilk->mPendings[NewCall];
+            NewPending.mTele = (CurSilk->mType == dTelepath::SilkType::Server)? tele : 0;
+            NewPending.mReplyCB = cb;
+            NewPending.mDeadline = nowMsec() + timeout;
+            CurSilk->mNextDeadline = std::min(CurSilk->mNextDeadline, NewPending.mDeadline);
+        }
+        CurSilk->mMutex.unlock();
+
+        dump Header[5] = {KindCall};
+        memcpy(&Header[1], &NewCall, 4);
+        const bool Result = sendFrame(*CurSilk, tele, Header, 5, binary);
+        CurSilk->mCounter->onSent(binary.length(), Result);
+        if(!Result)
+        {
+            CurSilk->mMutex.lock();
+            CurSilk->mPendings.erase(NewCall);
+            CurSilk->mMutex.unlock();
+            return 0;
+        }
+        return NewCall;
+    }
+
+    void setCallee(dTelepath::SilkID silk, dTelepath::CallCB cb)
+    {
+        if(Silk* CurSilk = findSilk(silk))
+        {
+            CurSilk->mMutex.lock();
+            CurSilk->mCalleeCB = cb;
+            CurSilk->mMutex.unlock();
+        }
+    }
+
+    bool reply(dTelepath::SilkID silk, dTelepath::TeleID tele, dTelepath::CallID call, const dBinary& binary)
+    {
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk)
             return false;
-        if(CurSilk->second.mType == dTelepath::SilkType::Server)
-            return CurSilk->second.mSocket.mServer->sendBinaryAll(binary);
-        return CurSilk->second.mSocket.mClient->sendBinary(binary);
+        dump Header[5] = {KindReply};
+        memcpy(&Header[1], &call, 4);
+        const bool Result = sendFrame(*CurSilk, tele, Header, 5, binary);
+        CurSilk->mCounter->onSent(binary.length(), Result);
+        return Result;
+    }
+
+    bool subscribe(dTelepath::SilkID silk, dLiteral topic, dTelepath::TopicCB cb)
+    {
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk || CurSilk->mType != dTelepath::SilkType::Client || 0xFFFF < topic.length())
+            return false;
+        const std::string Topic(topic.string(), topic.length());
+        CurSilk->mMutex.lock();
+        {
+            auto CurSub = std::find_if(CurSilk->mTopicSubs.begin(), CurSilk->mTopicSubs.end(),
+                [&Topic](const std::pair<const uint32_t, TopicSub>& sub)->bool {return sub.second.mTopic == Topic;});
+            if(CurSub != CurSilk->mTopicSubs.end()) // 같은 토픽은 콜백만 교체
+                CurSub->second.mTopicCB = cb;
+            else
+            {
+                TopicSub& NewSub = CurSilk->mTopicSubs[++CurSilk->mLastTopic];
+                NewSub.mTopic = Topic;
+                NewSub.mTopicCB = cb;
+                CurSilk->mTopics.add(Topic.c_str(), (uint32_t) Topic.length(), CurSilk->mLastTopic);
+                CurSilk->mSocket.mClient->sendTopic(true, Topic);
+            }
+        }
+        CurSilk->mMutex.unlock();
+        return true;
+    }
+
+    void unsubscribe(dTelepath::SilkID silk, dLiteral topic)
+    {
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk || CurSilk->mType != dTelepath::SilkType::Client)
+            return;
+        const std::string Topic(topic.string(), topic.length());
+        CurSilk->mMutex.lock();
+        {
+            auto CurSub = std::find_if(CurSilk->mTopicSubs.begin(), CurSilk->mTopicSubs.end(),
+                [&Topic](const std::pair<const uint32_t, TopicSub>& sub)->bool {return sub.second.mTopic == Topic;});
+            if(CurSub != CurSilk->mTopicSubs.end())
+            {
+                CurSilk->mTopics.sub(Topic.c_str(), (uint32_t) Topic.length(), CurSub->first);
+                CurSilk->mTopicSubs.erase(CurSub);
+                CurSilk->mSocket.mClient->sendTopic(false, Topic);
+            }
+        }
+        CurSilk->mMutex.unlock();
+    }
+
+    uint32_t publish(dTelepath::SilkID silk, dLiteral topic, const dBinary& binary)
+    {
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk || CurSilk->mType != dTelepath::SilkType::Server || 0xFFFF < topic.length())
+            return 0;
+
+        // 프레임은 한번만 만들어서 모든 구독자에게 공유
+        const dump Kind = KindPublish;
+        const uint16_t TopicLength = (uint16_t) topic.length();
+        dBinary Header;
+        Header.add(&Kind, 1).add((dumps) &TopicLength, 2).add((dumps) topic.string(), TopicLength);
+
+        std::vector<dTelepath::TeleID> Subscribers;
+        uint32_t Result = 0;
+        CurSilk->mMutex.lock();
+        {
+            CurSilk->mTopics.match(topic.string(), TopicLength, Subscribers);
+            if(!Subscribers.empty())
+                Result = CurSilk->mSocket.mServer->sendBinarySome(Subscribers, Header.buffer(), Header.length(), binary);
+        }
+        CurSilk->mMutex.unlock();
+        if(!Subscribers.empty()) // sendAll처럼 1회로 계산
+            CurSilk->mCounter->onSent(binary.length(), Result == Subscribers.size());
+        return Result;
+    }
+
+    dTelepath::SilkStats stats(dTelepath::SilkID silk)
+    {
+        dTelepath::SilkStats Result = {};
+        if(Silk* CurSilk = findSilk(silk))
+            Result = stats(*CurSilk);
+        return Result;
     }
 
+    dTelepath::SilkStats stats(Silk& silk)
+    {
+        dTelepath::SilkStats Result = {};
+        const SilkCounterP& Counter = *silk.mCounter;
+        Result.mSentMessages = Counter.mSentMessages.load(std::memory_order_relaxed);
+        Result.mSentBytes = Counter.mSentBytes.load(std::memory_order_relaxed);
+        Result.mRecvMessages = Counter.mRecvMessages.load(std::memory_order_relaxed);
+        Result.mRecvBytes = Counter.mRecvBytes.load(std::memory_order_relaxed);
+        Result.mFailures = Counter.mFailures.load(std::memory_order_relaxed);
+        silk.mMutex.lock();
+        if(silk.mType == dTelepath::SilkType::Server)
+        {
+            Result.mQueued = silk.mSocket.mServer->queued();
+            Result.mLatency = silk.mSocket.mServer->latency();
+        }
+        else
+        {
+            Result.mQueued = silk.mSocket.mClient->queued();
+            Result.mLatency = silk.mSocket.mClient->latency();
+        }
+        silk.mMutex.unlock();
+        return Result;
+    }
+
+    inline void setStatsInterval(uint32_t msec)
+    {
+        mStatsInterval = msec;
+        mStatsNextMsec = 0;
+    }
+
+    void setOutboxLimit(uint32_t limit)
+    {
+        mOutboxLimit = limit;
+        for(auto& iSilk : mSilks)
+        {
+            if(iSilk.second.mType != dTelepath::SilkType::Client)
+                continue;
+            iSilk.second.mMutex.lock();
+            iSilk.second.mSocket.mClient->setOutboxLimit(limit);
+            iSilk.second.mMutex.unlock();
+        }
+    }
+
+    void setWorkers(uint32_t count)
+    {
+        TeleGateClientP* Host = mWorkerHost; // 손님은 주인의 워커를 교체
+        delete Host->mWorkers; // 남은 작업까지 처리후 교체
+        Host->mWorkers = (0 < count)? new TeleWorkerP(count) : nullptr;
+    }
+
+    inline void setServerShards(uint32_t count)
+    {mServerShards = count;}
+
+    void setHeartbeat(dTelepath::SilkID silk, uint32_t interval, uint32_t timeout)
+    {
+        Silk* CurSilk = findSilk(silk);
+        if(!CurSilk)
+            return;
+        CurSilk->mMutex.lock();
+        if(CurSilk->mType == dTelepath::SilkType::Server)
+            CurSilk->mSocket.mServer->setHeartbeat(interval, timeout);
+        else CurSilk->mSocket.mClient->setHeartbeat(interval, timeout);
+        CurSilk->mMutex.unlock();
+    }
+
+    inline dTelepath::TimerID addTimer(uint32_t msec, dTelepath::TimerCB cb)
+    {std::lock_guard<std::recursive_mutex> Lock(mTimersMutex); return mTimers.start(msec, cb);}
+    inline void subTimer(dTelepath::TimerID timer)
+    {std::lock_guard<std::recursive_mutex> Lock(mTimersMutex); mTimers.stop(timer);}
+
+private:
+    inline TeleWorkerP* workers() const
+    {return mWorkerHost->mWorkers;}
+
 private:
     TeleClientP mGate;
     dTelepath::SilkID mLastSilk;
     std::map<dTelepath::SilkID, Silk> mSilks;
+    dMutex mSilksMutex; // 메인스레드의 mSilks변경과 워커스레드의 검색간 동기화
+    uint32_t mStatsInterval;
+    uint64_t mStatsNextMsec;
+    TeleWorkerP* mWorkers;
+    uint32_t mOutboxLimit;
+    uint32_t mServerShards;
+    TeleGateClientP* mWorkerHost; // 워커의 주인(손님이 아니면 this)
+    std::vector<TeleGateClientP*> mGuests;
+    uint8_t mGateWire; // 게이트와 합의한 바이너리 프로토콜버전(0이면 zoke)
+    dZokeWriter mGateWriter; // 게이트메시지용(메시지마다 재사용)
+    std::vector<dump> mGateFrame;
+    std::vector<dTeleGate::SilkStat> mGateReports;
+    dTimerWheel mTimers; // 컴포넌트의 타이머(nextReceive에서 진행)
+    std::recursive_mutex mTimersMutex; // 워커에서의 addTimer/subTimer용
 };
 
 static TeleGateClientP* gLastClient = nullptr;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ dTelepath
-dTelepath::SilkID dTelepath::addSilk(SilkType type, dLiteral protocol, ReceiveCB cb)
+dTelepath::SilkID dTelepath::addSilk(SilkType type, dLiteral protocol, ReceiveCB cb, DeliveryType delivery)
 {
-    const SilkID NewSilk = gLastClient->addSilk(type, protocol, cb);
-    printf("[daddy] dTelepath.addSilk(%s, %.*s) ---> %d\n",
+    bool Rebound = false;
+    const SilkID NewSilk = gLastClient->addSilk(type, protocol, cb, delivery, Rebound);
+    printf("[daddy] dTelepath.addSilk(%s, %.*s) ---> %d%s\n",
         (type == SilkType::Server)? "Server" : "Client",
-        protocol.length(), protocol.string(), NewSilk);
+        protocol.length(), protocol.string(), NewSilk, (Rebound)? " (rebound)" : "");
 
-    if(gLastClient->gate().isConnected())
+    if(!Rebound && gLastClient->gate().isConnected())
         gLastClient->sendToGate_AddSilk(NewSilk);
     return NewSilk;
 }
 
 void dTelepath::subSilk(SilkID silk)
 {
+    if(gLastClient->parkedSilk(silk)) // 이전 빌드의 Destroy가 새 빌드의 몫을 지우지 않도록
+        return;
     gLastClient->subSilk(silk);
     printf("[daddy] dTelepath.subSilk(%d)\n", silk);
 
@@ -418,16 +2098,84 @@ uint32_t dTelepath::numLinkedTelepath(SilkID silk)
 
 bool dTelepath::send(SilkID silk, TeleID tele, const dBinary binary)
 {
-    bool Result = gLastClient->send(silk, tele, binary);
-    gLastClient->sendToGate_SilkFlush(silk, binary.length(), false);
-    return Result;
+    return gLastClient->send(silk, tele, binary, false);
 }
 
 bool dTelepath::sendAll(SilkID silk, const dBinary binary)
 {
-    bool Result = gLastClient->sendAll(silk, binary);
-    gLastClient->sendToGate_SilkFlush(silk, binary.length(), true);
-    return Result;
+    return gLastClient->send(silk, 0, binary, true);
+}
+
+dTelepath::SilkStats dTelepath::stats(SilkID silk)
+{
+    return gLastClient->stats(silk);
+}
+
+void dTelepath::setStatsInterval(uint32_t msec)
+{
+    gLastClient->setStatsInterval(msec);
+}
+
+void dTelepath::setOutboxLimit(uint32_t bytes)
+{
+    gLastClient->setOutboxLimit(bytes);
+}
+
+void dTelepath::setWorkers(uint32_t count)
+{
+    gLastClient->setWorkers(count);
+}
+
+void dTelepath::setServerShards(uint32_t count)
+{
+    gLastClient->setServerShards(count);
+}
+
+void dTelepath::setHeartbeat(SilkID silk, uint32_t interval, uint32_t timeout)
+{
+    gLastClient->setHeartbeat(silk, interval, timeout);
+}
+
+dTelepath::CallID dTelepath::call(SilkID silk, TeleID tele, const dBinary binary, ReplyCB cb, uint32_t timeout)
+{
+    return gLastClient->call(silk, tele, binary, cb, timeout);
+}
+
+void dTelepath::setCallee(SilkID silk, CallCB cb)
+{
+    gLastClient->setCallee(silk, cb);
+}
+
+bool dTelepath::reply(SilkID silk, TeleID tele, CallID call, const dBinary binary)
+{
+    return gLastClient->reply(silk, tele, call, binary);
+}
+
+bool dTelepath::subscribe(SilkID silk, dLiteral topic, TopicCB cb)
+{
+    DD_assert(cb, "cb cannot be nullptr");
+    return gLastClient->subscribe(silk, topic, cb);
+}
+
+void dTelepath::unsubscribe(SilkID silk, dLiteral topic)
+{
+    gLastClient->unsubscribe(silk, topic);
+}
+
+uint32_t dTelepath::publish(SilkID silk, dLiteral topic, const dBinary binary)
+{
+    return gLastClient->publish(silk, topic, binary);
+}
+
+dTelepath::TimerID dTelepath::addTimer(uint32_t msec, TimerCB cb)
+{
+    DD_assert(cb, "cb cannot be nullptr");
+    return gLastClient->addTimer(msec, cb);
+}
+
+void dTelepath::subTimer(TimerID timer)
+{
+    gLastClient->subTimer(timer);
 }
 
 void dTelepath::toast(dLiteral text)
@@ -451,6 +2199,31 @@ bool dTelepath::releaseClient()
     return false;
 }
 
+bool dTelepath::adoptClient(TeleGateClientP* client)
+{
+    if(!client)
+        return false;
+    gLastClient = client;
+    return true;
+}
+
+void dTelepath::parkSilks(TeleGateClientP* client)
+{
+    client->parkSilks();
+}
+
+void dTelepath::unparkSilks(TeleGateClientP* client)
+{
+    // 새 빌드가 다시 추가하지 않은 실크는 제거
+    for(auto iSilk : client->parkedSilks())
+    {
+        client->subSilk(iSilk);
+        printf("[daddy] dTelepath.subSilk(%d) by reload\n", iSilk);
+        if(client->gate().isConnected())
+            client->sendToGate_SubSilk(iSilk);
+    }
+}
+
 void dTelepath::gateCall(dLiteral hostname, TeleGateClientP* client, onMarkInCB cb)
 {
     if(client->gate().isConnected())
@@ -458,33 +2231,133 @@ void dTelepath::gateCall(dLiteral hostname, TeleGateClientP* client, onMarkInCB
         dBinary NewBinary = client->gate().recvBinary();
         if(0 < NewBinary.length())
         {
-            const dZokeReader NewReader(NewBinary);
-            auto Type = NewReader("type").getString();
-            auto ID = NewReader("id").getInt32();
-
-            if(auto CurClient = client->linkedClient(ID))
+            switch(dTeleGate::typeOf(NewBinary))
             {
-                if(!strcmp(Type, "connected"))
+            case dTeleGate::OpType::Null: // 바이너리 프로토콜을 모르는 게이트
+                {
+                    // 외부의 조크는 한번 검증하고(실패시 type이 비어서 무시됨),
+                    // type으로 스키마를 고른 뒤 한번의 바인딩으로 모든 필드를 확인
+                    const dZokeReader NewReader = dZokeReader::validate(NewBinary);
+                    auto Type = NewReader("type").getString();
+                    if(!strcmp(Type, "connected"))
+                    {
+                        GateConnectedP::Reader NewConnected;
+                        if(NewConnected.bind(NewBinary))
+                        {
+                            const dTelepath::SilkID ID = NewConnected.id();
+                            if(client->linkedClient(ID))
+                                client->linkSilk(ID, NewConnected.address().ip4(), NewConnected.address().port());
+                        }
+                    }
+                    else if(!strcmp(Type, "disconnected"))
+                    {
+                        GateSilkP::Reader NewDisconnected;
+                        if(NewDisconnected.bind(NewBinary))
+                        {
+                            const dTelepath::SilkID ID = NewDisconnected.id();
+                            if(client->linkedClient(ID))
+                                client->disconnectSilk(ID);
+                        }
+                    }
+                }
+                break;
+            case dTeleGate::OpType::Hello:
+                if(auto Fields = dTeleGate::fieldsOf<dTeleGate::Hello>(NewBinary))
+                    client->acceptGate(Fields->mVersion);
+                break;
+            case dTeleGate::OpType::Connected:
+                if(auto Fields = dTeleGate::fieldsOf<dTeleGate::Connected>(NewBinary))
                 {
-                    auto IP = NewReader("address")("ip4").getString();
-                    auto Port = NewReader("address")("port").getUint16();
-                    CurClient->connectTo(IP, Port);
+                    const dTelepath::SilkID ID = Fields->mID;
+                    if(client->linkedClient(ID))
+                    {
+                        utf8 IP[16];
+                        snprintf(IP, sizeof(IP), "%u.%u.%u.%u",
+                            Fields->mIP4[0], Fields->mIP4[1], Fields->mIP4[2], Fields->mIP4[3]);
+                        client->linkSilk(ID, IP, Fields->mPort);
+                    }
                 }
-                else if(!strcmp(Type, "disconnected"))
-                    CurClient->disconnect();
+                break;
+            case dTeleGate::OpType::Disconnected:
+                if(auto Fields = dTeleGate::fieldsOf<dTeleGate::Disconnected>(NewBinary))
+                {
+                    const dTelepath::SilkID ID = Fields->mID;
+                    if(client->linkedClient(ID))
+                        client->disconnectSilk(ID);
+                }
+                break;
+            default:
+                break;
             }
         }
+        client->updateStats();
     }
     else if(client->gate().connectTo(hostname.buildNative(), 11019))
     {
+        client->resetGate();
         client->sendToGate_Node(cb);
         client->sendToGate_AddAllSilks();
     }
 }
 
+void dTelepath::shareWorkers(TeleGateClientP* host, TeleGateClientP* guest)
+{
+    guest->shareWorkers(host);
+}
+
 bool dTelepath::nextReceive(TeleGateClientP* client)
 {
     return client->nextReceiveForAllSilks();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dTeleGate
+dBinary dTeleGate::build(OpType type, const void* fields, uint32_t size, utf8s_nn tail, int32_t length)
+{
+    const uint32_t Length = buildInto(nullptr, 0, type, fields, size, tail, length);
+    dump* NewBuffer = new dump[Length];
+    buildInto(NewBuffer, Length, type, fields, size, tail, length);
+    return dBinary::fromInternal(NewBuffer, Length);
+}
+
+uint32_t dTeleGate::buildInto(dump* buffer, uint32_t capacity, OpType type, const void* fields, uint32_t size,
+    utf8s_nn tail, int32_t length)
+{
+    const uint32_t TailLength = (!tail)? 0 : (length == -1)? (uint32_t) strlen(tail) : (uint32_t) length;
+    const uint32_t Result = sizeof(Head) + size + ((tail)? TailLength + 1 : 0);
+    if(capacity < Result)
+        return Result;
+
+    const Head NewHead = {Magic, Version, type};
+    memcpy(buffer, &NewHead, sizeof(Head));
+    if(0 < size)
+        memcpy(buffer + sizeof(Head), fields, size);
+    if(tail)
+    {
+        memcpy(buffer + sizeof(Head) + size, tail, TailLength);
+        buffer[Result - 1] = '\0';
+    }
+    return Result;
+}
+
+dTeleGate::OpType dTeleGate::typeOf(const dBinary& binary)
+{
+    // zoke메시지의 첫 바이트는 ZokeType이므로 Magic과 겹치지 않음
+    if(binary.length() < sizeof(Head) || binary[0] != Magic)
+        return OpType::Null;
+    auto CurHead = (const Head*) binary.buffer();
+    if(CurHead->mVersion == 0 || Version < CurHead->mVersion
+        || CurHead->mType == OpType::Null || OpType::Max <= CurHead->mType)
+        return OpType::Max;
+    return CurHead->mType;
+}
+
+utf8s dTeleGate::tailOf(const dBinary& binary, uint32_t size)
+{
+    const uint32_t Offset = sizeof(Head) + size;
+    if(binary.length() <= Offset || binary[binary.length() - 1] != '\0')
+        return "";
+    return (utf8s) (binary.buffer() + Offset);
+}
+
 } // namespace Daddy
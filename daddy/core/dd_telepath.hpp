@@ -22,16 +22,35 @@ public:
     typedef int32_t SilkID;
     enum class SilkType {Server, Client};
     enum class ReceiveType {Connected, Reconnected, Message, Disconnected};
+    enum class DeliveryType {Normal, LowLatency, Throughput};
     typedef utf8s (*onMarkInCB)(int32_t type);
     typedef std::function<bool(TeleID tele, ReceiveType type, dBinary binary)> ReceiveCB;
+    typedef uint32_t CallID;
+    enum class ReplyType {Replied, Timeout, Failed};
+    typedef std::function<bool(ReplyType type, dBinary binary)> ReplyCB;
+    typedef std::function<bool(TeleID tele, CallID call, dBinary binary)> CallCB;
+    typedef std::function<bool(dLiteral topic, dBinary binary)> TopicCB;
+    typedef uint32_t TimerID;
+    typedef std::function<uint32_t()> TimerCB; // 반환값은 다음 호출까지의 ms(0이면 종료)
+    struct SilkStats
+    {
+        uint64_t mSentMessages; // 발송성공한 메시지수(sendAll은 1회로 계산)
+        uint64_t mSentBytes;    // 발송성공한 바이트수
+        uint64_t mRecvMessages; // 수신한 메시지수
+        uint64_t mRecvBytes;    // 수신한 바이트수
+        uint64_t mFailures;     // 발송실패수(끊길때 큐잉되어 재발송하지 못한 메시지 포함)
+        uint32_t mQueued;       // 발송을 기다리는 바이트수(Throughput전용)
+        uint32_t mLatency;      // 마지막 왕복지연(마이크로초, 0이면 미측정)
+    };
 
 public: // 노드통신
     /// @brief           실크추가
     /// @param type      실크타입(서버, 클라이언트)
     /// @param protocol  프로토콜명(같은 프로토콜명의 서/클만이 연결가능)
-    /// @param cb        요청된 연결에 대한 이벤트트리거
+    /// @param cb        요청된 연결에 대한 이벤트트리거(Client는 끊기면 스스로 재접속하며 이후 Reconnected)
+    /// @param delivery  전송방식(LowLatency-즉시발송, Throughput-틱단위로 모아서 일괄발송)
     /// @return          발급된 SilkID(실제로 연결되면 ReceiveType::Connected로 cb호출)
-    static SilkID addSilk(SilkType type, dLiteral protocol, ReceiveCB cb);
+    static SilkID addSilk(SilkType type, dLiteral protocol, ReceiveCB cb, DeliveryType delivery = DeliveryType::Normal);
 
     /// @brief           실크제거
     /// @param silk      발급된 SilkID
@@ -55,10 +74,96 @@ public: // 노드통신
     /// @return          true-성공, false-실패 및 해당 연결상대가 제거됨
     static bool sendAll(SilkID silk, const dBinary binary);
 
+    /// @brief           실크의 누적통계
+    /// @param silk      발급된 SilkID
+    /// @return          생성이후의 누적값(없는 실크면 모두 0)
+    static SilkStats stats(SilkID silk);
+
+    /// @brief           게이트에 통계를 보고하는 주기설정(기본 1000ms)
+    /// @param msec      보고주기(0이면 보고안함)
+    static void setStatsInterval(uint32_t msec);
+
+    /// @brief           클라이언트 실크가 끊겨서 재접속하는 동안 보관할 발송량의 한도(기본 1MB)
+    /// @param bytes     실크별 최대 바이트수(초과분은 발송실패)
+    static void setOutboxLimit(uint32_t bytes);
+
+    /// @brief           콜백들을 처리할 워커스레드 지정(같은 상대의 콜백은 도착순서대로, 다른 상대끼리는 병렬로)
+    /// @param count     워커수(0이면 nextReceive를 호출한 스레드에서 처리, 기본값)
+    /// @see             subSilk와 함께 메인스레드에서만 호출
+    static void setWorkers(uint32_t count);
+
+    /// @brief           이후에 추가할 서버 실크의 수신을 나눠맡을 I/O스레드 지정(SO_REUSEPORT로 리스너도 분할)
+    /// @param count     샤드수(0이면 nextReceive를 호출한 스레드가 직접 수신, 기본값)
+    /// @see             addSilk 이전에 호출
+    static void setServerShards(uint32_t count);
+
+    /// @brief           실크의 하트비트 지정(조용한 상대에게 Ping을 보내고, 응답도 없으면 연결해제)
+    /// @param silk      발급된 SilkID
+    /// @param interval  수신이 없을때 Ping을 보내는 주기(ms, 0이면 해제)
+    /// @param timeout   이 시간동안 수신이 없으면 연결해제(ms, 0이면 interval의 3배)
+    /// @see             끊긴 상대는 Server실크면 ReceiveType::Disconnected, Client실크는 재접속후 Reconnected
+    static void setHeartbeat(SilkID silk, uint32_t interval, uint32_t timeout = 0);
+
     /// @brief           게이트에 텍스트전송(개발전용)
     /// @param text      전송할 텍스트
     static void toast(dLiteral text);
 
+public: // 원격호출
+    /// @brief           실크를 통해 특정 상대에게 요청하고 회신을 기다림(여러 요청을 동시에 진행가능)
+    /// @param silk      발급된 SilkID
+    /// @param tele      연결상대에 할당된 TeleID(Client실크는 무시)
+    /// @param binary    요청할 바이너리
+    /// @param cb        회신, 시간초과, 실패시의 이벤트트리거(nextReceive중에 1회 호출)
+    /// @param timeout   회신을 기다리는 최대시간(ms)
+    /// @return          발급된 CallID(0이면 발송실패이며 cb는 호출되지 않음)
+    /// @see             원격호출과 토픽은 같은 버전끼리만(이전 버전의 상대와는 send/sendAll의 메시지만 호환)
+    static CallID call(SilkID silk, TeleID tele, const dBinary binary, ReplyCB cb, uint32_t timeout = 5000);
+
+    /// @brief           실크로 들어오는 요청의 처리자 지정(없으면 요청측은 ReplyType::Failed를 받음)
+    /// @param silk      발급된 SilkID
+    /// @param cb        요청에 대한 이벤트트리거(회신은 즉시 또는 나중에 reply로)
+    static void setCallee(SilkID silk, CallCB cb);
+
+    /// @brief           받은 요청에 회신(순서와 무관하게 회신가능)
+    /// @param silk      발급된 SilkID
+    /// @param tele      요청한 상대의 TeleID
+    /// @param call      요청의 CallID
+    /// @param binary    회신할 바이너리
+    /// @return          true-성공, false-실패
+    static bool reply(SilkID silk, TeleID tele, CallID call, const dBinary binary);
+
+public: // 토픽
+    /// @brief           클라이언트 실크로 토픽구독(서버가 그 토픽으로 publish한 메시지만 수신)
+    /// @param silk      발급된 SilkID(Client실크)
+    /// @param topic     토픽명(끝이 '*'이면 그 앞부분으로 시작하는 모든 토픽, 최대 65535바이트)
+    /// @param cb        토픽메시지의 이벤트트리거(같은 토픽을 다시 구독하면 교체)
+    /// @return          true-성공, false-실패
+    /// @see             재접속하면 구독도 자동으로 다시 알림
+    static bool subscribe(SilkID silk, dLiteral topic, TopicCB cb);
+
+    /// @brief           토픽구독 해제
+    /// @param silk      발급된 SilkID(Client실크)
+    /// @param topic     subscribe에 쓴 토픽명
+    static void unsubscribe(SilkID silk, dLiteral topic);
+
+    /// @brief           서버 실크를 통해 토픽의 구독자에게만 바이너리전송(프레임은 한번만 만들어서 공유)
+    /// @param silk      발급된 SilkID(Server실크)
+    /// @param topic     토픽명
+    /// @param binary    전송할 바이너리
+    /// @return          발송에 성공한 구독자의 수(여러 구독이 겹쳐도 상대마다 1회)
+    static uint32_t publish(SilkID silk, dLiteral topic, const dBinary binary);
+
+public: // 타이머
+    /// @brief           타이머 등록(틱을 세지 않고 주기작업을 하는 용도, 워커의 콜백에서도 가능)
+    /// @param msec      첫 호출까지의 ms
+    /// @param cb        만료시 호출될 콜백(nextReceive를 호출한 스레드에서, 핫리로드시 모두 해제)
+    /// @return          발급된 TimerID(0이면 실패)
+    static TimerID addTimer(uint32_t msec, TimerCB cb);
+
+    /// @brief           타이머 해제(자신의 콜백 안이나 워커의 콜백에서도 가능)
+    /// @param timer     발급된 TimerID
+    static void subTimer(TimerID timer);
+
 public: // 어댑터전용
     /// @brief           클라이언트 생성
     /// @return          할당된 클라이언트
@@ -68,12 +173,33 @@ public: // 어댑터전용
     /// @return          true-반환성공, false-반환없음
     static bool releaseClient();
 
+    /// @brief           핫리로드된 새 빌드가 이전 빌드의 클라이언트를 이어받음(onReload에서 호출)
+    /// @param client    이전 빌드가 만든 클라이언트
+    /// @return          true-성공, false-실패
+    static bool adoptClient(TeleGateClientP* client);
+
+    /// @brief           핫리로드 준비로 모든 실크를 보류(연결은 유지)
+    /// @param client    할당된 클라이언트
+    /// @see             보류중인 실크는 새 빌드가 같은 타입과 프로토콜로 addSilk하면 연결째로 이어받고,
+    ///                  그동안 이전 빌드의 subSilk는 무시됨
+    static void parkSilks(TeleGateClientP* client);
+
+    /// @brief           CycleType::Recreate후 새 빌드가 이어받지 않은 실크를 제거
+    /// @param client    할당된 클라이언트
+    static void unparkSilks(TeleGateClientP* client);
+
     /// @brief           게이트 연결보장 및 각종 처리
     /// @param hostname  게이트서버의 도메인주소 또는 IP주소
     /// @param client    할당된 클라이언트
     /// @param cb        컴포넌트의 정보획득용 이벤트트리거
     static void gateCall(dLiteral hostname, TeleGateClientP* client, onMarkInCB cb);
 
+    /// @brief           다른 클라이언트의 워커를 함께 사용(한 프로세스에 여러 컴포넌트)
+    /// @param host      워커를 가진 클라이언트
+    /// @param guest     host의 워커를 빌려쓸 클라이언트(실크와 게이트연결은 각자 보유)
+    /// @see             gateCall은 컴포넌트마다 따로, guest의 releaseClient는 host보다 먼저
+    static void shareWorkers(TeleGateClientP* host, TeleGateClientP* guest);
+
     /// @brief           ReceiveCB호출보장 및 노드통신 각종 처리
     /// @param client    할당된 클라이언트
     static bool nextReceive(TeleGateClientP* client);
@@ -96,9 +222,79 @@ namespace dTeleApi
     {
         typedef bool (*onPlugInCB)(int32_t type, utf8s hostname, uint16_t port);
         typedef bool (*onCycleCB)(int32_t type);
+        typedef bool (*onReloadCB)(TeleGateClientP* client); // 선택, 핫리로드를 지원하는 컴포넌트만
     }
 }
 
+/// @brief 노드와 게이트간의 바이너리 프로토콜(고정레이아웃, 리틀엔디안)
+/// @see   node메시지(zoke)의 "component"와 "gate"로 제안하고 게이트가 Hello로 수락하면 이후 바이너리로 통신
+///        첫 바이트가 Magic이 아닌 메시지는 이전의 zoke메시지
+class dTeleGate
+{
+public:
+    enum : uint8_t {Magic = 0xDD, Version = 1};
+    enum class OpType : uint8_t {Null,
+        Hello, // 게이트 → 노드
+        Node, ConnectAdd, ConnectSub, Toast, SilkStats, // 노드 → 게이트(Node는 EntityUuid만, Toast는 텍스트만)
+        Connected, Disconnected, // 게이트 → 노드
+        Max};
+    enum class EntryType : uint8_t {Server, Client};
+
+    #pragma pack(push, 1)
+    struct Head {uint8_t mMagic; uint8_t mVersion; OpType mType;};
+    struct Hello {uint8_t mVersion;}; // 수락한 버전
+    struct ConnectAdd {int32_t mID; EntryType mEntry; uint16_t mPort;}; // 뒤에 프로토콜명
+    struct ConnectSub {int32_t mID;};
+    struct SilkStat {int32_t mID; uint64_t mMessages; uint64_t mBytes; uint64_t mFailures; uint32_t mQueued; uint32_t mLatency;};
+    struct Connected {int32_t mID; uint8_t mIP4[4]; uint16_t mPort;};
+    struct Disconnected {int32_t mID;};
+    #pragma pack(pop)
+
+public:
+    /// @brief           메시지 생성
+    /// @param type      메시지타입
+    /// @param fields    고정필드(SilkStats는 SilkStat의 배열)
+    /// @param size      고정필드의 바이트수
+    /// @param tail      고정필드에 이어붙일 스트링(null문자포함으로 저장)
+    /// @param length    스트링의 길이(-1이면 끝까지)
+    /// @return          전송할 바이너리
+    static dBinary build(OpType type, const void* fields, uint32_t size, utf8s_nn tail = nullptr, int32_t length = -1);
+
+    /// @brief           메시지를 호출자의 버퍼에 생성(재사용하는 버퍼로 할당없이 발송)
+    /// @param buffer    기록할 버퍼
+    /// @param capacity  버퍼의 크기(모자라면 기록하지 않음)
+    /// @param type      메시지타입
+    /// @param fields    고정필드
+    /// @param size      고정필드의 바이트수
+    /// @param tail      고정필드에 이어붙일 스트링(null문자포함으로 저장)
+    /// @param length    스트링의 길이(-1이면 끝까지)
+    /// @return          메시지의 바이트수(capacity보다 크면 그만큼 다시 확보후 재호출)
+    static uint32_t buildInto(dump* buffer, uint32_t capacity, OpType type, const void* fields, uint32_t size,
+        utf8s_nn tail = nullptr, int32_t length = -1);
+
+    /// @brief           수신한 메시지의 타입확인
+    /// @param binary    수신한 바이너리
+    /// @return          메시지타입(OpType::Null이면 zoke메시지, OpType::Max면 모르는 버전이나 타입)
+    static OpType typeOf(const dBinary& binary);
+
+    /// @brief           수신한 메시지의 고정필드
+    /// @param binary    typeOf로 확인한 바이너리
+    /// @return          고정필드(길이가 모자라면 nullptr)
+    template<typename TYPE>
+    static const TYPE* fieldsOf(const dBinary& binary)
+    {
+        if(binary.length() < sizeof(Head) + sizeof(TYPE))
+            return nullptr;
+        return (const TYPE*) (binary.buffer() + sizeof(Head));
+    }
+
+    /// @brief           수신한 메시지에서 고정필드에 이어진 스트링
+    /// @param binary    typeOf로 확인한 바이너리
+    /// @param size      고정필드의 바이트수
+    /// @return          스트링(없거나 null문자로 끝나지 않으면 "")
+    static utf8s tailOf(const dBinary& binary, uint32_t size);
+};
+
 /// @brief 어댑터 모델
 class dTeleAdapter
 {
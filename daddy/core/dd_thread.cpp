@@ -77,6 +77,8 @@
 #endif
 typedef MUTEX_DATA MutexData;
 typedef SEMAPHORE_DATA SemaphoreData;
+#include <chrono>
+#include <vector>
 
 namespace Daddy {
 
@@ -187,4 +189,323 @@ void dSemaphore::_copy_(const _self_& rhs)
     DD_assert(false, "you have called an unused method.");
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ TimerWheelP
+// 1ms단위의 틱, 단계마다 64슬롯(1단계 64ms, 2단계 4초, 3단계 4.4분, 4단계 4.6시간)
+// 상위단계의 슬롯은 해당 구간에 들어설 때 한단계 아래로 재배치
+class TimerWheelP
+{
+public:
+    TimerWheelP();
+
+public:
+    dTimerWheel::TimerID start(uint32_t msec, dTimerWheel::TimerCB&& cb);
+    bool stop(dTimerWheel::TimerID timer);
+    bool restart(dTimerWheel::TimerID timer, uint32_t msec);
+    void clear();
+    uint32_t advance();
+    inline uint32_t count() const
+    {return mCount;}
+
+private:
+    enum {SlotBits = 6, SlotCount = 1 << SlotBits, SlotMask = SlotCount - 1, LevelCount = 4,
+        IndexBits = 20, IndexMask = (1 << IndexBits) - 1, GenerationMask = (1 << (32 - IndexBits)) - 1};
+    struct Timer
+    {
+        uint64_t mExpire;
+        dTimerWheel::TimerCB mCB;
+        uint32_t mGeneration;
+        int32_t mPrev;
+        int32_t mNext;
+        int32_t mSlot; // -1이면 미연결(호출중 또는 해제됨)
+        bool mAlive;
+    };
+    static uint64_t nowMsec();
+    int32_t find(dTimerWheel::TimerID timer) const;
+    void link(int32_t index, bool due = false);
+    void unlink(int32_t index);
+    void release(int32_t index);
+    void cascade(int32_t level);
+    uint32_t tick();
+
+private:
+    std::vector<Timer> mTimers;
+    std::vector<int32_t> mFreeIndices;
+    std::vector< std::pair<int32_t, uint32_t> > mFirings; // tick마다 재사용
+    int32_t mHeads[LevelCount * SlotCount];
+    uint64_t mNow; // 처리가 끝난 틱
+    uint32_t mCount;
+};
+
+TimerWheelP::TimerWheelP()
+{
+    for(int i = 0; i < LevelCount * SlotCount; ++i)
+        mHeads[i] = -1;
+    mNow = nowMsec();
+    mCount = 0;
+}
+
+dTimerWheel::TimerID TimerWheelP::start(uint32_t msec, dTimerWheel::TimerCB&& cb)
+{
+    int32_t NewIndex = 0;
+    if(!mFreeIndices.empty())
+    {
+        NewIndex = mFreeIndices.back();
+        mFreeIndices.pop_back();
+    }
+    else
+    {
+        if(IndexMask < mTimers.size())
+            return 0;
+        NewIndex = (int32_t) mTimers.size();
+        mTimers.emplace_back();
+        mTimers.back().mGeneration = 1;
+        mTimers.back().mAlive = false;
+    }
+
+    Timer& NewTimer = mTimers[NewIndex];
+    NewTimer.mExpire = std::max(mNow, nowMsec()) + std::max(msec, uint32_t(1));
+    NewTimer.mCB = DD_rvalue(cb);
+    NewTimer.mSlot = -1;
+    NewTimer.mAlive = true;
+    link(NewIndex);
+    mCount++;
+    return (NewTimer.mGeneration << IndexBits) | (uint32_t) NewIndex;
+}
+
+bool TimerWheelP::stop(dTimerWheel::TimerID timer)
+{
+    const int32_t Index = find(timer);
+    if(Index < 0)
+        return false;
+    unlink(Index);
+    release(Index);
+    return true;
+}
+
+bool TimerWheelP::restart(dTimerWheel::TimerID timer, uint32_t msec)
+{
+    const int32_t Index = find(timer);
+    if(Index < 0)
+        return false;
+    unlink(Index);
+    mTimers[Index].mExpire = std::max(mNow, nowMsec()) + std::max(msec, uint32_t(1));
+    link(Index);
+    return true;
+}
+
+void TimerWheelP::clear()
+{
+    for(int32_t i = 0, iend = (int32_t) mTimers.size(); i < iend; ++i)
+        if(mTimers[i].mAlive)
+        {
+            unlink(i);
+            release(i);
+        }
+}
+
+uint32_t TimerWheelP::advance()
+{
+    const uint64_t NowMsec = nowMsec();
+    uint32_t Result = 0;
+    while(mNow < NowMsec)
+    {
+        if(mCount == 0) // 빈 휠은 시각만 맞춤
+        {
+            mNow = NowMsec;
+            break;
+        }
+        Result += tick();
+    }
+    return Result;
+}
+
+uint64_t TimerWheelP::nowMsec()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int32_t TimerWheelP::find(dTimerWheel::TimerID timer) const
+{
+    const int32_t Index = int32_t(timer & IndexMask);
+    if(mTimers.size() <= (size_t) Index || mTimers[Index].mGeneration != (timer >> IndexBits) || !mTimers[Index].mAlive)
+        return -1;
+    return Index;
+}
+
+void TimerWheelP::link(int32_t index, bool due)
+{
+    // 처리가 끝난 틱의 슬롯은 한바퀴 뒤에나 보므로 다음 틱으로(due는 이번 틱의 재배치)
+    Timer& CurTimer = mTimers[index];
+    if(CurTimer.mExpire + ((due)? 1 : 0) <= mNow)
+        CurTimer.mExpire = mNow + 1;
+
+    // 남은 시간으로 단계를 정하고, 만료시각의 해당 자리로 슬롯을 정함
+    uint64_t Expire = CurTimer.mExpire;
+    const uint64_t Delta = Expire - mNow;
+    int32_t Level = 0;
+    while(Level < LevelCount - 1 && (uint64_t(1) << (SlotBits * (Level + 1))) <= Delta)
+        Level++;
+    if((uint64_t(1) << (SlotBits * LevelCount)) <= Delta) // 범위밖은 마지막 단계의 끝에 두고 재배치
+        Expire = mNow + (uint64_t(1) << (SlotBits * LevelCount)) - 1;
+    const int32_t Slot = Level * SlotCount + int32_t((Expire >> (SlotBits * Level)) & SlotMask);
+
+    CurTimer.mSlot = Slot;
+    CurTimer.mPrev = -1;
+    CurTimer.mNext = mHeads[Slot];
+    if(mHeads[Slot] != -1)
+        mTimers[mHeads[Slot]].mPrev = index;
+    mHeads[Slot] = index;
+}
+
+void TimerWheelP::unlink(int32_t index)
+{
+    Timer& CurTimer = mTimers[index];
+    if(CurTimer.mSlot == -1)
+        return;
+    if(CurTimer.mPrev != -1)
+        mTimers[CurTimer.mPrev].mNext = CurTimer.mNext;
+    else mHeads[CurTimer.mSlot] = CurTimer.mNext;
+    if(CurTimer.mNext != -1)
+        mTimers[CurTimer.mNext].mPrev = CurTimer.mPrev;
+    CurTimer.mSlot = -1;
+}
+
+void TimerWheelP::release(int32_t index)
+{
+    // 세대를 올려서 이전 ID를 무효화(0은 건너뜀)
+    Timer& CurTimer = mTimers[index];
+    CurTimer.mCB = nullptr;
+    CurTimer.mAlive = false;
+    CurTimer.mGeneration = (CurTimer.mGeneration + 1) & GenerationMask;
+    if(CurTimer.mGeneration == 0)
+        CurTimer.mGeneration = 1;
+    mFreeIndices.push_back(index);
+    mCount--;
+}
+
+void TimerWheelP::cascade(int32_t level)
+{
+    const int32_t Slot = level * SlotCount + int32_t((mNow >> (SlotBits * level)) & SlotMask);
+    int32_t CurIndex = mHeads[Slot];
+    mHeads[Slot] = -1;
+    while(CurIndex != -1)
+    {
+        const int32_t NextIndex = mTimers[CurIndex].mNext;
+        link(CurIndex, true); // mNow에 만료되는 것은 바로 뒤에 수거되는 0단계 슬롯으로
+        CurIndex = NextIndex;
+    }
+}
+
+uint32_t TimerWheelP::tick()
+{
+    mNow++;
+    for(int32_t i = 1; i < LevelCount && (mNow & ((uint64_t(1) << (SlotBits * i)) - 1)) == 0; ++i)
+        cascade(i);
+
+    // 슬롯을 통째로 떼어낸 후 호출(콜백중의 stop/restart가 목록을 건드리지 않도록)
+    // 버퍼는 꺼내 쓰고 돌려놓음(콜백중의 advance가 같은 버퍼를 건드리지 않도록)
+    const int32_t Slot = int32_t(mNow & SlotMask);
+    std::vector< std::pair<int32_t, uint32_t> > Firings;
+    Firings.swap(mFirings);
+    Firings.clear();
+    for(int32_t CurIndex = mHeads[Slot]; CurIndex != -1; CurIndex = mTimers[CurIndex].mNext)
+    {
+        mTimers[CurIndex].mSlot = -1;
+        Firings.push_back(std::make_pair(CurIndex, mTimers[CurIndex].mGeneration));
+    }
+    mHeads[Slot] = -1;
+
+    uint32_t Result = 0;
+    for(const auto& iFiring : Firings)
+    {
+        const int32_t CurIndex = iFiring.first;
+        if(mTimers[CurIndex].mGeneration != iFiring.second || mTimers[CurIndex].mSlot != -1)
+            continue; // 앞선 콜백에서 stop 또는 restart됨
+        if(mNow < mTimers[CurIndex].mExpire) // 범위밖에서 재배치되어 온 것
+        {
+            link(CurIndex);
+            continue;
+        }
+
+        // 콜백중의 start로 배열이 옮겨질 수 있으므로 콜백을 꺼내서 호출
+        dTimerWheel::TimerCB CurCB = DD_rvalue(mTimers[CurIndex].mCB);
+        const uint32_t NextMsec = CurCB();
+        Result++;
+        Timer& CurTimer = mTimers[CurIndex];
+        if(CurTimer.mGeneration != iFiring.second) // 콜백중에 stop됨
+            continue;
+        CurTimer.mCB = DD_rvalue(CurCB);
+        if(CurTimer.mSlot != -1) // 콜백중에 restart됨
+            continue;
+        if(NextMsec == 0)
+            release(CurIndex);
+        else
+        {
+            CurTimer.mExpire = mNow + NextMsec;
+            link(CurIndex);
+        }
+    }
+    mFirings.swap(Firings);
+    return Result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dTimerWheel
+dTimerWheel::TimerID dTimerWheel::start(uint32_t msec, TimerCB cb)
+{
+    DD_assert(cb, "cb cannot be nullptr");
+    return ((TimerWheelP*) mData)->start(msec, DD_rvalue(cb));
+}
+
+bool dTimerWheel::stop(TimerID timer)
+{
+    return ((TimerWheelP*) mData)->stop(timer);
+}
+
+bool dTimerWheel::restart(TimerID timer, uint32_t msec)
+{
+    return ((TimerWheelP*) mData)->restart(timer, msec);
+}
+
+void dTimerWheel::clear()
+{
+    ((TimerWheelP*) mData)->clear();
+}
+
+uint32_t dTimerWheel::advance()
+{
+    return ((TimerWheelP*) mData)->advance();
+}
+
+uint32_t dTimerWheel::count() const
+{
+    return ((TimerWheelP*) mData)->count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dTimerWheel::escaper
+void dTimerWheel::_init_(InitType type)
+{
+    if(type == InitType::Create)
+        mData = new TimerWheelP();
+    else mData = nullptr;
+}
+
+void dTimerWheel::_quit_()
+{
+    delete (TimerWheelP*) mData;
+}
+
+void dTimerWheel::_move_(_self_&& rhs)
+{
+    mData = rhs.mData;
+}
+
+void dTimerWheel::_copy_(const _self_& rhs)
+{
+    DD_assert(false, "you have called an unused method.");
+}
+
 } // namespace Daddy
@@ -5,6 +5,7 @@
 
 // Dependencies
 #include "dd_escaper.hpp"
+#include <functional>
 
 namespace Daddy {
 
@@ -58,4 +59,50 @@ DD_escaper_alone(dSemaphore): // 객체사이클
     utf8* mName;
 };
 
+
+/// @brief 타이머휠(64슬롯 4단계의 계층형, 등록/해제/만료처리가 타이머수와 무관하게 O(1))
+/// @see   스레드안전하지 않으므로 advance를 호출하는 스레드에서만 사용
+class dTimerWheel
+{
+public:
+    typedef uint32_t TimerID;
+    typedef std::function<uint32_t()> TimerCB; // 반환값은 다음 호출까지의 ms(0이면 종료)
+
+public: // 사용성
+    /// @brief          타이머 등록
+    /// @param msec     첫 호출까지의 ms(해상도는 1ms, 약 4.6시간 이후는 단계적으로 재배치)
+    /// @param cb       만료시 호출될 콜백(advance중에 호출)
+    /// @return         발급된 TimerID(0은 발급실패)
+    TimerID start(uint32_t msec, TimerCB cb);
+
+    /// @brief          타이머 해제(자신의 콜백 안에서도 가능)
+    /// @param timer    발급된 TimerID
+    /// @return         true-해제됨, false-이미 없음
+    bool stop(TimerID timer);
+
+    /// @brief          타이머의 다음 호출을 다시 지정
+    /// @param timer    발급된 TimerID
+    /// @param msec     지금부터 다음 호출까지의 ms
+    /// @return         true-성공, false-이미 없음
+    bool restart(TimerID timer, uint32_t msec);
+
+    /// @brief          모든 타이머 해제
+    void clear();
+
+    /// @brief          현재시각까지 만료된 타이머들을 호출
+    /// @return         호출된 콜백의 수
+    uint32_t advance();
+
+    /// @brief          등록된 타이머의 수
+    /// @return         타이머의 수
+    uint32_t count() const;
+
+DD_escaper_alone(dTimerWheel): // 객체사이클
+    void _init_(InitType type);
+    void _quit_();
+    void _move_(_self_&& rhs);
+    void _copy_(const _self_& rhs);
+    ptr mData;
+};
+
 } // namespace Daddy
@@ -4,22 +4,180 @@
 #include "dd_zoker.hpp"
 
 // Dependencies
+#include <algorithm>
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <string>
+#include <tuple>
+#include <vector>
 
 namespace Daddy {
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ ZokeArenaP
+class ZokeArenaP
+{
+public:
+    void* alloc(size_t size, size_t align)
+    {
+        size_t Cursor = (mCursor + align - 1) & ~(align - 1);
+        if(!mChunk || mChunk->mSize < Cursor + size)
+        {
+            if(!mChunk)
+                mChunk = mFirst = newChunk(std::max((size_t) FirstSize, size), nullptr);
+            else if(mChunk->mNext && size <= mChunk->mNext->mSize)
+                mChunk = mChunk->mNext; // reset전에 확보했던 청크를 재사용
+            else mChunk = mChunk->mNext = newChunk(std::max(std::min(mChunk->mSize * 2, (size_t) MaxSize), size), mChunk->mNext);
+            Cursor = 0;
+        }
+        mCursor = Cursor + size;
+        mUsed += size;
+        return mChunk->data() + Cursor;
+    }
+
+    void reset()
+    {
+        mChunk = mFirst;
+        mCursor = 0;
+        mUsed = 0;
+    }
+
+    uint32_t used() const
+    {
+        return (uint32_t) mUsed;
+    }
+
+private:
+    struct alignas(std::max_align_t) Chunk // 자신의 바로 뒤가 데이터
+    {
+        Chunk* mNext;
+        size_t mSize;
+        inline dump* data() {return (dump*) (this + 1);}
+    };
+
+    static Chunk* newChunk(size_t size, Chunk* next)
+    {
+        Chunk* NewChunk = (Chunk*) ::operator new(sizeof(Chunk) + size);
+        NewChunk->mNext = next;
+        NewChunk->mSize = size;
+        return NewChunk;
+    }
+
+private:
+    static const size_t FirstSize = 4096;
+    static const size_t MaxSize = 1024 * 1024;
+    Chunk* mFirst = nullptr;
+    Chunk* mChunk = nullptr; // 할당중인 청크
+    size_t mCursor = 0;
+    size_t mUsed = 0;
+
+public:
+    ~ZokeArenaP()
+    {
+        while(mFirst)
+        {
+            Chunk* OldChunk = mFirst;
+            mFirst = mFirst->mNext;
+            ::operator delete(OldChunk);
+        }
+    }
+};
+
+// 아레나가 있으면 범프할당(해제는 reset으로), 없으면 일반할당
+template<typename TYPE>
+class ZokeAllocatorP
+{
+public:
+    typedef TYPE value_type;
+
+    TYPE* allocate(size_t n)
+    {
+        if(mArena)
+            return (TYPE*) mArena->alloc(sizeof(TYPE) * n, alignof(TYPE));
+        return (TYPE*) ::operator new(sizeof(TYPE) * n);
+    }
+
+    void deallocate(TYPE* p, size_t)
+    {
+        if(!mArena)
+            ::operator delete(p);
+    }
+
+    // 복사된 컨테이너는 일반할당으로(아레나조커의 복사는 일반조커)
+    ZokeAllocatorP select_on_container_copy_construction() const
+    {
+        return ZokeAllocatorP();
+    }
+
+    template<typename OTHER>
+    bool operator==(const ZokeAllocatorP<OTHER>& rhs) const {return mArena == rhs.mArena;}
+    template<typename OTHER>
+    bool operator!=(const ZokeAllocatorP<OTHER>& rhs) const {return mArena != rhs.mArena;}
+
+public:
+    ZokeAllocatorP(ZokeArenaP* arena = nullptr) : mArena(arena) {}
+    template<typename OTHER>
+    ZokeAllocatorP(const ZokeAllocatorP<OTHER>& rhs) : mArena(rhs.mArena) {}
+    ZokeArenaP* mArena;
+};
+
+// key비교(임시스트링 없이 찾도록 KeyView로도 비교)
+struct ZokeKeyView
+{
+    utf8s_nn mKey;
+    size_t mLength;
+};
+
+class ZokeKeyLessP
+{
+public:
+    typedef void is_transparent;
+
+    template<typename LHS, typename RHS>
+    bool operator()(const LHS& lhs, const RHS& rhs) const
+    {
+        const ZokeKeyView L = view(lhs), R = view(rhs);
+        const int Result = memcmp(L.mKey, R.mKey, std::min(L.mLength, R.mLength));
+        return (Result != 0)? Result < 0 : L.mLength < R.mLength;
+    }
+
+private:
+    static ZokeKeyView view(const ZokeKeyView& key)
+    {
+        return key;
+    }
+
+    template<typename ALLOC>
+    static ZokeKeyView view(const std::basic_string<char, std::char_traits<char>, ALLOC>& key)
+    {
+        return {key.c_str(), key.length()};
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ dZoker
 void dZoker::clear()
 {
+    ZokeArenaP* OldArena = mArena;
     _quit_();
     _init_(InitType::Create);
+    mArena = OldArena;
 }
 
 dZoker& dZoker::operator()(utf8s_nn key, int32_t length)
 {
     valid(ZokeType::Nameable);
-    return (*mValue.mNameablePtr)[std::string(key, (length == -1)? strlen(key) : length)];
+    const ZokeKeyView Key = {key, (length == -1)? strlen(key) : (size_t) length};
+    auto it = mValue.mNameablePtr->lower_bound(Key);
+    if(it == mValue.mNameablePtr->end() || ZokeKeyLessP()(Key, it->first))
+    {
+        it = mValue.mNameablePtr->emplace_hint(it, std::piecewise_construct,
+            std::forward_as_tuple(Key.mKey, Key.mLength, mValue.mNameablePtr->get_allocator()), std::forward_as_tuple());
+        it->second.mArena = mArena; // 자식은 부모의 아레나를 상속
+    }
+    return it->second;
 }
 
 dZoker& dZoker::operator()(const dLiteral& key)
@@ -31,7 +189,8 @@ dZoker* dZoker::access(utf8s_nn key, int32_t length) const
 {
     if(mType == ZokeType::Nameable)
     {
-        auto it = mValue.mNameablePtr->find(std::string(key, (length == -1)? strlen(key) : length));
+        const ZokeKeyView Key = {key, (length == -1)? strlen(key) : (size_t) length};
+        auto it = mValue.mNameablePtr->find(Key);
         if(it != mValue.mNameablePtr->end())
             return &it->second;
     }
@@ -46,25 +205,36 @@ dZoker* dZoker::access(const dLiteral& key) const
 dZoker& dZoker::operator[](uint32_t index)
 {
     valid(ZokeType::Indexable);
-    return (*mValue.mIndexablePtr)[index];
+    auto it = mValue.mIndexablePtr->lower_bound((int) index);
+    if(it == mValue.mIndexablePtr->end() || it->first != (int) index)
+    {
+        it = mValue.mIndexablePtr->emplace_hint(it, std::piecewise_construct,
+            std::forward_as_tuple((int) index), std::forward_as_tuple());
+        it->second.mArena = mArena; // 자식은 부모의 아레나를 상속
+    }
+    return it->second;
 }
 
 dZoker& dZoker::atAdding()
 {
     valid(ZokeType::Indexable);
-    return (*mValue.mIndexablePtr)[(int) mValue.mIndexablePtr->size()];
+    return operator[]((uint32_t) mValue.mIndexablePtr->size());
 }
 
 void dZoker::setString(const dLiteral& value)
 {
     valid(ZokeType::String);
-    *mValue.mStringPtr = value;
+    if(mArena)
+        setBytes(value.string(), value.length());
+    else *mValue.mStringPtr = value;
 }
 
 void dZoker::setBinary(const dBinary& value)
 {
     valid(ZokeType::Binary);
-    *mValue.mBinaryPtr = value;
+    if(mArena)
+        setBytes(value.buffer(), value.length());
+    else *mValue.mBinaryPtr = value;
 }
 
 void dZoker::setInt8(const int8_t value)
@@ -127,111 +297,583 @@ void dZoker::setFloat64(const double value)
     mValue.mFloat64 = value;
 }
 
-dBinary dZoker::build() const
+void dZoker::setInt8Array(const int8_t* values, uint32_t count)
+{
+    setArray(ZokeType::Int8Array, values, count, sizeof(int8_t));
+}
+
+void dZoker::setInt16Array(const int16_t* values, uint32_t count)
+{
+    setArray(ZokeType::Int16Array, values, count, sizeof(int16_t));
+}
+
+void dZoker::setInt32Array(const int32_t* values, uint32_t count)
+{
+    setArray(ZokeType::Int32Array, values, count, sizeof(int32_t));
+}
+
+void dZoker::setInt64Array(const int64_t* values, uint32_t count)
 {
-    // 가변길이 정수처리
-    auto addVar = [](dBinary& binary, uint32_t value)->void
+    setArray(ZokeType::Int64Array, values, count, sizeof(int64_t));
+}
+
+void dZoker::setUint8Array(const uint8_t* values, uint32_t count)
+{
+    setArray(ZokeType::Uint8Array, values, count, sizeof(uint8_t));
+}
+
+void dZoker::setUint16Array(const uint16_t* values, uint32_t count)
+{
+    setArray(ZokeType::Uint16Array, values, count, sizeof(uint16_t));
+}
+
+void dZoker::setUint32Array(const uint32_t* values, uint32_t count)
+{
+    setArray(ZokeType::Uint32Array, values, count, sizeof(uint32_t));
+}
+
+void dZoker::setUint64Array(const uint64_t* values, uint32_t count)
+{
+    setArray(ZokeType::Uint64Array, values, count, sizeof(uint64_t));
+}
+
+void dZoker::setFloat32Array(const float* values, uint32_t count)
+{
+    setArray(ZokeType::Float32Array, values, count, sizeof(float));
+}
+
+void dZoker::setFloat64Array(const double* values, uint32_t count)
+{
+    setArray(ZokeType::Float64Array, values, count, sizeof(double));
+}
+
+// 가변길이 정수처리
+static uint32_t varSize(uint32_t value)
+{
+    uint32_t Result = 1;
+    while(0 < (value >>= 7))
+        Result++;
+    return Result;
+}
+
+static dump* writeVar(dump* buffer, uint32_t value)
+{
+    bool NeedContinue = true;
+    do
     {
-        bool NeedContinue = true;
-        do
+        uint8_t OneVar = (value & 0x7F);
+        NeedContinue = (0 < (value >>= 7));
+        if(NeedContinue) OneVar |= 0x80;
+        *(buffer++) = (dump) OneVar;
+    }
+    while(NeedContinue);
+    return buffer;
+}
+
+static uint32_t jumperSize(uint32_t childlength)
+{
+    if(childlength < 0x100) return 1;
+    if(childlength < 0x10000) return 2;
+    if(childlength < 0x1000000) return 3;
+    return 4;
+}
+
+// 배열타입의 원소크기(배열이 아니면 0)
+static uint32_t arrayElementSize(ZokeType type)
+{
+    switch(type)
+    {
+    case ZokeType::Int8Array: case ZokeType::Uint8Array: return 1;
+    case ZokeType::Int16Array: case ZokeType::Uint16Array: return 2;
+    case ZokeType::Int32Array: case ZokeType::Uint32Array: case ZokeType::Float32Array: return 4;
+    case ZokeType::Int64Array: case ZokeType::Uint64Array: case ZokeType::Float64Array: return 8;
+    default: break;
+    }
+    return 0;
+}
+
+// 해시색인 처리(점퍼규격의 플래그, 선형탐사표)
+static const uint32_t HashedFlag = 0x80;
+
+// 자식앞의 페이지정렬용 패딩
+static const dump PadByte = 0xFF;
+
+static uint32_t hashKey(dumps key, uint32_t length)
+{
+    uint32_t Result = 2166136261u; // FNV-1a
+    for(uint32_t i = 0; i < length; ++i)
+        Result = (Result ^ (uint8_t) key[i]) * 16777619u;
+    return Result;
+}
+
+static uint32_t hashBits(uint32_t count)
+{
+    // 점유율은 절반이하로
+    uint32_t Result = 1;
+    while((uint64_t(1) << Result) < uint64_t(count) * 2)
+        Result++;
+    return Result;
+}
+
+static uint32_t hashTableSize(uint32_t count)
+{
+    return 1 + ((4 + jumperSize(count)) << hashBits(count));
+}
+
+static void hashTableInit(dump* table, uint32_t count)
+{
+    const uint32_t Bits = hashBits(count);
+    table[0] = (dump) Bits; // 해시비트[1]
+    memset(&table[1], 0, (4 + jumperSize(count)) << Bits);
+}
+
+static void hashTableAdd(dump* table, uint32_t count, uint32_t index, uint32_t hash)
+{
+    const uint32_t IndexSize = jumperSize(count);
+    const uint32_t SlotSize = 4 + IndexSize;
+    const uint32_t Mask = (uint32_t(1) << (uint8_t) table[0]) - 1;
+    uint32_t Slot = hash & Mask;
+    while(true)
+    {
+        dump* CurSlot = &table[1 + SlotSize * Slot];
+        uint32_t Used = 0;
+        memcpy(&Used, &CurSlot[4], IndexSize);
+        if(Used == 0)
         {
-            uint8_t OneVar = (value & 0x7F);
-            NeedContinue = (0 < (value >>= 7));
-            if(NeedContinue) OneVar |= 0x80;
-            binary.add((dumps) &OneVar, 1);
+            const uint32_t IndexPlusOne = index + 1;
+            memcpy(CurSlot, &hash, 4); // key해시[4]
+            memcpy(&CurSlot[4], &IndexPlusOne, IndexSize); // 자식인덱스+1[I]
+            return;
         }
-        while(NeedContinue);
-    };
+        Slot = (Slot + 1) & Mask;
+    }
+}
+
+// 페이지정렬 조립버퍼
+class ZokePagerP
+{
+public:
+    inline size_t length() const {return mBuffer.size();}
+    inline dump* at(size_t offset) {return &mBuffer[offset];}
+    inline void truncate(size_t length) {mBuffer.resize(length);}
+
+    dump* reserve(size_t length)
+    {
+        const size_t OldLength = mBuffer.size();
+        mBuffer.resize(OldLength + length);
+        return &mBuffer[OldLength];
+    }
+
+    // 큰 토큰이 최소한보다 많은 페이지에 걸치게 되면 다음 페이지로
+    void align(uint64_t size)
+    {
+        if(size < mPageSize / 8)
+            return;
+        const uint64_t Offset = mBuffer.size() & (mPageSize - 1);
+        const uint64_t Pages = (Offset + size + mPageSize - 1) / mPageSize;
+        const uint64_t MinPages = (size + mPageSize - 1) / mPageSize;
+        if(MinPages < Pages)
+            mBuffer.resize(mBuffer.size() + size_t(mPageSize - Offset), PadByte);
+    }
+
+public:
+    ZokePagerP(uint32_t pagesize, uint32_t hashfrom) : mPageSize(pagesize), mHashFrom(hashfrom) {}
+    std::vector<dump> mBuffer;
+    const uint64_t mPageSize;
+    const uint32_t mHashFrom;
+};
+
+dBinary dZoker::buildPaged(uint32_t pagesize, uint32_t hashfrom) const
+{
+    DD_assert(0 < pagesize && (pagesize & (pagesize - 1)) == 0, "pagesize must be a power of 2.");
+    ZokePagerP Pager(pagesize, hashfrom);
+    Pager.mBuffer.reserve(measure(hashfrom)); // 패딩전의 크기로 배치를 판단
+    writePaged(Pager);
+    dump* NewBuffer = new dump[Pager.length()];
+    memcpy(NewBuffer, Pager.at(0), Pager.length());
+    return dBinary::fromInternal(NewBuffer, (uint32_t) Pager.length());
+}
+
+dBinary dZoker::diff(const dZokeReader& base, const dZokeReader& next)
+{
+    dZokeArena Arena;
+    dZoker Patch(Arena);
+    if(!diffToken(Patch, base.mBuffer, next.mBuffer))
+    {
+        Patch.clear();
+        Patch.valid(ZokeType::Nameable); // 빈 병합
+    }
+    return Patch.build();
+}
+
+// base를 next로 만드는 패치를 patch에 조립(바뀐게 없으면 false)
+bool dZoker::diffToken(dZoker& patch, dumps base, dumps next)
+{
+    dumps BaseEnd = dZokeReader::tokenEnd(base);
+    dumps NextEnd = dZokeReader::tokenEnd(next);
+    const uint32_t NextLength = uint32_t(NextEnd - next);
+    if(uint32_t(BaseEnd - base) == NextLength && !memcmp(base, next, NextLength))
+        return false;
+
+    // 같은 타입의 group은 바뀐 자식만 병합
+    const ZokeType Type = (ZokeType) next[0];
+    if(Type == (ZokeType) base[0] && (Type == ZokeType::Nameable || Type == ZokeType::Indexable))
+    {
+        patch.valid(ZokeType::Nameable);
+        dumps BaseTemp = &base[1];
+        dumps NextTemp = &next[1];
+        const uint32_t BaseCount = dZokeReader::readVar(BaseTemp);
+        const uint32_t NextCount = dZokeReader::readVar(NextTemp);
+        const uint32_t BaseJumperSize = *(BaseTemp++) & ~HashedFlag;
+        const uint32_t NextJumperSize = *(NextTemp++) & ~HashedFlag;
+        auto Replace = [](dZoker& entry, dumps token)->void
+        {
+            entry.valid(ZokeType::Indexable);
+            entry.atAdding().setToken(token, uint32_t(dZokeReader::tokenEnd(token) - token));
+        };
+
+        if(Type == ZokeType::Nameable)
+        {
+            // 양쪽 모두 key의 오름차순이므로 병합조인
+            uint32_t BaseIndex = 0, NextIndex = 0;
+            while(BaseIndex < BaseCount || NextIndex < NextCount)
+            {
+                utf8s BaseKey = (BaseIndex < BaseCount)? (utf8s) dZokeReader::jumpTo(BaseTemp, BaseIndex, BaseJumperSize) : nullptr;
+                utf8s NextKey = (NextIndex < NextCount)? (utf8s) dZokeReader::jumpTo(NextTemp, NextIndex, NextJumperSize) : nullptr;
+                const int Compare = (!NextKey)? -1 : (!BaseKey)? 1 : strcmp(BaseKey, NextKey);
+                if(Compare < 0) // 삭제
+                {
+                    patch(BaseKey).valid(ZokeType::Indexable);
+                    BaseIndex++;
+                }
+                else if(0 < Compare) // 추가
+                {
+                    Replace(patch(NextKey), (dumps) NextKey + strlen(NextKey) + 1);
+                    NextIndex++;
+                }
+                else
+                {
+                    dZoker Entry;
+                    Entry.mArena = patch.mArena;
+                    if(diffToken(Entry, (dumps) BaseKey + strlen(BaseKey) + 1, (dumps) NextKey + strlen(NextKey) + 1))
+                        patch(NextKey) = DD_rvalue(Entry);
+                    BaseIndex++;
+                    NextIndex++;
+                }
+            }
+        }
+        else
+        {
+            // 같은 인덱스끼리 비교하며 key는 10진수 인덱스
+            char Key[16];
+            for(uint32_t i = 0, iEnd = std::max(BaseCount, NextCount); i < iEnd; ++i)
+            {
+                snprintf(Key, sizeof(Key), "%u", i);
+                if(NextCount <= i)
+                    patch(Key).valid(ZokeType::Indexable);
+                else if(BaseCount <= i)
+                    Replace(patch(Key), dZokeReader::jumpTo(NextTemp, i, NextJumperSize));
+                else
+                {
+                    dZoker Entry;
+                    Entry.mArena = patch.mArena;
+                    if(diffToken(Entry, dZokeReader::jumpTo(BaseTemp, i, BaseJumperSize), dZokeReader::jumpTo(NextTemp, i, NextJumperSize)))
+                        patch(Key) = DD_rvalue(Entry);
+                }
+            }
+        }
+
+        // 자식들이 모두 같으면(점퍼규격이나 해시색인만 다름) 바뀐게 없음
+        if(patch.mValue.mNameablePtr->empty())
+            return false;
+        // 병합이 교체보다 작을때만 병합으로
+        if(patch.measure(0) < 3 + jumperSize(NextLength) + NextLength)
+            return true;
+        patch.clear();
+    }
+
+    // 교체
+    patch.valid(ZokeType::Indexable);
+    patch.atAdding().setToken(next, NextLength);
+    return true;
+}
+
+dBinary dZoker::build(uint32_t hashfrom) const
+{
+    const uint32_t Length = measure(hashfrom);
+    dump* NewBuffer = new dump[Length];
+    write(NewBuffer, hashfrom);
+    return dBinary::fromInternal(NewBuffer, Length);
+}
+
+uint32_t dZoker::buildInto(dump* buffer, uint32_t cap, uint32_t hashfrom) const
+{
+    const uint32_t Length = measure(hashfrom);
+    if(Length <= cap)
+        write(buffer, hashfrom);
+    return Length;
+}
+
+uint32_t dZoker::measure(uint32_t hashfrom) const
+{
+    // 하위부터 크기를 확정하며 노드마다 기록
+    uint32_t Result = 1; // 타입[1]
+    switch(mType)
+    {
+    case ZokeType::Max: // 인코딩된 토큰
+        bytes(&Result);
+        break;
+    case ZokeType::Nameable:
+    case ZokeType::Indexable:
+        {
+            uint32_t ChildCount = 0, ChildLength = 0;
+            if(mType == ZokeType::Nameable)
+            {
+                for(const auto& it : *mValue.mNameablePtr)
+                    ChildLength += uint32_t(it.first.length() + 1) + it.second.measure(hashfrom); // key토큰 + 하위
+                ChildCount = (uint32_t) mValue.mNameablePtr->size();
+            }
+            else
+            {
+                for(const auto& it : *mValue.mIndexablePtr)
+                    ChildLength += it.second.measure(hashfrom);
+                ChildCount = (uint32_t) mValue.mIndexablePtr->size();
+            }
+            const bool Hashed = (mType == ZokeType::Nameable && 0 < hashfrom && hashfrom <= ChildCount);
+            const uint32_t TableLength = (Hashed)? hashTableSize(ChildCount) : 0;
+            Result += varSize(ChildCount) + 1 + jumperSize(TableLength + ChildLength) * ChildCount + TableLength + ChildLength;
+        }
+        break;
+    case ZokeType::String:
+        {
+            uint32_t ValueSize = 0;
+            bytes(&ValueSize);
+            Result += varSize(ValueSize + 1) + ValueSize + 1;
+        }
+        break;
+    case ZokeType::Binary:
+        {
+            uint32_t ValueSize = 0;
+            bytes(&ValueSize);
+            Result += varSize(ValueSize) + ValueSize;
+        }
+        break;
+    case ZokeType::Int8Array: case ZokeType::Int16Array: case ZokeType::Int32Array: case ZokeType::Int64Array:
+    case ZokeType::Uint8Array: case ZokeType::Uint16Array: case ZokeType::Uint32Array: case ZokeType::Uint64Array:
+    case ZokeType::Float32Array: case ZokeType::Float64Array:
+        {
+            uint32_t ArrayLength = 0;
+            bytes(&ArrayLength);
+            Result += varSize(ArrayLength / arrayElementSize(mType)) + ArrayLength;
+        }
+        break;
+    case ZokeType::Int8: case ZokeType::Uint8: Result += 1; break;
+    case ZokeType::Int16: case ZokeType::Uint16: Result += 2; break;
+    case ZokeType::Int32: case ZokeType::Uint32: case ZokeType::Float32: Result += 4; break;
+    case ZokeType::Int64: case ZokeType::Uint64: case ZokeType::Float64: Result += 8; break;
+    default: break;
+    }
+    return (mMeasured = Result);
+}
 
-    dBinary Collector;
-    Collector.add((dumps) &mType, 1); // 타입[1]
+dump* dZoker::write(dump* buffer, uint32_t hashfrom) const
+{
+    if(mType == ZokeType::Max)
+    {
+        uint32_t TokenLength = 0;
+        dumps Token = bytes(&TokenLength);
+        memcpy(buffer, Token, TokenLength); // 인코딩된 토큰[N]
+        return buffer + TokenLength;
+    }
+    *(buffer++) = (dump) mType; // 타입[1]
 
     // 하위
     if(mType == ZokeType::Nameable || mType == ZokeType::Indexable)
     {
-        // 재귀적 수집
-        std::map<int, dBinary> ChildCollector;
-        uint32_t BinaryLengthSum = 0;
-        if(mType == ZokeType::Nameable) // 네임방식
+        // 자식들의 크기는 measure에서 기록해둔 것을 사용
+        const uint32_t ChildCount = (uint32_t) ((mType == ZokeType::Nameable)?
+            mValue.mNameablePtr->size() : mValue.mIndexablePtr->size());
+        buffer = writeVar(buffer, ChildCount); // 자식수량[1+]
+        uint32_t ChildLength = 0;
+        if(mType == ZokeType::Nameable)
+        {
+            for(const auto& it : *mValue.mNameablePtr)
+                ChildLength += uint32_t(it.first.length() + 1) + it.second.mMeasured;
+        }
+        else for(const auto& it : *mValue.mIndexablePtr)
+            ChildLength += it.second.mMeasured;
+        const bool Hashed = (mType == ZokeType::Nameable && 0 < hashfrom && hashfrom <= ChildCount);
+        const uint32_t TableLength = (Hashed)? hashTableSize(ChildCount) : 0;
+        const uint32_t CurJumperSize = jumperSize(TableLength + ChildLength);
+        *(buffer++) = (dump) ((Hashed)? CurJumperSize | HashedFlag : CurJumperSize); // 점퍼규격[1]
+
+        // [점퍼:N]은 자기 위치로부터 자식까지의 거리
+        dump* Jumpers = buffer;
+        uint32_t Jumper = CurJumperSize * ChildCount + TableLength;
+        buffer += Jumper;
+        if(mType == ZokeType::Nameable)
         {
+            dump* Table = Jumpers + CurJumperSize * ChildCount;
+            if(Hashed)
+                hashTableInit(Table, ChildCount);
+            uint32_t ChildIndex = 0;
             for(const auto& it : *mValue.mNameablePtr)
             {
-                dBinary& ChildBinary = ChildCollector[(int) ChildCollector.size()];
-                // key토큰 선행추가
-                ChildBinary.add((dumps) it.first.c_str(), uint32_t(it.first.length() + 1)); // 스트링[N]
-                // 하위바이너리 수집
-                ChildBinary += it.second.build();
-                BinaryLengthSum += ChildBinary.length();
+                if(Hashed)
+                    hashTableAdd(Table, ChildCount, ChildIndex++, hashKey((dumps) it.first.c_str(), (uint32_t) it.first.length()));
+                memcpy(Jumpers, &Jumper, CurJumperSize);
+                Jumpers += CurJumperSize;
+                const uint32_t ChildSize = uint32_t(it.first.length() + 1) + it.second.mMeasured;
+                Jumper += ChildSize - CurJumperSize; // 점퍼 자신의 위치도 점점 뒤로 가니까
+                memcpy(buffer, it.first.c_str(), it.first.length() + 1); // key토큰[N]
+                buffer = it.second.write(buffer + it.first.length() + 1, hashfrom);
             }
         }
-        else if(mType == ZokeType::Indexable) // 인덱스방식
+        else
         {
             for(const auto& it : *mValue.mIndexablePtr)
             {
-                dBinary& ChildBinary = ChildCollector[(int) ChildCollector.size()];
-                // 하위바이너리 수집
-                ChildBinary = it.second.build();
-                BinaryLengthSum += ChildBinary.length();
+                memcpy(Jumpers, &Jumper, CurJumperSize);
+                Jumpers += CurJumperSize;
+                Jumper += it.second.mMeasured - CurJumperSize;
+                buffer = it.second.write(buffer, hashfrom);
             }
         }
+        return buffer;
+    }
 
-        // group토큰 선행추가
-        addVar(Collector, (uint32_t) ChildCollector.size()); // 자식수량[1+]
-        uint8_t JumperSize = 4;
-        if(BinaryLengthSum < 0x100) JumperSize = 1;
-        else if(BinaryLengthSum < 0x10000) JumperSize = 2;
-        else if(BinaryLengthSum < 0x1000000) JumperSize = 3;
-        Collector.add((dumps) &JumperSize, 1); // 점퍼규격[1]
-        uint32_t Jumper = uint32_t(JumperSize * ChildCollector.size());
-        for(const auto& it : ChildCollector)
+    // 자신
+    switch(mType)
+    {
+    case ZokeType::String:
+        {
+            uint32_t ValueSize = 0;
+            dumps Value = bytes(&ValueSize);
+            buffer = writeVar(buffer, ValueSize + 1); // 사이즈[1+]
+            memcpy(buffer, Value, ValueSize); // 스트링(null문자없음)[N - 1]
+            buffer[ValueSize] = 0; // null문자[1]
+            return buffer + ValueSize + 1;
+        }
+    case ZokeType::Binary:
+        {
+            uint32_t ValueSize = 0;
+            dumps Value = bytes(&ValueSize);
+            buffer = writeVar(buffer, ValueSize); // 사이즈[1+]
+            memcpy(buffer, Value, ValueSize); // 바이너리덤프[N]
+            return buffer + ValueSize;
+        }
+    case ZokeType::Int8Array: case ZokeType::Int16Array: case ZokeType::Int32Array: case ZokeType::Int64Array:
+    case ZokeType::Uint8Array: case ZokeType::Uint16Array: case ZokeType::Uint32Array: case ZokeType::Uint64Array:
+    case ZokeType::Float32Array: case ZokeType::Float64Array:
         {
-            Collector.add((dumps) &Jumper, JumperSize); // [점퍼:N]
-            Jumper += it.second.length() - JumperSize; // 점퍼 자신의 위치도 점점 뒤로 가니까
+            uint32_t ArrayLength = 0;
+            dumps Array = bytes(&ArrayLength);
+            buffer = writeVar(buffer, ArrayLength / arrayElementSize(mType)); // 원소수량[1+]
+            memcpy(buffer, Array, ArrayLength); // 원소들[L×크기]
+            return buffer + ArrayLength;
         }
+    case ZokeType::Int8: case ZokeType::Uint8: memcpy(buffer, &mValue.mWhole, 1); return buffer + 1; // 정수[1]
+    case ZokeType::Int16: case ZokeType::Uint16: memcpy(buffer, &mValue.mWhole, 2); return buffer + 2; // 정수[2]
+    case ZokeType::Int32: case ZokeType::Uint32: case ZokeType::Float32: memcpy(buffer, &mValue.mWhole, 4); return buffer + 4; // 정수, 실수[4]
+    case ZokeType::Int64: case ZokeType::Uint64: case ZokeType::Float64: memcpy(buffer, &mValue.mWhole, 8); return buffer + 8; // 정수, 실수[8]
+    default: break;
+    }
+    return buffer;
+}
 
-        // 하위바이너리 후행추가
-        for(const auto& it : ChildCollector)
-            Collector += it.second;
+void dZoker::writePaged(ZokePagerP& pager) const
+{
+    if(mType != ZokeType::Nameable && mType != ZokeType::Indexable)
+    {
+        write(pager.reserve(mMeasured), pager.mHashFrom);
+        return;
     }
-    else
+
+    // 패딩으로 점퍼가 커지면 점퍼규격을 늘려 이 그룹을 다시 조립
+    const uint32_t ChildCount = (uint32_t) ((mType == ZokeType::Nameable)?
+        mValue.mNameablePtr->size() : mValue.mIndexablePtr->size());
+    uint32_t ChildLength = 0;
+    if(mType == ZokeType::Nameable)
+    {
+        for(const auto& it : *mValue.mNameablePtr)
+            ChildLength += uint32_t(it.first.length() + 1) + it.second.mMeasured;
+    }
+    else for(const auto& it : *mValue.mIndexablePtr)
+        ChildLength += it.second.mMeasured;
+    const bool Hashed = (mType == ZokeType::Nameable && 0 < pager.mHashFrom && pager.mHashFrom <= ChildCount);
+    const uint32_t TableLength = (Hashed)? hashTableSize(ChildCount) : 0;
+    const size_t Start = pager.length();
+    for(uint32_t CurJumperSize = jumperSize(TableLength + ChildLength); CurJumperSize <= 4; ++CurJumperSize)
     {
-        // 자신
-        switch(mType)
+        pager.truncate(Start);
+        dump* Header = pager.reserve(1 + varSize(ChildCount) + 1);
+        *(Header++) = (dump) mType; // 타입[1]
+        Header = writeVar(Header, ChildCount); // 자식수량[1+]
+        *Header = (dump) ((Hashed)? CurJumperSize | HashedFlag : CurJumperSize); // 점퍼규격[1]
+        const size_t Jumpers = pager.length();
+        const size_t Table = Jumpers + CurJumperSize * ChildCount;
+        pager.reserve(CurJumperSize * ChildCount + TableLength);
+        if(Hashed)
+            hashTableInit(pager.at(Table), ChildCount);
+
+        // [점퍼:N]은 자기 위치로부터 (패딩뒤의)자식까지의 거리
+        uint32_t ChildIndex = 0;
+        auto BeginChild = [&](uint32_t childsize)->bool
         {
-        case ZokeType::String:
-            {
-                const uint32_t ValueSize = mValue.mStringPtr->length() + 1;
-                addVar(Collector, ValueSize); // 사이즈[1+]
-                Collector.add((dumps) mValue.mStringPtr->string(), ValueSize - 1); // 스트링(null문자없음)[N - 1]
-                Collector.add((dumps) "", 1); // null문자[1]
-            }
-            break;
-        case ZokeType::Binary:
+            pager.align(childsize);
+            const uint64_t Jumper = pager.length() - (Jumpers + CurJumperSize * ChildIndex);
+            if((Jumper >> (CurJumperSize * 8)) != 0)
+                return false;
+            memcpy(pager.at(Jumpers + CurJumperSize * ChildIndex), &Jumper, CurJumperSize);
+            return true;
+        };
+        bool Fitted = true;
+        if(mType == ZokeType::Nameable)
+        {
+            for(const auto& it : *mValue.mNameablePtr)
             {
-                const uint32_t ValueSize = mValue.mBinaryPtr->length();
-                addVar(Collector, ValueSize); // 사이즈[1+]
-                Collector.add(mValue.mBinaryPtr->buffer(), ValueSize); // 바이너리덤프[N]
+                const uint32_t KeySize = uint32_t(it.first.length() + 1);
+                if(!(Fitted = BeginChild(KeySize + it.second.mMeasured)))
+                    break;
+                if(Hashed)
+                    hashTableAdd(pager.at(Table), ChildCount, ChildIndex, hashKey((dumps) it.first.c_str(), KeySize - 1));
+                memcpy(pager.reserve(KeySize), it.first.c_str(), KeySize); // key토큰[N]
+                it.second.writePaged(pager);
+                ChildIndex++;
             }
-            break;
-        case ZokeType::Int8: Collector.add((dumps) &mValue.mInt8, 1); break; // 정수[1]
-        case ZokeType::Int16: Collector.add((dumps) &mValue.mInt16, 2); break; // 정수[2]
-        case ZokeType::Int32: Collector.add((dumps) &mValue.mInt32, 4); break; // 정수[4]
-        case ZokeType::Int64: Collector.add((dumps) &mValue.mInt64, 8); break; // 정수[8]
-        case ZokeType::Uint8: Collector.add((dumps) &mValue.mUint8, 1); break; // 부호없는 정수[1]
-        case ZokeType::Uint16: Collector.add((dumps) &mValue.mUint16, 2); break; // 부호없는 정수[2]
-        case ZokeType::Uint32: Collector.add((dumps) &mValue.mUint32, 4); break; // 부호없는 정수[4]
-        case ZokeType::Uint64: Collector.add((dumps) &mValue.mUint64, 8); break; // 부호없는 정수[8]
-        case ZokeType::Float32: Collector.add((dumps) &mValue.mFloat32, 4); break; // 실수[4]
-        case ZokeType::Float64: Collector.add((dumps) &mValue.mFloat64, 8); break; // 실수[8]
-        default: break;
         }
+        else for(const auto& it : *mValue.mIndexablePtr)
+        {
+            if(!(Fitted = BeginChild(it.second.mMeasured)))
+                break;
+            it.second.writePaged(pager);
+            ChildIndex++;
+        }
+        if(Fitted)
+            return;
     }
-    return Collector;
+    DD_assert(false, "the zoke has exceeded 4GB.");
 }
 
 void dZoker::valid(ZokeType type)
 {
-    if(mType == ZokeType::Null)
+    if(mType == ZokeType::Null && mArena)
+    {
+        // 컨테이너와 노드는 아레나에, 값은 setBytes에서 아레나에
+        switch(mType = type)
+        {
+        case ZokeType::Nameable:
+            mValue.mNameablePtr = new(mArena->alloc(sizeof(NameableMap), alignof(NameableMap)))
+                NameableMap(NameableMap::allocator_type(mArena));
+            break;
+        case ZokeType::Indexable:
+            mValue.mIndexablePtr = new(mArena->alloc(sizeof(IndexableMap), alignof(IndexableMap)))
+                IndexableMap(IndexableMap::allocator_type(mArena));
+            break;
+        default: break;
+        }
+    }
+    else if(mType == ZokeType::Null)
     {
         switch(mType = type)
         {
@@ -239,7 +881,10 @@ void dZoker::valid(ZokeType type)
         case ZokeType::Indexable: mValue.mIndexablePtr = new IndexableMap(); break;
         case ZokeType::String: mValue.mStringPtr = new dString(); break;
         case ZokeType::Binary: mValue.mBinaryPtr = new dBinary(); break;
-        default: break;
+        default:
+            if(0 < arrayElementSize(type))
+                mValue.mArrayPtr = new dBinary();
+            break;
         }
     }
     else
@@ -253,47 +898,676 @@ void dZoker::valid(ZokeType type)
     }
 }
 
+void dZoker::setArray(ZokeType type, const void* values, uint32_t count, uint32_t size)
+{
+    valid(type);
+    if(mArena)
+        setBytes(values, count * size);
+    else
+    {
+        mValue.mArrayPtr->clear();
+        mValue.mArrayPtr->add((dumps) values, count * size);
+    }
+}
+
+void dZoker::setBytes(const void* bytes, uint32_t length)
+{
+    // 덮어쓰면 이전 값은 reset까지 아레나에 남음
+    dump* NewBytes = (dump*) mArena->alloc(4 + length, 4);
+    memcpy(NewBytes, &length, 4); // 길이[4]
+    memcpy(NewBytes + 4, bytes, length); // 바이트[N]
+    mValue.mBytesPtr = NewBytes;
+}
+
+void dZoker::setToken(dumps token, uint32_t length)
+{
+    // 인코딩된 토큰을 그대로 보관(아레나조커만, 조크델타의 조립용)
+    DD_assert(mArena, "only arena zokers can hold a raw token.");
+    valid(ZokeType::Max);
+    setBytes(token, length);
+}
+
+dumps dZoker::bytes(uint32_t* length) const
+{
+    if(mArena)
+    {
+        if(!mValue.mBytesPtr)
+        {
+            *length = 0;
+            return (dumps) "";
+        }
+        memcpy(length, mValue.mBytesPtr, 4);
+        return mValue.mBytesPtr + 4;
+    }
+    switch(mType)
+    {
+    case ZokeType::String: *length = mValue.mStringPtr->length(); return (dumps) mValue.mStringPtr->string();
+    case ZokeType::Binary: *length = mValue.mBinaryPtr->length(); return mValue.mBinaryPtr->buffer();
+    default: *length = mValue.mArrayPtr->length(); return mValue.mArrayPtr->buffer();
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ dZoker::escaper
 void dZoker::_init_(InitType type)
 {
     mType = ZokeType::Null;
+    mMeasured = 0;
+    mArena = nullptr;
     mValue.mWhole = 0;
 }
 
 void dZoker::_quit_()
 {
+    if(mArena) // 아레나의 reset으로 한번에 해제
+        return;
     switch(mType)
     {
     case ZokeType::Nameable: delete mValue.mNameablePtr; break;
     case ZokeType::Indexable: delete mValue.mIndexablePtr; break;
     case ZokeType::String: delete mValue.mStringPtr; break;
     case ZokeType::Binary: delete mValue.mBinaryPtr; break;
-    default: break;
+    default:
+        if(0 < arrayElementSize(mType))
+            delete mValue.mArrayPtr;
+        break;
     }
 }
 
 void dZoker::_move_(_self_&& rhs)
 {
     mType = DD_rvalue(rhs.mType);
+    mMeasured = 0;
+    mArena = DD_rvalue(rhs.mArena);
     mValue.mWhole = DD_rvalue(rhs.mValue.mWhole);
 }
 
 void dZoker::_copy_(const _self_& rhs)
 {
     mType = rhs.mType;
+    mMeasured = 0;
+    mArena = nullptr; // 복사본은 일반조커
+    if(rhs.mArena && (mType == ZokeType::String || mType == ZokeType::Binary || 0 < arrayElementSize(mType)))
+    {
+        uint32_t ValueSize = 0;
+        dumps Value = rhs.bytes(&ValueSize);
+        if(mType == ZokeType::String)
+            mValue.mStringPtr = new dString((utf8s_nn) Value, (int32_t) ValueSize);
+        else (mValue.mBinaryPtr = new dBinary())->add(Value, ValueSize);
+        return;
+    }
     switch(mType)
     {
     case ZokeType::Nameable: mValue.mNameablePtr = new NameableMap(*rhs.mValue.mNameablePtr); break;
     case ZokeType::Indexable: mValue.mIndexablePtr = new IndexableMap(*rhs.mValue.mIndexablePtr); break;
     case ZokeType::String: mValue.mStringPtr = new dString(*rhs.mValue.mStringPtr); break;
     case ZokeType::Binary: mValue.mBinaryPtr = new dBinary(*rhs.mValue.mBinaryPtr); break;
-    default: mValue.mWhole = rhs.mValue.mWhole; break;
+    default:
+        if(0 < arrayElementSize(mType))
+            mValue.mArrayPtr = new dBinary(*rhs.mValue.mArrayPtr);
+        else mValue.mWhole = rhs.mValue.mWhole;
+        break;
     }
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
+DD_passage_define_alone(dZoker, dZokeArena& arena)
+{
+    mType = ZokeType::Null;
+    mMeasured = 0;
+    mArena = (ZokeArenaP*) arena.mData;
+    mValue.mWhole = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dZokeArena
+void dZokeArena::reset()
+{
+    ((ZokeArenaP*) mData)->reset();
+}
+
+uint32_t dZokeArena::used() const
+{
+    return ((const ZokeArenaP*) mData)->used();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dZokeArena::escaper
+void dZokeArena::_init_(InitType type)
+{
+    if(type == InitType::Create)
+        mData = new ZokeArenaP();
+    else mData = nullptr;
+}
+
+void dZokeArena::_quit_()
+{
+    delete (ZokeArenaP*) mData;
+}
+
+void dZokeArena::_move_(_self_&& rhs)
+{
+    mData = rhs.mData;
+}
+
+void dZokeArena::_copy_(const _self_& rhs)
+{
+    DD_assert(false, "you have called an unused method.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ ZokeWriterP
+class ZokeWriterP
+{
+public:
+    void reset()
+    {
+        mBuffer.clear();
+        mGroups.clear();
+        mChildStarts.clear();
+        mKeyPending = false;
+    }
+
+    void beginGroup(ZokeType type, uint32_t count, bool hashed)
+    {
+        beginToken();
+        Group NewGroup;
+        NewGroup.mType = type;
+        NewGroup.mCount = count;
+        NewGroup.mTableLength = (hashed)? hashTableSize(count) : 0;
+        NewGroup.mWritten = 0;
+        NewGroup.mFirstChild = (uint32_t) mChildStarts.size();
+        NewGroup.mLastKey = 0;
+        NewGroup.mLastKeyLength = ~uint32_t(0);
+        // 점퍼는 우선 1바이트로 자리만 잡고 endGroup에서 채움
+        addByte((dump) type);
+        addVar(count);
+        addByte(1);
+        NewGroup.mTable = length();
+        mBuffer.resize(mBuffer.size() + count + NewGroup.mTableLength);
+        mGroups.push_back(NewGroup);
+    }
+
+    void endGroup()
+    {
+        DD_assert(!mGroups.empty() && !mKeyPending, "you have called a method at the wrong timing.");
+        const Group CurGroup = mGroups.back();
+        mGroups.pop_back();
+        DD_assert(CurGroup.mWritten == CurGroup.mCount, "the number of children does not match.");
+
+        // 점퍼규격은 자식합계로 정해지므로 1바이트를 넘으면 자식들을 한번만 밀어냄
+        const uint32_t TableBegin = CurGroup.mTable + CurGroup.mCount;
+        const uint32_t ChildLength = length() - TableBegin - CurGroup.mTableLength;
+        const uint32_t JumperSize = jumperSize(CurGroup.mTableLength + ChildLength);
+        const uint32_t Shift = CurGroup.mCount * (JumperSize - 1);
+        if(0 < Shift)
+        {
+            mBuffer.resize(mBuffer.size() + Shift);
+            memmove(&mBuffer[TableBegin + Shift], &mBuffer[TableBegin], CurGroup.mTableLength + ChildLength);
+        }
+        mBuffer[CurGroup.mTable - 1] = (dump) ((0 < CurGroup.mTableLength)? JumperSize | HashedFlag : JumperSize);
+
+        // 점퍼는 자기 위치로부터 자식까지의 거리
+        for(uint32_t i = 0; i < CurGroup.mCount; ++i)
+        {
+            const uint32_t JumperAt = CurGroup.mTable + i * JumperSize;
+            const uint32_t Jumper = mChildStarts[CurGroup.mFirstChild + i] + Shift - JumperAt;
+            memcpy(&mBuffer[JumperAt], &Jumper, JumperSize);
+        }
+
+        // 해시색인은 밀려난 key들로 채움
+        if(0 < CurGroup.mTableLength)
+        {
+            dump* Table = &mBuffer[TableBegin + Shift];
+            hashTableInit(Table, CurGroup.mCount);
+            for(uint32_t i = 0; i < CurGroup.mCount; ++i)
+            {
+                dumps CurKey = &mBuffer[mChildStarts[CurGroup.mFirstChild + i] + Shift];
+                hashTableAdd(Table, CurGroup.mCount, i, hashKey(CurKey, (uint32_t) strlen((utf8s) CurKey)));
+            }
+        }
+        mChildStarts.resize(CurGroup.mFirstChild);
+    }
+
+    void key(utf8s_nn key, uint32_t length)
+    {
+        DD_assert(!mGroups.empty() && mGroups.back().mType == ZokeType::Nameable && !mKeyPending,
+            "you have called a method at the wrong timing.");
+        Group& CurGroup = mGroups.back();
+        DD_assert(CurGroup.mWritten < CurGroup.mCount, "the number of children does not match.");
+        #if DD_BUILD_DEBUG
+            // 해석기가 이진탐색하므로 오름차순만 허용
+            if(CurGroup.mLastKeyLength != ~uint32_t(0))
+            {
+                DD_assert(0 < length && std::lexicographical_compare(&mBuffer[CurGroup.mLastKey],
+                    &mBuffer[CurGroup.mLastKey] + CurGroup.mLastKeyLength, (dumps) key, (dumps) key + length),
+                    "keys must be added in ascending order.");
+            }
+        #endif
+        CurGroup.mLastKey = this->length();
+        CurGroup.mLastKeyLength = length;
+        CurGroup.mWritten++;
+        mChildStarts.push_back(this->length());
+        addBytes((dumps) key, length);
+        addByte(0);
+        mKeyPending = true;
+    }
+
+    void value(ZokeType type, dumps value, uint32_t length)
+    {
+        beginToken();
+        addByte((dump) type);
+        addBytes(value, length);
+    }
+
+    void sizedValue(ZokeType type, dumps value, uint32_t length, bool nullchar)
+    {
+        beginToken();
+        addByte((dump) type);
+        addVar((nullchar)? length + 1 : length);
+        addBytes(value, length);
+        if(nullchar)
+            addByte(0);
+    }
+
+    void arrayValue(ZokeType type, dumps values, uint32_t count, uint32_t size)
+    {
+        beginToken();
+        addByte((dump) type);
+        addVar(count);
+        addBytes(values, count * size);
+    }
+
+public:
+    inline dumps buffer() const
+    {return (mBuffer.empty())? (dumps) "" : &mBuffer[0];}
+    inline uint32_t length() const
+    {return (uint32_t) mBuffer.size();}
+
+private:
+    void beginToken()
+    {
+        if(mGroups.empty())
+            DD_assert(mBuffer.empty(), "zoke can only have one root.");
+        else if(mGroups.back().mType == ZokeType::Indexable)
+        {
+            Group& CurGroup = mGroups.back();
+            DD_assert(CurGroup.mWritten < CurGroup.mCount, "the number of children does not match.");
+            CurGroup.mWritten++;
+            mChildStarts.push_back(length());
+        }
+        else
+        {
+            DD_assert(mKeyPending, "nameable children must start with a key.");
+            mKeyPending = false;
+        }
+    }
+
+    inline void addByte(dump value)
+    {mBuffer.push_back(value);}
+
+    inline void addBytes(dumps value, uint32_t length)
+    {mBuffer.insert(mBuffer.end(), value, value + length);}
+
+    void addVar(uint32_t value)
+    {
+        bool NeedContinue = true;
+        do
+        {
+            uint8_t OneVar = (value & 0x7F);
+            NeedContinue = (0 < (value >>= 7));
+            if(NeedContinue) OneVar |= 0x80;
+            addByte((dump) OneVar);
+        }
+        while(NeedContinue);
+    }
+
+private:
+    struct Group
+    {
+        ZokeType mType;
+        uint32_t mCount;
+        uint32_t mWritten;
+        uint32_t mTable; // 점퍼테이블의 위치
+        uint32_t mTableLength; // 해시색인의 크기(없으면 0)
+        uint32_t mFirstChild; // mChildStarts에서 자기 자식들의 시작
+        uint32_t mLastKey; // 직전 key의 위치(순서확인용)
+        uint32_t mLastKeyLength;
+    };
+    std::vector<dump> mBuffer;
+    std::vector<Group> mGroups;
+    std::vector<uint32_t> mChildStarts; // 열린 그룹들의 자식위치
+    bool mKeyPending = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dZokeWriter
+void dZokeWriter::reset()
+{
+    ((ZokeWriterP*) mData)->reset();
+}
+
+void dZokeWriter::beginNameable(uint32_t count, bool hashed)
+{
+    ((ZokeWriterP*) mData)->beginGroup(ZokeType::Nameable, count, hashed);
+}
+
+void dZokeWriter::beginIndexable(uint32_t count)
+{
+    ((ZokeWriterP*) mData)->beginGroup(ZokeType::Indexable, count, false);
+}
+
+void dZokeWriter::endGroup()
+{
+    ((ZokeWriterP*) mData)->endGroup();
+}
+
+dZokeWriter& dZokeWriter::key(utf8s_nn key, int32_t length)
+{
+    ((ZokeWriterP*) mData)->key(key, (length == -1)? (uint32_t) strlen(key) : (uint32_t) length);
+    return *this;
+}
+
+dZokeWriter& dZokeWriter::key(const dLiteral& key)
+{
+    ((ZokeWriterP*) mData)->key(key.string(), key.length());
+    return *this;
+}
+
+void dZokeWriter::setString(utf8s_nn value, int32_t length)
+{
+    ((ZokeWriterP*) mData)->sizedValue(ZokeType::String, (dumps) value,
+        (length == -1)? (uint32_t) strlen(value) : (uint32_t) length, true);
+}
+
+void dZokeWriter::setString(const dLiteral& value)
+{
+    ((ZokeWriterP*) mData)->sizedValue(ZokeType::String, (dumps) value.string(), value.length(), true);
+}
+
+void dZokeWriter::setBinary(dumps value, uint32_t length)
+{
+    ((ZokeWriterP*) mData)->sizedValue(ZokeType::Binary, value, length, false);
+}
+
+void dZokeWriter::setBinary(const dBinary& value)
+{
+    ((ZokeWriterP*) mData)->sizedValue(ZokeType::Binary, value.buffer(), value.length(), false);
+}
+
+void dZokeWriter::setInt8(const int8_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Int8, (dumps) &value, 1);
+}
+
+void dZokeWriter::setInt16(const int16_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Int16, (dumps) &value, 2);
+}
+
+void dZokeWriter::setInt32(const int32_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Int32, (dumps) &value, 4);
+}
+
+void dZokeWriter::setInt64(const int64_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Int64, (dumps) &value, 8);
+}
+
+void dZokeWriter::setUint8(const uint8_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Uint8, (dumps) &value, 1);
+}
+
+void dZokeWriter::setUint16(const uint16_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Uint16, (dumps) &value, 2);
+}
+
+void dZokeWriter::setUint32(const uint32_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Uint32, (dumps) &value, 4);
+}
+
+void dZokeWriter::setUint64(const uint64_t value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Uint64, (dumps) &value, 8);
+}
+
+void dZokeWriter::setFloat32(const float value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Float32, (dumps) &value, 4);
+}
+
+void dZokeWriter::setFloat64(const double value)
+{
+    ((ZokeWriterP*) mData)->value(ZokeType::Float64, (dumps) &value, 8);
+}
+
+void dZokeWriter::setInt8Array(const int8_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Int8Array, (dumps) values, count, sizeof(int8_t));
+}
+
+void dZokeWriter::setInt16Array(const int16_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Int16Array, (dumps) values, count, sizeof(int16_t));
+}
+
+void dZokeWriter::setInt32Array(const int32_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Int32Array, (dumps) values, count, sizeof(int32_t));
+}
+
+void dZokeWriter::setInt64Array(const int64_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Int64Array, (dumps) values, count, sizeof(int64_t));
+}
+
+void dZokeWriter::setUint8Array(const uint8_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Uint8Array, (dumps) values, count, sizeof(uint8_t));
+}
+
+void dZokeWriter::setUint16Array(const uint16_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Uint16Array, (dumps) values, count, sizeof(uint16_t));
+}
+
+void dZokeWriter::setUint32Array(const uint32_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Uint32Array, (dumps) values, count, sizeof(uint32_t));
+}
+
+void dZokeWriter::setUint64Array(const uint64_t* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Uint64Array, (dumps) values, count, sizeof(uint64_t));
+}
+
+void dZokeWriter::setFloat32Array(const float* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Float32Array, (dumps) values, count, sizeof(float));
+}
+
+void dZokeWriter::setFloat64Array(const double* values, uint32_t count)
+{
+    ((ZokeWriterP*) mData)->arrayValue(ZokeType::Float64Array, (dumps) values, count, sizeof(double));
+}
+
+dumps dZokeWriter::buffer() const
+{
+    return ((const ZokeWriterP*) mData)->buffer();
+}
+
+uint32_t dZokeWriter::length() const
+{
+    return ((const ZokeWriterP*) mData)->length();
+}
+
+dBinary dZokeWriter::build() const
+{
+    dBinary Result;
+    Result.add(buffer(), length());
+    return Result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dZokeWriter::escaper
+void dZokeWriter::_init_(InitType type)
+{
+    if(type == InitType::Create)
+        mData = new ZokeWriterP();
+    else mData = nullptr;
+}
+
+void dZokeWriter::_quit_()
+{
+    delete (ZokeWriterP*) mData;
+}
+
+void dZokeWriter::_move_(_self_&& rhs)
+{
+    mData = rhs.mData;
+}
+
+void dZokeWriter::_copy_(const _self_& rhs)
+{
+    DD_assert(false, "you have called an unused method.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
 // ■ dZokeReader
+// 검증용 가변길이 정수(5바이트까지)
+static bool validVar(dumps& buffer, dumps end, uint32_t& value)
+{
+    value = 0;
+    for(uint32_t Shift = 0; Shift < 35 && buffer < end; Shift += 7)
+    {
+        const uint32_t OneVar = (uint8_t) *(buffer++);
+        value |= (OneVar & 0x7F) << Shift;
+        if(!(OneVar & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// 토큰 하나를 검증하고 토큰의 끝을 반환(실패시 nullptr)
+// 자식은 점퍼가 가리키는 곳이 직전 자식의 끝(패딩제외)과 같아야 하므로 모든 바이트를 한번씩만 봄
+dumps dZokeReader::validToken(dumps token, dumps end, uint32_t depth)
+{
+    if(end <= token)
+        return nullptr;
+    const ZokeType Type = (ZokeType) (uint8_t) token[0];
+    dumps Temp = &token[1];
+    const uint64_t Remain = uint64_t(end - Temp);
+    switch(Type)
+    {
+    case ZokeType::Null: return Temp;
+    case ZokeType::Int8: case ZokeType::Uint8: return (1 <= Remain)? Temp + 1 : nullptr;
+    case ZokeType::Int16: case ZokeType::Uint16: return (2 <= Remain)? Temp + 2 : nullptr;
+    case ZokeType::Int32: case ZokeType::Uint32: case ZokeType::Float32: return (4 <= Remain)? Temp + 4 : nullptr;
+    case ZokeType::Int64: case ZokeType::Uint64: case ZokeType::Float64: return (8 <= Remain)? Temp + 8 : nullptr;
+    case ZokeType::String:
+        {
+            uint32_t StringSize = 0;
+            if(!validVar(Temp, end, StringSize) || StringSize == 0 || uint64_t(end - Temp) < StringSize)
+                return nullptr;
+            return (Temp[StringSize - 1] == 0)? Temp + StringSize : nullptr; // null문자로 끝나야 함
+        }
+    case ZokeType::Binary:
+        {
+            uint32_t BinarySize = 0;
+            if(!validVar(Temp, end, BinarySize) || uint64_t(end - Temp) < BinarySize)
+                return nullptr;
+            return Temp + BinarySize;
+        }
+    case ZokeType::Nameable:
+    case ZokeType::Indexable:
+        {
+            if(depth == 0)
+                return nullptr;
+            uint32_t ChildCount = 0;
+            if(!validVar(Temp, end, ChildCount) || end <= Temp)
+                return nullptr;
+            const uint32_t JumperSpec = (uint8_t) *(Temp++);
+            const uint32_t JumperSize = JumperSpec & ~HashedFlag;
+            const bool Hashed = !!(JumperSpec & HashedFlag);
+            if(JumperSize < 1 || 4 < JumperSize || (Hashed && Type != ZokeType::Nameable)
+                || uint64_t(end - Temp) < uint64_t(JumperSize) * ChildCount)
+                return nullptr;
+            dumps Jumpers = Temp;
+            dumps Cursor = Temp + JumperSize * ChildCount;
+
+            // 해시색인은 범위안의 인덱스와 최소 하나의 빈칸(탐사의 종료)이 필요
+            if(Hashed)
+            {
+                if(end <= Cursor)
+                    return nullptr;
+                const uint32_t HashBits = (uint8_t) *Cursor;
+                const uint32_t IndexSize = jumperSize(ChildCount);
+                const uint64_t SlotSize = 4 + IndexSize;
+                if(30 < HashBits || uint64_t(end - Cursor - 1) < (SlotSize << HashBits))
+                    return nullptr;
+                bool HasEmpty = false;
+                for(uint64_t i = 0, iEnd = uint64_t(1) << HashBits; i < iEnd; ++i)
+                {
+                    uint32_t IndexPlusOne = 0;
+                    memcpy(&IndexPlusOne, &Cursor[1 + SlotSize * i + 4], IndexSize);
+                    if(IndexPlusOne == 0) HasEmpty = true;
+                    else if(ChildCount < IndexPlusOne)
+                        return nullptr;
+                }
+                if(!HasEmpty)
+                    return nullptr;
+                Cursor += 1 + (SlotSize << HashBits);
+            }
+
+            utf8s LastKey = nullptr;
+            for(uint32_t i = 0; i < ChildCount; ++i)
+            {
+                // 자식앞에는 패딩만 허용
+                dumps Child = jumpTo(Jumpers, i, JumperSize);
+                if(Child < Cursor || end <= Child)
+                    return nullptr;
+                while(Cursor < Child)
+                    if(*(Cursor++) != PadByte)
+                        return nullptr;
+                if(Type == ZokeType::Nameable)
+                {
+                    // key는 null문자로 끝나며 이진탐색을 위해 오름차순
+                    dumps KeyEnd = (dumps) memchr(Cursor, 0, end - Cursor);
+                    if(!KeyEnd || (LastKey && strcmp(LastKey, (utf8s) Cursor) >= 0))
+                        return nullptr;
+                    LastKey = (utf8s) Cursor;
+                    Cursor = KeyEnd + 1;
+                }
+                if(!(Cursor = validToken(Cursor, end, depth - 1)))
+                    return nullptr;
+            }
+            return Cursor;
+        }
+    default:
+        if(const uint32_t ElementSize = arrayElementSize(Type))
+        {
+            uint32_t ElementCount = 0;
+            if(!validVar(Temp, end, ElementCount) || uint64_t(end - Temp) < uint64_t(ElementCount) * ElementSize)
+                return nullptr;
+            return Temp + ElementCount * ElementSize;
+        }
+        break;
+    }
+    return nullptr;
+}
+
+const dZokeReader dZokeReader::validate(const dBinary& binary, uint32_t maxdepth)
+{
+    dumps Begin = binary.buffer();
+    dumps End = Begin + binary.length();
+    if(0 < binary.length() && validToken(Begin, End, maxdepth) == End)
+        return dZokeReader(binary);
+    return blank();
+}
+
 bool dZokeReader::isValid() const
 {
     return (mBuffer[0] != (dump) ZokeType::Null);
@@ -311,34 +1585,10 @@ uint32_t dZokeReader::length() const
 
 const dZokeReader dZokeReader::operator()(utf8s_nn key, int32_t length) const
 {
-    if(mBuffer[0] != (dump) ZokeType::Nameable)
-        return blank();
     if(length == -1)
         length = strlen(key);
-
-    dumps Temp = &mBuffer[1];
-    const uint32_t ChildCount = readVar(Temp);
-    const uint32_t JumperSize = *(Temp++);
-    DD_assert(0 < ChildCount, "ChildCount must be greater than zero.");
-
-    // 이진탐색
-    uint32_t Begin = 0, End = ChildCount - 1;
-    while(Begin <= End)
-    {
-        const uint32_t Middle = (Begin + End) / 2;
-        dumps CurKey = jumpTo(Temp, Middle, JumperSize);
-        const int Compare = strncmp((utf8s) CurKey, key, length);
-        const bool NullCheck = (CurKey[length] == 0);
-        if(Compare == 0)
-        {
-            if(NullCheck)
-                return dZokeReader(mBinary, CurKey + length + 1);
-            else End = Middle - 1;
-        }
-        else if(Compare < 0)
-            Begin = Middle + 1;
-        else End = Middle - 1;
-    }
+    if(dumps Found = findKey(mBuffer, key, length))
+        return dZokeReader(mBinary, Found);
     return blank();
 }
 
@@ -461,6 +1711,65 @@ double dZokeReader::getFloat64(const double def) const
     return *((double*) &mBuffer[1]);
 }
 
+const int8_t* dZokeReader::getInt8Array(uint32_t* count) const
+{
+    return (const int8_t*) getArray(ZokeType::Int8Array, count);
+}
+
+const int16_t* dZokeReader::getInt16Array(uint32_t* count) const
+{
+    return (const int16_t*) getArray(ZokeType::Int16Array, count);
+}
+
+const int32_t* dZokeReader::getInt32Array(uint32_t* count) const
+{
+    return (const int32_t*) getArray(ZokeType::Int32Array, count);
+}
+
+const int64_t* dZokeReader::getInt64Array(uint32_t* count) const
+{
+    return (const int64_t*) getArray(ZokeType::Int64Array, count);
+}
+
+const uint8_t* dZokeReader::getUint8Array(uint32_t* count) const
+{
+    return (const uint8_t*) getArray(ZokeType::Uint8Array, count);
+}
+
+const uint16_t* dZokeReader::getUint16Array(uint32_t* count) const
+{
+    return (const uint16_t*) getArray(ZokeType::Uint16Array, count);
+}
+
+const uint32_t* dZokeReader::getUint32Array(uint32_t* count) const
+{
+    return (const uint32_t*) getArray(ZokeType::Uint32Array, count);
+}
+
+const uint64_t* dZokeReader::getUint64Array(uint32_t* count) const
+{
+    return (const uint64_t*) getArray(ZokeType::Uint64Array, count);
+}
+
+const float* dZokeReader::getFloat32Array(uint32_t* count) const
+{
+    return (const float*) getArray(ZokeType::Float32Array, count);
+}
+
+const double* dZokeReader::getFloat64Array(uint32_t* count) const
+{
+    return (const double*) getArray(ZokeType::Float64Array, count);
+}
+
+dBinary dZokeReader::applyPatch(const dZokeReader& patch, uint32_t hashfrom) const
+{
+    // 바뀌지 않은 자식은 토큰을 그대로 옮기므로 패치된 경로만 다시 조립
+    dZokeArena Arena;
+    dZoker Result(Arena);
+    applyToken(Result, mBuffer, patch.mBuffer);
+    return Result.build(hashfrom);
+}
+
 uint32_t dZokeReader::readVar(dumps& buffer)
 {
     uint32_t Result = 0;
@@ -490,6 +1799,211 @@ dumps dZokeReader::jumpTo(dumps buffer, uint32_t index, uint32_t jumpersize)
     return nullptr;
 }
 
+dumps dZokeReader::findKey(dumps group, utf8s_nn key, uint32_t length)
+{
+    if(group[0] != (dump) ZokeType::Nameable)
+        return nullptr;
+
+    dumps Temp = &group[1];
+    const uint32_t ChildCount = readVar(Temp);
+    const uint32_t JumperSpec = (uint8_t) *(Temp++);
+    const uint32_t JumperSize = JumperSpec & ~HashedFlag;
+    if(ChildCount == 0) // 빈 그룹(검증된 외부 조크나 변경없는 diff)
+        return nullptr;
+
+    // 해시탐색
+    if(JumperSpec & HashedFlag)
+    {
+        dumps Table = Temp + JumperSize * ChildCount;
+        const uint32_t IndexSize = jumperSize(ChildCount);
+        const uint32_t SlotSize = 4 + IndexSize;
+        const uint32_t Mask = (uint32_t(1) << (uint8_t) Table[0]) - 1;
+        const uint32_t Hash = hashKey((dumps) key, length);
+        for(uint32_t Slot = Hash & Mask; ; Slot = (Slot + 1) & Mask)
+        {
+            dumps CurSlot = &Table[1 + SlotSize * Slot];
+            uint32_t IndexPlusOne = 0;
+            memcpy(&IndexPlusOne, &CurSlot[4], IndexSize);
+            if(IndexPlusOne == 0)
+                return nullptr;
+            if(!memcmp(CurSlot, &Hash, 4))
+            {
+                dumps CurKey = jumpTo(Temp, IndexPlusOne - 1, JumperSize);
+                if(!strncmp((utf8s) CurKey, key, length) && CurKey[length] == 0)
+                    return CurKey + length + 1;
+            }
+        }
+    }
+
+    // 이진탐색(첫 key보다 작은 경우를 위해 부호있는 범위)
+    int64_t Begin = 0, End = int64_t(ChildCount) - 1;
+    while(Begin <= End)
+    {
+        const int64_t Middle = (Begin + End) / 2;
+        dumps CurKey = jumpTo(Temp, (uint32_t) Middle, JumperSize);
+        const int Compare = strncmp((utf8s) CurKey, key, length);
+        const bool NullCheck = (CurKey[length] == 0);
+        if(Compare == 0)
+        {
+            if(NullCheck)
+                return CurKey + length + 1;
+            else End = Middle - 1;
+        }
+        else if(Compare < 0)
+            Begin = Middle + 1;
+        else End = Middle - 1;
+    }
+    return nullptr;
+}
+
+// 토큰의 끝(group은 마지막 자식만 따라가므로 깊이만큼)
+dumps dZokeReader::tokenEnd(dumps token)
+{
+    const ZokeType Type = (ZokeType) token[0];
+    dumps Temp = &token[1];
+    switch(Type)
+    {
+    case ZokeType::Int8: case ZokeType::Uint8: return Temp + 1;
+    case ZokeType::Int16: case ZokeType::Uint16: return Temp + 2;
+    case ZokeType::Int32: case ZokeType::Uint32: case ZokeType::Float32: return Temp + 4;
+    case ZokeType::Int64: case ZokeType::Uint64: case ZokeType::Float64: return Temp + 8;
+    case ZokeType::String:
+    case ZokeType::Binary:
+        {
+            const uint32_t ValueSize = readVar(Temp);
+            return Temp + ValueSize;
+        }
+    case ZokeType::Nameable:
+    case ZokeType::Indexable:
+        {
+            const uint32_t ChildCount = readVar(Temp);
+            const uint32_t JumperSpec = *(Temp++);
+            const uint32_t JumperSize = JumperSpec & ~HashedFlag;
+            if(ChildCount == 0)
+            {
+                if(JumperSpec & HashedFlag)
+                    return Temp + 1 + ((4 + jumperSize(0)) << *Temp);
+                return Temp;
+            }
+            dumps LastChild = jumpTo(Temp, ChildCount - 1, JumperSize);
+            if(Type == ZokeType::Nameable)
+                LastChild += strlen((utf8s) LastChild) + 1;
+            return tokenEnd(LastChild);
+        }
+    default:
+        if(const uint32_t ElementSize = arrayElementSize(Type))
+        {
+            const uint32_t ElementCount = readVar(Temp);
+            return Temp + ElementCount * ElementSize;
+        }
+        break;
+    }
+    return Temp;
+}
+
+// base에 patch를 적용하여 result에 조립(바뀌지 않은 자식은 토큰 그대로)
+void dZokeReader::applyToken(dZoker& result, dumps base, dumps patch)
+{
+    static const dump NullToken = (dump) ZokeType::Null;
+    const ZokeType BaseType = (ZokeType) base[0];
+    const ZokeType PatchType = (ZokeType) patch[0];
+    if(PatchType != ZokeType::Nameable && PatchType != ZokeType::Indexable)
+    {
+        result.setToken(base, uint32_t(tokenEnd(base) - base)); // 패치가 아니면 base그대로
+        return;
+    }
+    dumps PatchTemp = &patch[1];
+    const uint32_t PatchCount = readVar(PatchTemp);
+    const uint32_t PatchJumperSize = *(PatchTemp++) & ~HashedFlag;
+
+    // 교체(삭제는 호출자가 자식을 만들지 않는 것으로 처리)
+    if(PatchType == ZokeType::Indexable)
+    {
+        if(PatchCount == 1)
+        {
+            dumps NewToken = jumpTo(PatchTemp, 0, PatchJumperSize);
+            result.setToken(NewToken, uint32_t(tokenEnd(NewToken) - NewToken));
+        }
+        return;
+    }
+
+    // 병합
+    auto IsRemoval = [](dumps entry)->bool
+    {return (entry[0] == (dump) ZokeType::Indexable && entry[1] == 0);};
+    if(BaseType != ZokeType::Nameable && BaseType != ZokeType::Indexable)
+    {
+        result.setToken(base, uint32_t(tokenEnd(base) - base));
+        return;
+    }
+    dumps BaseTemp = &base[1];
+    const uint32_t BaseCount = readVar(BaseTemp);
+    const uint32_t BaseJumperSize = *(BaseTemp++) & ~HashedFlag;
+    result.valid(BaseType);
+
+    if(BaseType == ZokeType::Nameable)
+    {
+        // 양쪽 모두 key의 오름차순이므로 병합조인
+        uint32_t BaseIndex = 0, PatchIndex = 0;
+        while(BaseIndex < BaseCount || PatchIndex < PatchCount)
+        {
+            utf8s BaseKey = (BaseIndex < BaseCount)? (utf8s) jumpTo(BaseTemp, BaseIndex, BaseJumperSize) : nullptr;
+            utf8s PatchKey = (PatchIndex < PatchCount)? (utf8s) jumpTo(PatchTemp, PatchIndex, PatchJumperSize) : nullptr;
+            const int Compare = (!PatchKey)? -1 : (!BaseKey)? 1 : strcmp(BaseKey, PatchKey);
+            if(Compare < 0)
+            {
+                dumps BaseChild = (dumps) BaseKey + strlen(BaseKey) + 1;
+                result(BaseKey).setToken(BaseChild, uint32_t(tokenEnd(BaseChild) - BaseChild));
+                BaseIndex++;
+            }
+            else
+            {
+                dumps Entry = (dumps) PatchKey + strlen(PatchKey) + 1;
+                dumps BaseChild = (Compare == 0)? (dumps) BaseKey + strlen(BaseKey) + 1 : &NullToken;
+                if(!IsRemoval(Entry))
+                    applyToken(result(PatchKey), BaseChild, Entry);
+                if(Compare == 0) BaseIndex++;
+                PatchIndex++;
+            }
+        }
+    }
+    else
+    {
+        for(uint32_t i = 0; i < BaseCount; ++i)
+        {
+            dumps BaseChild = jumpTo(BaseTemp, i, BaseJumperSize);
+            result[i].setToken(BaseChild, uint32_t(tokenEnd(BaseChild) - BaseChild));
+        }
+        for(uint32_t i = 0; i < PatchCount; ++i)
+        {
+            utf8s PatchKey = (utf8s) jumpTo(PatchTemp, i, PatchJumperSize);
+            dumps Entry = (dumps) PatchKey + strlen(PatchKey) + 1;
+            const uint32_t Index = (uint32_t) strtoul(PatchKey, nullptr, 10);
+            if(IsRemoval(Entry))
+                result.mValue.mIndexablePtr->erase((int) Index); // 남은 자식들은 순서대로 당겨짐
+            else
+            {
+                dZoker& Child = result[Index];
+                Child.clear();
+                applyToken(Child, (Index < BaseCount)? jumpTo(BaseTemp, Index, BaseJumperSize) : &NullToken, Entry);
+            }
+        }
+    }
+}
+
+dumps dZokeReader::getArray(ZokeType type, uint32_t* count) const
+{
+    if(mBuffer[0] != (dump) type)
+    {
+        if(count) *count = 0;
+        return nullptr;
+    }
+
+    dumps Temp = &mBuffer[1];
+    const uint32_t ElementCount = readVar(Temp);
+    if(count) *count = ElementCount;
+    return Temp;
+}
+
 const dZokeReader& dZokeReader::blank()
 {DD_global_direct(dZokeReader, _); return _;}
 
@@ -526,4 +2040,378 @@ DD_passage_define_alone(dZokeReader, const dBinary& binary, dumps buffer), mBina
     mBuffer = buffer;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ ZokeDecoderP
+class ZokeDecoderP
+{
+public:
+    typedef dZokeDecoder::EventType EventType;
+
+public:
+    void reset()
+    {
+        mState = State::Token;
+        mStack.clear();
+        mKey.clear();
+        mVar = 0;
+        mVarShift = 0;
+        mScratchLength = 0;
+    }
+
+    bool feed(dumps chunk, uint32_t length, const dZokeDecoder::EventCB& cb)
+    {
+        mCB = &cb;
+        while(0 < length && mState != State::Done && mState != State::Broken)
+        {
+            switch(mState)
+            {
+            case State::Token:
+                if(*chunk != PadByte || mStack.empty()) // 자식앞의 패딩은 건너뜀
+                    onToken((ZokeType) (uint8_t) *chunk);
+                chunk++; length--; break;
+            case State::GroupCount: if(readVar(chunk, length)) {mCount = takeVar(); mState = State::GroupSpec;} break;
+            case State::GroupSpec: onGroupSpec((uint8_t) *chunk); chunk++; length--; break;
+            case State::SkipJumpers: if(skip(chunk, length)) {if(mHashed) mState = State::HashBits; else beginChildren();} break;
+            case State::HashBits: onHashBits((uint8_t) *chunk); chunk++; length--; break;
+            case State::SkipTable: if(skip(chunk, length)) beginChildren(); break;
+            case State::Key: onKey(chunk, length); break;
+            case State::Scalar: onScalar(chunk, length); break;
+            case State::ValueSize: if(readVar(chunk, length)) onValueSize(takeVar()); break;
+            case State::Payload: onPayload(chunk, length); break;
+            default: break;
+            }
+        }
+        mCB = nullptr;
+        if(0 < length) // 조크의 끝을 넘는 바이트
+            mState = State::Broken;
+        return (mState != State::Broken);
+    }
+
+    inline bool isDone() const
+    {return (mState == State::Done);}
+
+private:
+    void onToken(ZokeType type)
+    {
+        mType = type;
+        switch(type)
+        {
+        case ZokeType::Null: emit(EventType::Value, type, nullptr, 0); tokenDone(); break;
+        case ZokeType::Nameable: case ZokeType::Indexable: mState = State::GroupCount; break;
+        case ZokeType::String: case ZokeType::Binary: mElementSize = 1; mState = State::ValueSize; break;
+        case ZokeType::Int8: case ZokeType::Uint8: mScalarSize = 1; mState = State::Scalar; break;
+        case ZokeType::Int16: case ZokeType::Uint16: mScalarSize = 2; mState = State::Scalar; break;
+        case ZokeType::Int32: case ZokeType::Uint32: case ZokeType::Float32: mScalarSize = 4; mState = State::Scalar; break;
+        case ZokeType::Int64: case ZokeType::Uint64: case ZokeType::Float64: mScalarSize = 8; mState = State::Scalar; break;
+        default:
+            if(0 < (mElementSize = arrayElementSize(type)))
+                mState = State::ValueSize;
+            else mState = State::Broken;
+            break;
+        }
+    }
+
+    void onGroupSpec(uint32_t spec)
+    {
+        const uint32_t JumperSize = spec & ~HashedFlag;
+        if(JumperSize < 1 || 4 < JumperSize)
+        {
+            mState = State::Broken;
+            return;
+        }
+        mHashed = !!(spec & HashedFlag);
+        mSkip = uint64_t(JumperSize) * mCount;
+        if(mSkip == 0) // 빈 그룹은 건너뛸 것이 없으므로 바로(마지막 바이트일 수 있음)
+        {
+            if(mHashed)
+                mState = State::HashBits;
+            else beginChildren();
+        }
+        else mState = State::SkipJumpers;
+    }
+
+    void onHashBits(uint32_t bits)
+    {
+        mSkip = uint64_t(4 + jumperSize(mCount)) << bits;
+        if(mSkip == 0)
+            beginChildren();
+        else mState = State::SkipTable;
+    }
+
+    void beginChildren()
+    {
+        emit(EventType::GroupBegin, mType, nullptr, mCount);
+        if(mCount == 0)
+        {
+            emit(EventType::GroupEnd, mType, nullptr, 0);
+            tokenDone();
+            return;
+        }
+        mStack.push_back({mType, mCount});
+        mState = (mType == ZokeType::Nameable)? State::Key : State::Token;
+    }
+
+    void onKey(dumps& chunk, uint32_t& length)
+    {
+        if(mKey.empty() && *chunk == PadByte) // 자식앞의 패딩은 건너뜀
+        {
+            chunk++;
+            length--;
+            return;
+        }
+        dumps KeyEnd = (dumps) memchr(chunk, 0, length);
+        if(!KeyEnd) // 다음 청크로 이어지는 key
+        {
+            mKey.append((utf8s) chunk, length);
+            chunk += length;
+            length = 0;
+            return;
+        }
+        const uint32_t KeyLength = uint32_t(KeyEnd - chunk);
+        if(mKey.empty())
+            emit(EventType::Key, ZokeType::Null, chunk, KeyLength);
+        else
+        {
+            mKey.append((utf8s) chunk, KeyLength);
+            emit(EventType::Key, ZokeType::Null, (dumps) mKey.c_str(), (uint32_t) mKey.length());
+            mKey.clear();
+        }
+        chunk += KeyLength + 1;
+        length -= KeyLength + 1;
+        mState = State::Token;
+    }
+
+    void onScalar(dumps& chunk, uint32_t& length)
+    {
+        if(mScratchLength == 0 && mScalarSize <= length)
+        {
+            emit(EventType::Value, mType, chunk, mScalarSize);
+            chunk += mScalarSize;
+            length -= mScalarSize;
+            tokenDone();
+            return;
+        }
+        const uint32_t CopyLength = std::min(mScalarSize - mScratchLength, length);
+        memcpy(&mScratch[mScratchLength], chunk, CopyLength);
+        chunk += CopyLength;
+        length -= CopyLength;
+        if((mScratchLength += CopyLength) == mScalarSize)
+        {
+            mScratchLength = 0;
+            emit(EventType::Value, mType, mScratch, mScalarSize);
+            tokenDone();
+        }
+    }
+
+    void onValueSize(uint32_t size)
+    {
+        const uint64_t Total = uint64_t(size) * mElementSize;
+        if(0x7FFFFFFF < Total)
+        {
+            mState = State::Broken;
+            return;
+        }
+        mRemain = (uint32_t) Total;
+        emit(EventType::ValueBegin, mType, nullptr, mRemain);
+        if(mRemain == 0)
+        {
+            emit(EventType::ValueEnd, mType, nullptr, 0);
+            tokenDone();
+        }
+        else mState = State::Payload;
+    }
+
+    void onPayload(dumps& chunk, uint32_t& length)
+    {
+        // 배열의 원소는 잘라서 전달하지 않음
+        if(0 < mScratchLength)
+        {
+            const uint32_t CopyLength = std::min(mElementSize - mScratchLength, length);
+            memcpy(&mScratch[mScratchLength], chunk, CopyLength);
+            chunk += CopyLength;
+            length -= CopyLength;
+            if((mScratchLength += CopyLength) < mElementSize)
+                return;
+            mScratchLength = 0;
+            mRemain -= mElementSize;
+            emit(EventType::ValuePart, mType, mScratch, mElementSize);
+        }
+        else
+        {
+            uint32_t PartLength = std::min(mRemain, length);
+            PartLength -= PartLength % mElementSize;
+            if(0 < PartLength)
+            {
+                emit(EventType::ValuePart, mType, chunk, PartLength);
+                chunk += PartLength;
+                length -= PartLength;
+                mRemain -= PartLength;
+            }
+            else
+            {
+                memcpy(mScratch, chunk, length);
+                mScratchLength = length;
+                chunk += length;
+                length = 0;
+                return;
+            }
+        }
+        if(mRemain == 0)
+        {
+            emit(EventType::ValueEnd, mType, nullptr, 0);
+            tokenDone();
+        }
+    }
+
+    // 토큰 하나가 끝나면 부모그룹의 다음 자식이나 그룹의 끝으로
+    void tokenDone()
+    {
+        while(!mStack.empty())
+        {
+            Frame& Top = mStack.back();
+            if(0 < --Top.mRemaining)
+            {
+                mState = (Top.mType == ZokeType::Nameable)? State::Key : State::Token;
+                return;
+            }
+            emit(EventType::GroupEnd, Top.mType, nullptr, 0);
+            mStack.pop_back();
+        }
+        mState = State::Done;
+    }
+
+    bool readVar(dumps& chunk, uint32_t& length)
+    {
+        while(0 < length)
+        {
+            const uint32_t OneVar = (uint8_t) *(chunk++);
+            length--;
+            mVar |= (OneVar & 0x7F) << mVarShift;
+            if(!(OneVar & 0x80))
+                return true;
+            if(28 < (mVarShift += 7))
+            {
+                mState = State::Broken;
+                return false;
+            }
+        }
+        return false;
+    }
+
+    inline uint32_t takeVar()
+    {
+        const uint32_t Result = mVar;
+        mVar = 0;
+        mVarShift = 0;
+        return Result;
+    }
+
+    bool skip(dumps& chunk, uint32_t& length)
+    {
+        const uint32_t SkipLength = (uint32_t) std::min(mSkip, uint64_t(length));
+        chunk += SkipLength;
+        length -= SkipLength;
+        return ((mSkip -= SkipLength) == 0);
+    }
+
+    inline void emit(EventType event, ZokeType type, dumps data, uint32_t length)
+    {(*mCB)(event, type, data, length);}
+
+private:
+    enum class State {Token, GroupCount, GroupSpec, SkipJumpers, HashBits, SkipTable,
+        Key, Scalar, ValueSize, Payload, Done, Broken};
+    struct Frame
+    {
+        ZokeType mType;
+        uint32_t mRemaining; // 아직 끝나지 않은 자식수량
+    };
+    State mState = State::Token;
+    ZokeType mType = ZokeType::Null; // 해석중인 토큰
+    std::vector<Frame> mStack;
+    std::string mKey; // 청크경계에서 잘린 key
+    uint32_t mVar = 0;
+    uint32_t mVarShift = 0;
+    uint32_t mCount = 0;
+    bool mHashed = false;
+    uint64_t mSkip = 0;
+    uint32_t mScalarSize = 0;
+    uint32_t mElementSize = 1;
+    uint32_t mRemain = 0;
+    dump mScratch[8]; // 청크경계에서 잘린 정수/실수나 배열의 원소
+    uint32_t mScratchLength = 0;
+    const dZokeDecoder::EventCB* mCB = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dZokeDecoder
+void dZokeDecoder::reset()
+{
+    ((ZokeDecoderP*) mData)->reset();
+}
+
+bool dZokeDecoder::feed(dumps chunk, uint32_t length, EventCB cb)
+{
+    DD_assert(cb, "cb cannot be nullptr");
+    return ((ZokeDecoderP*) mData)->feed(chunk, length, cb);
+}
+
+bool dZokeDecoder::isDone() const
+{
+    return ((ZokeDecoderP*) mData)->isDone();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dZokeDecoder::escaper
+void dZokeDecoder::_init_(InitType type)
+{
+    if(type == InitType::Create)
+        mData = new ZokeDecoderP();
+    else mData = nullptr;
+}
+
+void dZokeDecoder::_quit_()
+{
+    delete (ZokeDecoderP*) mData;
+}
+
+void dZokeDecoder::_move_(_self_&& rhs)
+{
+    mData = rhs.mData;
+}
+
+void dZokeDecoder::_copy_(const _self_& rhs)
+{
+    DD_assert(false, "you have called an unused method.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ■ dZokeSchema
+dumps dZokeSchema::find(utf8s_nn key, uint32_t length, uint32_t rank) const
+{
+    // 같은 배치라면 정렬순위의 자식이 곧 해당 key
+    if(mSameLayout)
+    {
+        dumps CurKey = dZokeReader::jumpTo(mJumpers, rank, mJumperSize);
+        if(!strncmp((utf8s) CurKey, key, length) && CurKey[length] == 0)
+            return CurKey + length + 1;
+    }
+    return dZokeReader::findKey(mToken, key, length);
+}
+
+dZokeSchema::dZokeSchema(dumps token, uint32_t count)
+{
+    mToken = token;
+    mJumpers = nullptr;
+    mJumperSize = 0;
+    mSameLayout = false;
+    if(token && token[0] == (dump) ZokeType::Nameable)
+    {
+        dumps Temp = &token[1];
+        const uint32_t ChildCount = dZokeReader::readVar(Temp);
+        mJumperSize = (uint8_t) *(Temp++) & ~HashedFlag;
+        mJumpers = Temp;
+        mSameLayout = (ChildCount == count);
+    }
+}
+
 } // namespace Daddy
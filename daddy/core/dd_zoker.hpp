@@ -5,8 +5,10 @@
 
 // Dependencies
 #include "dd_binary.hpp"
+#include <cstring>
 #include <map>
 #include <string>
+#include <type_traits>
 
 namespace Daddy {
 
@@ -15,6 +17,8 @@ namespace Daddy {
 // ■ 토큰구조
 // - key:             [utf8스트링:N]
 // - group-nameable:  [타입:1][자식수량:1+ → L][점퍼규격:1 → N] + ([점퍼:N][점퍼:N]...L개)
+//                    점퍼규격에 0x80이 켜지면 점퍼들 뒤에 해시색인이 이어짐
+//                    [해시비트:1 → B] + ([key해시:4][자식인덱스+1:I]...2^B개, I는 L로 정한 점퍼규격)
 // - group-indexable: [타입:1][자식수량:1+ → L][점퍼규격:1 → N] + ([점퍼:N][점퍼:N]...L개)
 // - value-string:    [타입:1][사이즈:1+ → N][utf8스트링:N]
 // - value-binary:    [타입:1][사이즈:1+ → N][바이너리덤프:N]
@@ -28,6 +32,7 @@ namespace Daddy {
 // - value-uint64:    [타입:1][부호없는 정수:8]
 // - value-float32:   [타입:1][실수:4]
 // - value-float64:   [타입:1][실수:8]
+// - value-array:     [타입:1][원소수량:1+ → L][원소:L×크기] (int8array ~ float64array, 원소는 빈틈없이 연속)
 //
 // ■ 토큰관계성
 // - 시작토큰은       value/group만 OK
@@ -38,14 +43,61 @@ namespace Daddy {
 //
 // ■ 부연설명
 // - value는 원본 그대로 (파싱비용 ZERO, 스트링은 null포함)
-// - group은 점퍼라는 seek-table방식으로 하위접근 (nameable은 이진탐색)
+// - group은 점퍼라는 seek-table방식으로 하위접근 (nameable은 이진탐색, 해시색인이 있으면 해시탐색)
+// - 해시색인은 FNV-1a(32비트)를 쓰는 선형탐사표로 빈칸은 자식인덱스+1이 0
 // - "1+"는 가변길이 정수타입 (8비트중 7비트만 사용, 1비트는 연장플래그)
+// - array는 원소마다 타입과 점퍼가 붙는 indexable과 달리 헤더 하나에 원본배열 그대로 (포인터로 바로 사용)
+// - group의 자식(nameable은 key)앞에는 페이지정렬용 0xFF가 올 수 있음 (점퍼가 건너뛰며 key와 타입으로는 쓰이지 않는 값)
+//
+// ■ 패치조크 (dZoker::diff로 생성, dZokeReader::applyPatch로 적용)
+// - 병합:            group-nameable, 바뀐 자식만 key로 (대상이 indexable이면 key는 10진수 인덱스)
+// - 교체:            자식이 1개인 group-indexable, 그 자식이 새 토큰
+// - 삭제:            자식이 0개인 group-indexable
+// - 바뀐게 없으면 빈 병합이며, 병합이 교체보다 커지는 group은 교체로
 
 enum class ZokeType {Null,
     Nameable, Indexable, String, Binary,
     Int8, Int16, Int32, Int64,
     Uint8, Uint16, Uint32, Uint64,
-    Float32, Float64, Max};
+    Float32, Float64,
+    Int8Array, Int16Array, Int32Array, Int64Array,
+    Uint8Array, Uint16Array, Uint32Array, Uint64Array,
+    Float32Array, Float64Array, Max};
+
+class dZoker;
+class dZokeReader;
+class ZokeArenaP;
+class ZokePagerP;
+class ZokeKeyLessP;
+template<typename TYPE> class ZokeAllocatorP;
+
+/// @brief 조크아레나(조커트리의 노드, key, 값을 하나의 범프할당기에서 할당하고 한번에 해제)
+//
+// ■ 사용법
+// - dZoker Root(Arena)로 만든 루트는 자손, key, 값까지 모두 아레나에서 할당(개별 malloc/free없음)
+// - reset은 청크를 보존한채 커서만 되돌리므로 O(1), 틱마다 메시지를 만드는 루프에 적합
+// - reset전에 이 아레나로 만든 조커는 모두 사용을 마쳐야 함(아레나조커의 소멸은 아무것도 해제하지 않음)
+// - 아레나조커를 복사하면 일반조커가 되며, 아레나조커에 일반조커를 대입하면 그 부분은 reset으로 해제되지 않음
+class dZokeArena
+{
+public: // 사용성
+    /// @brief        할당한 조커, key, 값을 한번에 해제(청크는 재사용을 위해 보존)
+    void reset();
+
+    /// @brief        마지막 reset 이후의 할당량
+    /// @return       바이트수
+    uint32_t used() const;
+
+private:
+    friend class dZoker;
+
+DD_escaper_alone(dZokeArena): // 객체사이클
+    void _init_(InitType type);
+    void _quit_();
+    void _move_(_self_&& rhs);
+    void _copy_(const _self_& rhs);
+    ptr mData;
+};
 
 /// @brief 조크생성기
 class dZoker
@@ -141,21 +193,105 @@ public: // 사용성
     /// @param value  실수
     void setFloat64(const double value);
 
-    /// @brief        조크생성
-    /// @return       생성된 조크
-    dBinary build() const;
+    /// @brief        자신의 데이터 셋팅(int8_t배열)
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt8Array(const int8_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(int16_t배열)
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt16Array(const int16_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(int32_t배열)
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt32Array(const int32_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(int64_t배열)
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt64Array(const int64_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(uint8_t배열)
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint8Array(const uint8_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(uint16_t배열)
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint16Array(const uint16_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(uint32_t배열)
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint32Array(const uint32_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(uint64_t배열)
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint64Array(const uint64_t* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(float배열)
+    /// @param values 실수배열
+    /// @param count  원소수량
+    void setFloat32Array(const float* values, uint32_t count);
+
+    /// @brief        자신의 데이터 셋팅(double배열)
+    /// @param values 실수배열
+    /// @param count  원소수량
+    void setFloat64Array(const double* values, uint32_t count);
+
+    /// @brief          조크생성(크기를 먼저 계산해서 한번만 할당)
+    /// @param hashfrom 해시색인을 붙일 nameable의 최소 자식수(0이면 붙이지 않음)
+    /// @return         생성된 조크
+    dBinary build(uint32_t hashfrom = 0) const;
+
+    /// @brief          조크를 호출자의 버퍼에 생성
+    /// @param buffer   기록할 버퍼
+    /// @param cap      버퍼의 크기(모자라면 기록하지 않음)
+    /// @param hashfrom 해시색인을 붙일 nameable의 최소 자식수(0이면 붙이지 않음)
+    /// @return         조크의 바이트수(cap보다 크면 그만큼 확보후 재호출)
+    uint32_t buildInto(dump* buffer, uint32_t cap, uint32_t hashfrom = 0) const;
+
+    /// @brief          매핑해서 읽을 조크생성(큰 자식이 페이지경계에 불필요하게 걸치지 않도록 패딩)
+    /// @param pagesize 페이지크기(2의 승수, 이것의 1/8이상인 자식만 정렬)
+    /// @param hashfrom 해시색인을 붙일 nameable의 최소 자식수(0이면 붙이지 않음)
+    /// @return         생성된 조크
+    /// @see            dBinary::fromMappedFile
+    dBinary buildPaged(uint32_t pagesize = 4096, uint32_t hashfrom = 0) const;
+
+    /// @brief          두 조크의 차이를 패치조크로 생성(바뀐 경로만 담아 전송량 절감)
+    /// @param base     이전 조크
+    /// @param next     다음 조크
+    /// @return         base에 적용하면 next가 되는 패치조크
+    /// @see            dZokeReader::applyPatch
+    static dBinary diff(const dZokeReader& base, const dZokeReader& next);
 
 private:
-    typedef std::map<std::string, dZoker> NameableMap;
-    typedef std::map<int, dZoker> IndexableMap;
+    friend class dZokeReader;
+    typedef std::basic_string<char, std::char_traits<char>, ZokeAllocatorP<char>> Key;
+    typedef std::map<Key, dZoker, ZokeKeyLessP, ZokeAllocatorP<std::pair<const Key, dZoker>>> NameableMap;
+    typedef std::map<int, dZoker, std::less<int>, ZokeAllocatorP<std::pair<const int, dZoker>>> IndexableMap;
     void valid(ZokeType type);
+    void setArray(ZokeType type, const void* values, uint32_t count, uint32_t size);
+    void setBytes(const void* bytes, uint32_t length);
+    void setToken(dumps token, uint32_t length);
+    dumps bytes(uint32_t* length) const;
+    static bool diffToken(dZoker& patch, dumps base, dumps next);
+    uint32_t measure(uint32_t hashfrom) const;
+    dump* write(dump* buffer, uint32_t hashfrom) const;
+    void writePaged(ZokePagerP& pager) const;
 
 DD_escaper_alone(dZoker): // 객체사이클
     void _init_(InitType type);
     void _quit_();
     void _move_(_self_&& rhs);
     void _copy_(const _self_& rhs);
-    ZokeType mType;
+    ZokeType mType; // Max면 mBytesPtr가 인코딩된 토큰 그대로(setToken)
+    mutable uint32_t mMeasured; // measure가 기록한 바이트수(write가 점퍼계산에 재사용)
+    ZokeArenaP* mArena; // 아레나조커면 할당처(nullptr이면 일반조커)
     union
     {
         uint64_t mWhole;
@@ -163,6 +299,8 @@ DD_escaper_alone(dZoker): // 객체사이클
         IndexableMap* mIndexablePtr;
         dString* mStringPtr;
         dBinary* mBinaryPtr;
+        dBinary* mArrayPtr; // 배열의 원본바이트
+        dump* mBytesPtr; // 아레나조커의 스트링, 바이너리, 배열([길이:4][바이트:N])
         int8_t mInt8;
         int16_t mInt16;
         int32_t mInt32;
@@ -174,12 +312,186 @@ DD_escaper_alone(dZoker): // 객체사이클
         float mFloat32;
         double mFloat64;
     } mValue;
+
+public:
+    DD_passage_declare_alone(dZoker, dZokeArena& arena); // 아레나의 루트(arena가 먼저 소멸되면 안됨)
+};
+
+/// @brief 조크스트리밍생성기(트리없이 하나의 버퍼에 바로 기록, 버퍼는 메시지마다 재사용)
+//
+// ■ 사용법
+// - 그룹은 자식수량과 함께 begin하고, 자식들을 모두 기록후 end하면 점퍼테이블을 백패치
+// - nameable의 자식은 key로 시작하며 key는 오름차순으로(dZoker의 결과와 같은 바이트)
+// - 자식합계가 255바이트를 넘는 그룹만 점퍼확장을 위해 자신의 자식들을 1회 밀어냄
+// - 해시색인을 붙인 nameable은 dZoker::build(hashfrom)의 결과와 같은 바이트
+class dZokeWriter
+{
+public: // 사용성
+    /// @brief        내용 비우기(확보된 버퍼는 유지)
+    void reset();
+
+    /// @brief        네임방식 그룹시작
+    /// @param count  자식수량(endGroup전까지 정확히 이만큼 key로 추가)
+    /// @param hashed 해시색인 첨부여부(key가 많아 조회가 잦은 그룹용)
+    void beginNameable(uint32_t count, bool hashed = false);
+
+    /// @brief        인덱스방식 그룹시작
+    /// @param count  자식수량(endGroup전까지 정확히 이만큼 추가)
+    void beginIndexable(uint32_t count);
+
+    /// @brief        현재 그룹의 종료(점퍼테이블을 채움)
+    void endGroup();
+
+    /// @brief        네임방식 자식명 기록(이전 key보다 커야 함)
+    /// @param key    자식명
+    /// @param length 자식명의 길이(-1이면 끝까지)
+    /// @return       자기 객체(이어서 값이나 그룹을 기록)
+    dZokeWriter& key(utf8s_nn key, int32_t length = -1);
+
+    /// @brief        네임방식 자식명 기록(이전 key보다 커야 함)
+    /// @param key    자식명
+    /// @return       자기 객체(이어서 값이나 그룹을 기록)
+    dZokeWriter& key(const dLiteral& key);
+
+    /// @brief        String값 기록
+    /// @param value  스트링
+    /// @param length 스트링의 길이(-1이면 끝까지)
+    void setString(utf8s_nn value, int32_t length = -1);
+
+    /// @brief        String값 기록
+    /// @param value  스트링
+    void setString(const dLiteral& value);
+
+    /// @brief        Binary값 기록
+    /// @param value  바이너리덤프
+    /// @param length 바이너리덤프의 길이
+    void setBinary(dumps value, uint32_t length);
+
+    /// @brief        Binary값 기록
+    /// @param value  바이너리
+    void setBinary(const dBinary& value);
+
+    /// @brief        int8_t값 기록
+    /// @param value  정수
+    void setInt8(const int8_t value);
+
+    /// @brief        int16_t값 기록
+    /// @param value  정수
+    void setInt16(const int16_t value);
+
+    /// @brief        int32_t값 기록
+    /// @param value  정수
+    void setInt32(const int32_t value);
+
+    /// @brief        int64_t값 기록
+    /// @param value  정수
+    void setInt64(const int64_t value);
+
+    /// @brief        uint8_t값 기록
+    /// @param value  부호없는 정수
+    void setUint8(const uint8_t value);
+
+    /// @brief        uint16_t값 기록
+    /// @param value  부호없는 정수
+    void setUint16(const uint16_t value);
+
+    /// @brief        uint32_t값 기록
+    /// @param value  부호없는 정수
+    void setUint32(const uint32_t value);
+
+    /// @brief        uint64_t값 기록
+    /// @param value  부호없는 정수
+    void setUint64(const uint64_t value);
+
+    /// @brief        float값 기록
+    /// @param value  실수
+    void setFloat32(const float value);
+
+    /// @brief        double값 기록
+    /// @param value  실수
+    void setFloat64(const double value);
+
+    /// @brief        int8_t배열 기록
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt8Array(const int8_t* values, uint32_t count);
+
+    /// @brief        int16_t배열 기록
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt16Array(const int16_t* values, uint32_t count);
+
+    /// @brief        int32_t배열 기록
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt32Array(const int32_t* values, uint32_t count);
+
+    /// @brief        int64_t배열 기록
+    /// @param values 정수배열
+    /// @param count  원소수량
+    void setInt64Array(const int64_t* values, uint32_t count);
+
+    /// @brief        uint8_t배열 기록
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint8Array(const uint8_t* values, uint32_t count);
+
+    /// @brief        uint16_t배열 기록
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint16Array(const uint16_t* values, uint32_t count);
+
+    /// @brief        uint32_t배열 기록
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint32Array(const uint32_t* values, uint32_t count);
+
+    /// @brief        uint64_t배열 기록
+    /// @param values 부호없는 정수배열
+    /// @param count  원소수량
+    void setUint64Array(const uint64_t* values, uint32_t count);
+
+    /// @brief        float배열 기록
+    /// @param values 실수배열
+    /// @param count  원소수량
+    void setFloat32Array(const float* values, uint32_t count);
+
+    /// @brief        double배열 기록
+    /// @param values 실수배열
+    /// @param count  원소수량
+    void setFloat64Array(const double* values, uint32_t count);
+
+    /// @brief        기록된 조크의 버퍼(다음 reset까지 유효)
+    /// @return       버퍼의 주소
+    dumps buffer() const;
+
+    /// @brief        기록된 조크의 길이
+    /// @return       바이트수
+    uint32_t length() const;
+
+    /// @brief        기록된 조크의 복사본
+    /// @return       생성된 조크
+    dBinary build() const;
+
+DD_escaper_alone(dZokeWriter): // 객체사이클
+    void _init_(InitType type);
+    void _quit_();
+    void _move_(_self_&& rhs);
+    void _copy_(const _self_& rhs);
+    ptr mData;
 };
 
-/// @brief 조크해석기
+/// @brief 조크해석기(버퍼를 신뢰하므로 외부에서 온 조크는 validate로 한번 검증후 사용)
+/// @see   큰 정적데이터는 dZokeReader(dBinary::fromMappedFile(path))로 매핑해서 읽기(접근한 페이지만 로드)
 class dZokeReader
 {
 public: // 사용성
+    /// @brief          신뢰할 수 없는 조크의 구조검증(선형시간)
+    /// @param binary   조크
+    /// @param maxdepth 허용할 중첩깊이
+    /// @return         검증된 해석기(이후의 접근은 검사없이도 범위안), 실패시 허위객체
+    static const dZokeReader validate(const dBinary& binary, uint32_t maxdepth = 64);
+
     /// @brief        자신의 실존여부 확인
     /// @return       true-실존함, false-허위객체
     bool isValid() const;
@@ -266,9 +578,73 @@ public: // 사용성
     /// @return       자신의 double데이터
     double getFloat64(const double def = 0) const;
 
+    /// @brief        자신의 int8_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 int8_t배열(타입이 다르면 nullptr)
+    const int8_t* getInt8Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 int16_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 int16_t배열(타입이 다르면 nullptr)
+    const int16_t* getInt16Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 int32_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 int32_t배열(타입이 다르면 nullptr)
+    const int32_t* getInt32Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 int64_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 int64_t배열(타입이 다르면 nullptr)
+    const int64_t* getInt64Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 uint8_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 uint8_t배열(타입이 다르면 nullptr)
+    const uint8_t* getUint8Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 uint16_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 uint16_t배열(타입이 다르면 nullptr)
+    const uint16_t* getUint16Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 uint32_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 uint32_t배열(타입이 다르면 nullptr)
+    const uint32_t* getUint32Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 uint64_t배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 uint64_t배열(타입이 다르면 nullptr)
+    const uint64_t* getUint64Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 float배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 float배열(타입이 다르면 nullptr)
+    const float* getFloat32Array(uint32_t* count = nullptr) const;
+
+    /// @brief        자신의 double배열 반환(복사없이 조크내부를 참조)
+    /// @param count  필요시 원소수량 반환
+    /// @return       자신의 double배열(타입이 다르면 nullptr)
+    const double* getFloat64Array(uint32_t* count = nullptr) const;
+
+    /// @brief          패치조크를 적용한 새 조크 생성
+    /// @param patch    dZoker::diff로 만든 패치조크(외부에서 받았다면 validate를 거친 것)
+    /// @param hashfrom 해시색인을 붙일 nameable의 최소 자식수(0이면 붙이지 않음)
+    /// @return         패치가 적용된 조크
+    /// @see            dZoker::diff
+    dBinary applyPatch(const dZokeReader& patch, uint32_t hashfrom = 0) const;
+
 private:
+    friend class dZoker;
+    friend class dZokeSchema;
     static uint32_t readVar(dumps& buffer);
     static dumps jumpTo(dumps buffer, uint32_t index, uint32_t jumpersize);
+    static dumps findKey(dumps group, utf8s_nn key, uint32_t length);
+    static dumps validToken(dumps token, dumps end, uint32_t depth);
+    static dumps tokenEnd(dumps token);
+    static void applyToken(dZoker& result, dumps base, dumps patch);
+    dumps getArray(ZokeType type, uint32_t* count) const;
     static const dZokeReader& blank();
 
 DD_escaper_alone(dZokeReader): // 객체사이클
@@ -286,4 +662,230 @@ private:
     DD_passage_declare_alone(dZokeReader, const dBinary& binary, dumps buffer);
 };
 
+/// @brief 조크점진해석기(청크가 도착하는 대로 해석해서 이벤트로 전달)
+//
+// ■ 이벤트
+// - GroupBegin:      type(Nameable/Indexable), length는 자식수량
+// - GroupEnd:        type
+// - Key:             data/length는 key(null문자없음)
+// - Value:           type, data/length는 값(정수/실수, Null은 길이 0)
+// - ValueBegin:      type(String/Binary/배열), length는 값의 전체 바이트수(String은 null포함)
+// - ValuePart:       data/length는 값의 조각(배열은 원소단위로 끊어서 전달)
+// - ValueEnd:        type
+//
+// ■ 부연설명
+// - data는 콜백안에서만 유효 (청크를 직접 가리키거나 청크경계에서 잘린 토큰의 임시보관)
+// - 보관하는 것은 잘린 key/토큰헤더/원소 하나와 그룹스택뿐이므로 큰 조크도 메모리가 일정
+// - 점퍼와 해시색인은 순차해석에 필요없으므로 건너뜀
+class dZokeDecoder
+{
+public:
+    enum class EventType {GroupBegin, GroupEnd, Key, Value, ValueBegin, ValuePart, ValueEnd};
+    typedef std::function<void(EventType event, ZokeType type, dumps data, uint32_t length)> EventCB;
+
+public: // 사용성
+    /// @brief        새 조크의 해석준비
+    void reset();
+
+    /// @brief        도착한 청크의 해석
+    /// @param chunk  청크
+    /// @param length 청크의 길이
+    /// @param cb     이벤트를 받을 콜백
+    /// @return       true-정상, false-형식오류(이후 reset전까지 계속 false)
+    bool feed(dumps chunk, uint32_t length, EventCB cb);
+
+    /// @brief        조크의 끝까지 해석했는지 확인
+    /// @return       true-완료, false-청크가 더 필요함
+    bool isDone() const;
+
+DD_escaper_alone(dZokeDecoder): // 객체사이클
+    void _init_(InitType type);
+    void _quit_();
+    void _move_(_self_&& rhs);
+    void _copy_(const _self_& rhs);
+    ptr mData;
+};
+
+/// @brief 조크스키마의 그룹해석기(DD_zoke_schema가 사용)
+//
+// ■ 부연설명
+// - 자식수량이 스키마와 같으면 key의 정렬순위가 곧 자식인덱스이므로 탐색없이 점퍼로 직행
+// - 자식수량이 다르면(필드추가 등) 일반탐색으로 대체
+class dZokeSchema
+{
+public: // 사용성
+    /// @brief        nameable토큰 여부
+    /// @return       true-해석가능, false-nameable이 아님
+    inline bool isValid() const {return (mJumpers != nullptr);}
+
+    /// @brief        필드의 값토큰 찾기
+    /// @param key    필드명
+    /// @param length 필드명의 길이
+    /// @param rank   필드명의 정렬순위
+    /// @return       값토큰(없으면 nullptr)
+    dumps find(utf8s_nn key, uint32_t length, uint32_t rank) const;
+
+    /// @brief        두 key의 정렬순서 비교(컴파일타임)
+    /// @param a      좌항 key
+    /// @param b      우항 key
+    /// @return       true-a가 앞섬
+    static constexpr bool less(utf8s a, utf8s b)
+    {return (*a != 0 && *a == *b)? less(a + 1, b + 1) : ((uint8_t) *a < (uint8_t) *b);}
+
+    /// @brief        가변길이 정수 건너뛰기
+    /// @param buffer 가변길이 정수의 시작
+    /// @return       다음 위치
+    static inline dumps skipVar(dumps buffer)
+    {while(*(buffer++) & 0x80); return buffer;}
+
+public: // 객체사이클
+    /// @brief        생성자
+    /// @param token  nameable토큰
+    /// @param count  스키마의 필드수량
+    dZokeSchema(dumps token, uint32_t count);
+
+private:
+    dumps mToken;
+    dumps mJumpers;
+    uint32_t mJumperSize;
+    bool mSameLayout;
+};
+
+/// @brief 스키마필드의 타입별 처리(기본형은 하위스키마)
+template<typename TYPE>
+struct dZokeField
+{
+    static constexpr ZokeType Type = ZokeType::Nameable;
+    typedef typename TYPE::Reader Slot;
+    typedef const typename TYPE::Reader& Get;
+    typedef typename TYPE::Writer Value;
+    static inline bool bind(Slot& slot, dumps token) {return (token && slot.bind(token));}
+    static inline Get load(const Slot& slot) {return slot;}
+    static inline void store(dZokeWriter& writer, const Value& value) {value.write(writer);}
+};
+
+template<>
+struct dZokeField<utf8s>
+{
+    static constexpr ZokeType Type = ZokeType::String;
+    typedef dumps Slot;
+    typedef utf8s Get;
+    typedef utf8s Value;
+    static inline bool bind(Slot& slot, dumps token)
+    {
+        if(!token || token[0] != (dump) Type) return false;
+        slot = dZokeSchema::skipVar(token + 1);
+        return true;
+    }
+    static inline Get load(const Slot& slot) {return (utf8s) slot;}
+    static inline void store(dZokeWriter& writer, const Value& value) {writer.setString((value)? value : "");}
+};
+
+#define DD_zoke_field_(TYPE, NAME) \
+    template<> \
+    struct dZokeField<TYPE> \
+    { \
+        static constexpr ZokeType Type = ZokeType::NAME; \
+        typedef dumps Slot; \
+        typedef TYPE Get; \
+        typedef TYPE Value; \
+        static inline bool bind(Slot& slot, dumps token) \
+        { \
+            if(!token || token[0] != (dump) Type) return false; \
+            slot = token + 1; \
+            return true; \
+        } \
+        static inline Get load(const Slot& slot) {TYPE Result; memcpy(&Result, slot, sizeof(TYPE)); return Result;} \
+        static inline void store(dZokeWriter& writer, const Value& value) {writer.set##NAME(value);} \
+    }
+DD_zoke_field_(int8_t, Int8);
+DD_zoke_field_(int16_t, Int16);
+DD_zoke_field_(int32_t, Int32);
+DD_zoke_field_(int64_t, Int64);
+DD_zoke_field_(uint8_t, Uint8);
+DD_zoke_field_(uint16_t, Uint16);
+DD_zoke_field_(uint32_t, Uint32);
+DD_zoke_field_(uint64_t, Uint64);
+DD_zoke_field_(float, Float32);
+DD_zoke_field_(double, Float64);
+#undef DD_zoke_field_
+
 } // namespace Daddy
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ▶ DD_zoke_schema()
+//
+// 사용예시)   #define ADDRESS_FIELDS(FIELD) FIELD(utf8s, ip4) FIELD(uint16_t, port)
+//             DD_zoke_schema(AddressZ, ADDRESS_FIELDS);
+//
+//             #define CONNECTED_FIELDS(FIELD) FIELD(AddressZ, address) FIELD(int32_t, id)
+//             DD_zoke_schema(ConnectedZ, CONNECTED_FIELDS);
+//
+//             ConnectedZ::Writer NewWriter;                  // 쓰기: 필드는 그냥 멤버
+//             NewWriter.address.ip4 = "127.0.0.1";
+//             NewWriter.id = 1;
+//             NewWriter.write(ZokeWriter);                   // key의 정렬은 컴파일타임에 결정
+//
+//             ConnectedZ::Reader NewReader;                  // 읽기: 바인딩에서 모든 key/타입을 한번에 확인
+//             if(NewReader.bind(Binary))
+//                 NewReader.address().port();                // 이후로는 확인없는 직접로드
+//
+// - 필드타입은 정수/실수형, utf8s(String), 다른 스키마(nameable)
+// - 필드명은 key 그대로이므로 bind/write와 겹치지 않아야 함
+//
+#define DD_zoke_schema(NAME, FIELDS) \
+    struct NAME \
+    { \
+        enum Field : uint32_t {FIELDS(DD_zoke_schema_enum_) FieldCount}; \
+        static constexpr utf8s keyOf(uint32_t field) \
+        { \
+            const utf8s Keys[] = {FIELDS(DD_zoke_schema_key_)}; \
+            return Keys[field]; \
+        } \
+        static constexpr uint32_t rankOf(uint32_t field) \
+        { \
+            uint32_t Result = 0; \
+            for(uint32_t i = 0; i < FieldCount; ++i) \
+                if(Daddy::dZokeSchema::less(keyOf(i), keyOf(field))) \
+                    Result++; \
+            return Result; \
+        } \
+        \
+        class Reader \
+        { \
+        public: \
+            bool bind(const Daddy::dBinary& binary) {mBinary = binary; return bind(mBinary.buffer());} \
+            bool bind(Daddy::dumps token) \
+            { \
+                const Daddy::dZokeSchema Group(token, FieldCount); \
+                bool Result = Group.isValid(); \
+                FIELDS(DD_zoke_schema_bind_) \
+                return Result; \
+            } \
+            FIELDS(DD_zoke_schema_get_) \
+        private: \
+            Daddy::dBinary mBinary; \
+            FIELDS(DD_zoke_schema_slot_) \
+        }; \
+        \
+        struct Writer \
+        { \
+            FIELDS(DD_zoke_schema_value_) \
+            void write(Daddy::dZokeWriter& writer) const \
+            { \
+                writer.beginNameable(FieldCount); \
+                for(uint32_t Rank = 0; Rank < FieldCount; ++Rank) \
+                    switch(Rank) {FIELDS(DD_zoke_schema_write_) default: break;} \
+                writer.endGroup(); \
+            } \
+        }; \
+    }
+#define DD_zoke_schema_enum_(TYPE, NAME)  _##NAME##_,
+#define DD_zoke_schema_key_(TYPE, NAME)   #NAME,
+#define DD_zoke_schema_bind_(TYPE, NAME)  Result = Result && Daddy::dZokeField<TYPE>::bind(m_##NAME, \
+                                              Group.find(DD_string_pair(#NAME), std::integral_constant<uint32_t, rankOf(_##NAME##_)>::value));
+#define DD_zoke_schema_get_(TYPE, NAME)   inline Daddy::dZokeField<TYPE>::Get NAME() const {return Daddy::dZokeField<TYPE>::load(m_##NAME);}
+#define DD_zoke_schema_slot_(TYPE, NAME)  Daddy::dZokeField<TYPE>::Slot m_##NAME {};
+#define DD_zoke_schema_value_(TYPE, NAME) Daddy::dZokeField<TYPE>::Value NAME {};
+#define DD_zoke_schema_write_(TYPE, NAME) case rankOf(_##NAME##_): writer.key(DD_string_pair(#NAME)); \
+                                              Daddy::dZokeField<TYPE>::store(writer, NAME); break;
@@ -27,3 +27,7 @@ SOURCES += $$TOPPATH/core/dd_thread.cpp
 SOURCES += $$TOPPATH/core/dd_type.cpp
 SOURCES += $$TOPPATH/core/dd_unique.cpp
 SOURCES += $$TOPPATH/core/dd_zoker.cpp
+
+linux: LIBS += -lrt
+# 한 telekit에 여러 컴포넌트를 올릴때 라이브러리마다 싱글톤이 섞이지 않도록
+linux-g++*: QMAKE_CXXFLAGS += -fno-gnu-unique
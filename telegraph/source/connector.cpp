@@ -63,6 +63,13 @@ void Connector::SaveAddress(dZoker& saver) const
     saver("port").setUint16(mPort);
 }
 
+void Connector::SaveAddress(dTeleGate::Connected& saver) const
+{
+    for(sint32 i = 0; i < 4; ++i)
+        saver.mIP4[i] = (uint8_t) mIP4.ip[i];
+    saver.mPort = mPort;
+}
+
 static struct SelectInfo
 {
     const Connector* mConnector;
@@ -15,6 +15,7 @@ public:
     void SaveForClient(Context& saver) const;
     void InitAddress(const ip4address& ip4, const ip6address& ip6, uint16 port);
     void SaveAddress(dZoker& saver) const;
+    void SaveAddress(dTeleGate::Connected& saver) const;
     bool OnRender(ZayPanel& panel) const;
 
 public:
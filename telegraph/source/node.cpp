@@ -17,12 +17,26 @@ void Node::SetNodeID(chars nodeid)
     mPos.y = LoadContext("posy").GetFloat(0);
 }
 
+void Node::SetGateWire(id_server server, chars component, uint8_t version)
+{
+    // V10이후의 컴포넌트가 제안하면 수락하고 이후 바이너리로 통신
+    if(version == 0 || String::Compare(component, "V", 1) || Parser::GetInt(component + 1) < 10)
+        return;
+    mGateWire = (version < dTeleGate::Version)? version : (uint8_t) dTeleGate::Version;
+    const dTeleGate::Hello Fields = {mGateWire};
+    SendToPeer(server, dTeleGate::build(dTeleGate::OpType::Hello, &Fields, sizeof(Fields)));
+}
+
 void Node::SendToPeer(id_server server, const dZoker& zoker) const
 {
-    const dBinary NewZoke = zoker.build();
-    uint32_t Length = NewZoke.length();
+    SendToPeer(server, zoker.build());
+}
+
+void Node::SendToPeer(id_server server, const dBinary& binary) const
+{
+    uint32_t Length = binary.length();
     Platform::Server::SendToPeer(server, mPeerID, &Length, 4);
-    Platform::Server::SendToPeer(server, mPeerID, NewZoke.buffer(), Length);
+    Platform::Server::SendToPeer(server, mPeerID, binary.buffer(), Length);
 }
 
 Connector* Node::ConnectAdd(sint32 entryid, chars entrytype, chars protocol)
@@ -154,6 +168,14 @@ void Node::SendConnecting(id_server server, const Map<Node>& nodes, chars client
     const Node* Client = GetNodeFrom(nodes, client_connectorid, &ClientEntryID);
     const Connector* Server = Connector::FindPool(server_connectorid);
 
+    if(Client->mGateWire)
+    {
+        dTeleGate::Connected Fields;
+        Fields.mID = ClientEntryID;
+        Server->SaveAddress(Fields);
+        Client->SendToPeer(server, dTeleGate::build(dTeleGate::OpType::Connected, &Fields, sizeof(Fields)));
+        return;
+    }
     dZoker NewZoker;
     NewZoker("type").setString("connected");
     NewZoker("id").setInt32(ClientEntryID);
@@ -166,6 +188,12 @@ void Node::SendDisconnecting(id_server server, const Map<Node>& nodes, chars cli
     sint32 ClientEntryID = 0;
     const Node* Client = GetNodeFrom(nodes, client_connectorid, &ClientEntryID);
 
+    if(Client->mGateWire)
+    {
+        const dTeleGate::Disconnected Fields = {ClientEntryID};
+        Client->SendToPeer(server, dTeleGate::build(dTeleGate::OpType::Disconnected, &Fields, sizeof(Fields)));
+        return;
+    }
     dZoker NewZoker;
     NewZoker("type").setString("disconnected");
     NewZoker("id").setInt32(ClientEntryID);
@@ -177,7 +205,10 @@ void Node::SendDisconnecting(id_server server, const Map<Node>& nodes, chars cli
 void Node::_init_(InitType type)
 {
     if(type == InitType::Create)
+    {
         mPeerID = -1;
+        mGateWire = 0;
+    }
 }
 
 void Node::_quit_()
@@ -196,6 +227,7 @@ void Node::_quit_()
 void Node::_move_(_self_&& rhs)
 {
     mPeerID = DD_rvalue(rhs.mPeerID);
+    mGateWire = DD_rvalue(rhs.mGateWire);
     mNodeID = DD_rvalue(rhs.mNodeID);
     mConnectors = DD_rvalue(rhs.mConnectors);
     mPos = DD_rvalue(rhs.mPos);
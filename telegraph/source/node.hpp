@@ -10,7 +10,9 @@ class Node
 public:
     void SetPeerID(sint32 peerid);
     void SetNodeID(chars nodeid);
+    void SetGateWire(id_server server, chars component, uint8_t version);
     void SendToPeer(id_server server, const dZoker& zoker) const;
+    void SendToPeer(id_server server, const dBinary& binary) const;
     Connector* ConnectAdd(sint32 entryid, chars entrytype, chars protocol);
     void ConnectSub(sint32 entryid);
     void MoveServerConnectors(float addx, float addy) const;
@@ -34,6 +36,7 @@ DD_escaper_alone(Node):
     void _move_(_self_&& rhs);
     void _copy_(const _self_& rhs);
     sint32 mPeerID;
+    uint8_t mGateWire; // 노드와 합의한 바이너리 프로토콜버전(0이면 zoke)
     String mNodeID;
     Connectors mConnectors;
     mutable Point mPos;
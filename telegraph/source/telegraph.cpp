@@ -6,6 +6,50 @@
 
 ZAY_DECLARE_VIEW_CLASS("telegraphView", telegraphData)
 
+// 바이너리 프로토콜로 합의한 노드의 메시지
+static void OnGateMessage(id_server server, Node& node, dTeleGate::OpType type, const dBinary& message)
+{
+    switch(type)
+    {
+    case dTeleGate::OpType::Node:
+        node.SetNodeID(dTeleGate::tailOf(message, 0));
+        break;
+    case dTeleGate::OpType::ConnectAdd:
+        if(auto Fields = dTeleGate::fieldsOf<dTeleGate::ConnectAdd>(message))
+        {
+            if(auto ServerConnector = node.ConnectAdd(Fields->mID,
+                (Fields->mEntry == dTeleGate::EntryType::Server)? "server" : "client",
+                dTeleGate::tailOf(message, sizeof(dTeleGate::ConnectAdd))))
+            {
+                ip4address IP4;
+                ip6address IP6;
+                if(Platform::Server::GetPeerInfo(server, node.peerid(), &IP4, &IP6))
+                    ServerConnector->InitAddress(IP4, IP6, Fields->mPort);
+            }
+        }
+        break;
+    case dTeleGate::OpType::ConnectSub:
+        if(auto Fields = dTeleGate::fieldsOf<dTeleGate::ConnectSub>(message))
+            node.ConnectSub(Fields->mID);
+        break;
+    // 개발전용
+    case dTeleGate::OpType::Toast:
+        node.SetToast(dTeleGate::tailOf(message, 0));
+        break;
+    case dTeleGate::OpType::SilkStats:
+        {
+            auto Stats = dTeleGate::fieldsOf<dTeleGate::SilkStat>(message);
+            const uint32_t Count = (message.length() - sizeof(dTeleGate::Head)) / sizeof(dTeleGate::SilkStat);
+            for(uint32_t i = 0; Stats && i < Count; ++i)
+                if(0 < Stats[i].mMessages)
+                    node.SetFlush(Stats[i].mID, (uint32) Stats[i].mBytes, false);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 ZAY_VIEW_API OnCommand(CommandType type, chars topic, id_share in, id_cloned_share* out)
 {
 }
@@ -39,35 +83,55 @@ ZAY_VIEW_API OnNotify(NotifyType type, chars topic, id_share in, id_cloned_share
                 {
                     sint32 BufferSize = 0;
                     auto NewBuffer = (dumps) Platform::Server::GetPacketBuffer(m->mServer, &BufferSize);
-                    const dZokeReader NewReader(dBinary::fromExternal(NewBuffer, (uint32_t) BufferSize));
-                    utf8s Type = NewReader("type").getString();
-
-                    if(!String::Compare(Type, "node"))
-                        m->mNodes[CurPeerID].SetNodeID(NewReader("id").getString());
-                    else if(!String::Compare(Type, "connect_add"))
+                    const dBinary NewMessage = dBinary::fromExternal(NewBuffer, (uint32_t) BufferSize);
+                    const dTeleGate::OpType NewType = dTeleGate::typeOf(NewMessage);
+                    if(NewType != dTeleGate::OpType::Null)
+                        OnGateMessage(m->mServer, m->mNodes[CurPeerID], NewType, NewMessage);
+                    else
                     {
-                        if(auto ServerConnector = m->mNodes[CurPeerID].ConnectAdd(
-                            NewReader("id").getInt32(-1),
-                            NewReader("entry").getString(),
-                            NewReader("protocol").getString()))
+                        // 노드가 보낸 조크는 신뢰할 수 없으므로 한번 검증(실패시 type이 비어서 무시됨)
+                        const dZokeReader NewReader = dZokeReader::validate(NewMessage);
+                        utf8s Type = NewReader("type").getString();
+
+                        if(!String::Compare(Type, "node"))
                         {
-                            ip4address IP4;
-                            ip6address IP6;
-                            if(Platform::Server::GetPeerInfo(m->mServer, CurPeerID, &IP4, &IP6))
-                                ServerConnector->InitAddress(IP4, IP6, NewReader("port").getUint16());
+                            m->mNodes[CurPeerID].SetNodeID(NewReader("id").getString());
+                            m->mNodes[CurPeerID].SetGateWire(m->mServer,
+                                NewReader("component").getString(), NewReader("gate").getUint8());
+                        }
+                        else if(!String::Compare(Type, "connect_add"))
+                        {
+                            if(auto ServerConnector = m->mNodes[CurPeerID].ConnectAdd(
+                                NewReader("id").getInt32(-1),
+                                NewReader("entry").getString(),
+                                NewReader("protocol").getString()))
+                            {
+                                ip4address IP4;
+                                ip6address IP6;
+                                if(Platform::Server::GetPeerInfo(m->mServer, CurPeerID, &IP4, &IP6))
+                                    ServerConnector->InitAddress(IP4, IP6, NewReader("port").getUint16());
+                            }
+                        }
+                        else if(!String::Compare(Type, "connect_sub"))
+                        {
+                            m->mNodes[CurPeerID].ConnectSub(
+                                NewReader("id").getInt32(-1));
+                        }
+                        // 개발전용
+                        else if(!String::Compare(Type, "toast"))
+                            m->mNodes[CurPeerID].SetToast(NewReader("text").getString());
+                        else if(!String::Compare(Type, "silk_flush"))
+                            m->mNodes[CurPeerID].SetFlush(NewReader("slik").getInt32(),
+                                NewReader("amount").getUint32(), NewReader("all").getUint8());
+                        else if(!String::Compare(Type, "silk_stats"))
+                        {
+                            const dZokeReader Silks = NewReader("silks");
+                            for(uint32_t i = 0, iend = Silks.length(); i < iend; ++i)
+                                if(0 < Silks[i]("messages").getUint64())
+                                    m->mNodes[CurPeerID].SetFlush(Silks[i]("id").getInt32(-1),
+                                        (uint32) Silks[i]("bytes").getUint64(), false);
                         }
                     }
-                    else if(!String::Compare(Type, "connect_sub"))
-                    {
-                        m->mNodes[CurPeerID].ConnectSub(
-                            NewReader("id").getInt32(-1));
-                    }
-                    // 개발전용
-                    else if(!String::Compare(Type, "toast"))
-                        m->mNodes[CurPeerID].SetToast(NewReader("text").getString());
-                    else if(!String::Compare(Type, "silk_flush"))
-                        m->mNodes[CurPeerID].SetFlush(NewReader("slik").getInt32(),
-                            NewReader("amount").getUint32(), NewReader("all").getUint8());
                 }
                 break;
             case packettype_leaved:
@@ -1,7 +1,12 @@
 ﻿#include <daddy.hpp>
+#include <chrono>
 #include <csignal>
+#include <fstream>
+#include <string>
 #include <string.h>
+#include <sys/stat.h>
 #include <thread>
+#include <vector>
 
 #if DD_OS_WINDOWS
     #include <windows.h>
@@ -32,12 +37,35 @@ public:
     void sleep() override;
     bool alived() const override;
 
+public:
+    bool onRecreate();
+    void tick();
+
 private:
     bool mAlived;
     dTeleApi::V10::onPlugInCB mPlugInCB;
     dTeleApi::V10::onCycleCB mCycleCB;
 };
 
+// 한 프로세스에 올라간 컴포넌트(게이트에는 각자 연결하고, 워커는 첫번째 것을 공유)
+class Component
+{
+public:
+    utf8s mPath;
+    LibData mLib;
+    dTelepath::onMarkInCB mMarkIn;
+    dTelepath::onMarkInCB mCreatorMarkIn; // 클라이언트를 만든 빌드(소멸도 그 빌드의 코드로)
+    TeleGateClientP* mClient;
+    TeleKit* mAdapter;
+    bool mLiving; // onCreate후 틱을 받는 중
+    bool mFinished; // onDestroy가 종료를 허락함
+    time_t mModified; // 로드한 빌드의 수정시각
+    time_t mChanging; // 지난 확인때의 수정시각(같으면 복사가 끝난 것으로 판단)
+    uint32_t mReloads;
+    std::string mShadowPath; // 핫리로드된 빌드의 복사본
+    std::vector<std::pair<LibData, std::string>> mRetired; // 살아있는 실크가 쓰는 이전 빌드들
+};
+
 static bool gInterrupt = false;
 static void OnInterrupt(int signum)
 {
@@ -45,6 +73,25 @@ static void OnInterrupt(int signum)
     gInterrupt = true;
 }
 
+static const uint32_t gRetiredMax = 3; // 보관할 이전 빌드의 한도(넘으면 처음부터 다시 로드)
+static bool gReloadAll = false;
+static void OnReload(int)
+{
+    gReloadAll = true;
+}
+
+static uint64_t NowMsec()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static time_t ModifiedTime(utf8s path)
+{
+    struct stat FileStat;
+    return (stat(path, &FileStat) == 0)? FileStat.st_mtime : 0;
+}
+
 static int ErrorToExit(utf8s message)
 {
     printf(message);
@@ -52,97 +99,272 @@ static int ErrorToExit(utf8s message)
     return 0;
 }
 
+static utf8s LoadComponent(utf8s path, Component& component)
+{
+    // 동적라이브러리 연결
+    printf("[daddy] * * * * * load library(%s) * * * * *\n", path);
+    component.mPath = path;
+    component.mModified = component.mChanging = ModifiedTime(path);
+    component.mReloads = 0;
+    component.mLib = LIB_LOAD(path);
+    if(!component.mLib)
+        return "[daddy] library not found.\n";
+
+    component.mMarkIn = (dTelepath::onMarkInCB) LIB_PROC(component.mLib, "onMarkIn");
+    if(!component.mMarkIn)
+    {
+        LIB_FREE(component.mLib);
+        return "[daddy] onMarkIn function does not exist.\n";
+    }
+    component.mCreatorMarkIn = component.mMarkIn;
+
+    // 클라이언트 생성
+    printf("[daddy] * * * * * create client * * * * *\n");
+    component.mClient = (TeleGateClientP*) component.mMarkIn((int32_t) dTeleApi::MarkInType::CreateClient);
+    if(!component.mClient)
+    {
+        LIB_FREE(component.mLib);
+        return "[daddy] client creation failed.\n";
+    }
+
+    // 컴포넌트의 정보획득
+    utf8s ComponentVer = component.mMarkIn((int32_t) dTeleApi::MarkInType::ComponentVer);
+    utf8s EntityVer = component.mMarkIn((int32_t) dTeleApi::MarkInType::EntityVer);
+    utf8s EntityName = component.mMarkIn((int32_t) dTeleApi::MarkInType::EntityName);
+    utf8s EntityUuid = component.mMarkIn((int32_t) dTeleApi::MarkInType::EntityUuid);
+    printf("[daddy] componentVer: %s\n", ComponentVer);
+    printf("[daddy] entityVer: %s\n", EntityVer);
+    printf("[daddy] entityName: %s\n", EntityName);
+    printf("[daddy] entityUuid: %s\n", EntityUuid);
+
+    // 버전에 맞는 어댑터 할당
+    printf("[daddy] * * * * * create adapter * * * * *\n");
+    if(strcmp(ComponentVer, "V10"))
+    {
+        component.mMarkIn((int32_t) dTeleApi::MarkInType::ReleaseClient);
+        LIB_FREE(component.mLib);
+        return "[daddy] componentVer\'s answer could not be understood.\n";
+    }
+    component.mAdapter = new TeleKit(component.mLib);
+    component.mLiving = false;
+    component.mFinished = false;
+    return nullptr;
+}
+
+static utf8s ReleaseComponent(Component& component)
+{
+    if(!component.mLib) // 다시 로드하다 실패한 컴포넌트
+        return nullptr;
+
+    // 어댑터 해제
+    printf("[daddy] * * * * * release adapter * * * * *\n");
+    delete component.mAdapter;
+
+    // 클라이언트 소멸(에스케이퍼 모델은 빌드마다 따로이므로 만든 빌드가 해제)
+    printf("[daddy] * * * * * release client * * * * *\n");
+    auto ReleaseResult = (bool) component.mCreatorMarkIn((int32_t) dTeleApi::MarkInType::ReleaseClient);
+
+    // 동적라이브러리 해제(클라이언트가 사라졌으므로 이전 빌드들도)
+    printf("[daddy] * * * * * free library * * * * *\n");
+    LIB_FREE(component.mLib);
+    if(!component.mShadowPath.empty())
+        remove(component.mShadowPath.c_str());
+    while(!component.mRetired.empty())
+    {
+        LIB_FREE(component.mRetired.back().first);
+        if(!component.mRetired.back().second.empty())
+            remove(component.mRetired.back().second.c_str());
+        component.mRetired.pop_back();
+    }
+    component.mLib = nullptr;
+    component.mShadowPath.clear();
+    return (ReleaseResult)? nullptr : "[daddy] client release failed.\n";
+}
+
+static utf8s ReloadComponent(Component& component)
+{
+    // 같은 경로는 이전 핸들이 재사용되므로 복사본으로 로드
+    printf("[daddy] * * * * * reload library(%s) * * * * *\n", component.mPath);
+    const std::string ShadowPath = std::string(component.mPath) + ".reload" + std::to_string(++component.mReloads);
+    {
+        std::ifstream Source(component.mPath, std::ios::binary);
+        std::ofstream Target(ShadowPath, std::ios::binary | std::ios::trunc);
+        if(!Source || !(Target << Source.rdbuf()))
+            return "[daddy] library copy failed.\n";
+    }
+    LibData NewLib = LIB_LOAD(ShadowPath.c_str());
+    if(!NewLib)
+    {
+        remove(ShadowPath.c_str());
+        return "[daddy] library not found.\n";
+    }
+
+    // 새 빌드가 이전 클라이언트를 이어받을 수 있는지
+    auto NewMarkIn = (dTelepath::onMarkInCB) LIB_PROC(NewLib, "onMarkIn");
+    auto NewReload = (dTeleApi::V10::onReloadCB) LIB_PROC(NewLib, "onReload");
+    if(!NewMarkIn || !NewReload || strcmp(NewMarkIn((int32_t) dTeleApi::MarkInType::ComponentVer), "V10")
+        || !NewReload(component.mClient))
+    {
+        LIB_FREE(NewLib);
+        remove(ShadowPath.c_str());
+        return "[daddy] library does not support reloading.\n";
+    }
+    printf("[daddy] entityVer: %s\n", NewMarkIn((int32_t) dTeleApi::MarkInType::EntityVer));
+
+    // 실크는 연결을 유지한 채 보류하고, 새 빌드가 Recreate에서 다시 추가한 것만 이어받음
+    dTelepath::parkSilks(component.mClient);
+    if(component.mLiving)
+        component.mAdapter->onDestroy(); // 이전 빌드의 정리(보류된 실크는 남음)
+    delete component.mAdapter;
+    component.mRetired.push_back(std::make_pair(component.mLib, component.mShadowPath)); // 이어받은 소켓들의 코드
+    component.mLib = NewLib;
+    component.mMarkIn = NewMarkIn;
+    component.mShadowPath = ShadowPath;
+    component.mAdapter = new TeleKit(NewLib);
+    component.mLiving = component.mAdapter->onRecreate();
+    dTelepath::unparkSilks(component.mClient);
+    return nullptr;
+}
+
+static utf8s RestartComponent(Component& component, std::vector<Component>& components)
+{
+    // 이전 빌드들은 이어받은 소켓이 끊겨야 해제할 수 있으므로 실크까지 모두 정리
+    printf("[daddy] * * * * * restart library(%s) * * * * *\n", component.mPath);
+    if(component.mLiving)
+        component.mAdapter->onDestroy();
+    utf8s Result = ReleaseComponent(component);
+    if(utf8s Error = LoadComponent(component.mPath, component))
+    {
+        component.mLib = nullptr;
+        component.mFinished = true;
+        return Error;
+    }
+
+    // 워커공유를 복구(첫번째가 다시 로드되면 나머지 모두)
+    Component& Host = components[0];
+    if(&component != &Host)
+        dTelepath::shareWorkers(Host.mClient, component.mClient);
+    else for(size_t i = 1; i < components.size(); ++i)
+        if(components[i].mLib)
+            dTelepath::shareWorkers(Host.mClient, components[i].mClient);
+    component.mLiving = component.mAdapter->onCreate();
+    return Result;
+}
+
+static utf8s ReleaseComponents(std::vector<Component>& components)
+{
+    // 워커를 빌려쓰는 손님부터 역순으로
+    utf8s Result = nullptr;
+    while(!components.empty())
+    {
+        if(utf8s Error = ReleaseComponent(components.back()))
+            Result = Error;
+        components.pop_back();
+    }
+    return Result;
+}
+
 int main(int argc, char* argv[])
 {
     signal(SIGINT, OnInterrupt); // Ctrl+C
-    if(argc == 2)
+    #ifdef SIGUSR1
+        signal(SIGUSR1, OnReload); // kill -USR1로 모두 핫리로드
+    #endif
+    if(2 <= argc)
     {
-        // 동적라이브러리 연결
-        printf("[daddy] * * * * * load library * * * * *\n");
         dGlobal::load();
-
-        LibData NewLib = LIB_LOAD(argv[1]);
-        if(!NewLib)
-        {
-            dGlobal::release();
-            return ErrorToExit("[daddy] library not found.\n");
-        }
-
-        auto MarkIn = (dTelepath::onMarkInCB) LIB_PROC(NewLib, "onMarkIn");
-        if(!MarkIn)
+        std::vector<Component> Components;
+        for(int i = 1; i < argc; ++i)
         {
-            dGlobal::release();
-            return ErrorToExit("[daddy] onMarkIn function does not exist.\n");
+            Component NewComponent;
+            if(utf8s Error = LoadComponent(argv[i], NewComponent))
+            {
+                ReleaseComponents(Components);
+                dGlobal::release();
+                return ErrorToExit(Error);
+            }
+            if(!Components.empty())
+                dTelepath::shareWorkers(Components[0].mClient, NewComponent.mClient);
+            Components.push_back(NewComponent);
         }
-
-        // 클라이언트 생성
-        printf("[daddy] * * * * * create client * * * * *\n");
-        auto NewClient = (TeleGateClientP*) MarkIn((int32_t) dTeleApi::MarkInType::CreateClient);
-        if(!NewClient)
+        // 생명주기(게이트, 수신, 틱을 모든 컴포넌트가 한 루프에서)
+        for(auto& iComponent : Components)
+            iComponent.mLiving = iComponent.mAdapter->onCreate();
+        uint64_t NextWatchMsec = 0;
+        for(bool Running = true; Running && !gInterrupt;)
         {
-            dGlobal::release();
-            return ErrorToExit("[daddy] client creation failed.\n");
-        }
+            for(auto& iComponent : Components)
+                if(!iComponent.mFinished)
+                    dTelepath::gateCall("localhost", iComponent.mClient, iComponent.mMarkIn);
+            for(bool NeedUpdate = true; NeedUpdate;)
+            {
+                NeedUpdate = false;
+                for(auto& iComponent : Components)
+                    if(!iComponent.mFinished)
+                        NeedUpdate |= dTelepath::nextReceive(iComponent.mClient);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
-        // 컴포넌트의 정보획득
-        utf8s ComponentVer = MarkIn((int32_t) dTeleApi::MarkInType::ComponentVer);
-        utf8s EntityVer = MarkIn((int32_t) dTeleApi::MarkInType::EntityVer);
-        utf8s EntityName = MarkIn((int32_t) dTeleApi::MarkInType::EntityName);
-        utf8s EntityUuid = MarkIn((int32_t) dTeleApi::MarkInType::EntityUuid);
-        printf("[daddy] componentVer: %s\n", ComponentVer);
-        printf("[daddy] entityVer: %s\n", EntityVer);
-        printf("[daddy] entityName: %s\n", EntityName);
-        printf("[daddy] entityUuid: %s\n", EntityUuid);
-
-        // 버전에 맞는 어댑터 할당
-        printf("[daddy] * * * * * create adapter * * * * *\n");
-        dTeleAdapter* Adapter = nullptr;
-        if(!strcmp(ComponentVer, "V10"))
-            Adapter = new TeleKit(NewLib);
-        else
-        {
-            dGlobal::release();
-            return ErrorToExit("[daddy] componentVer\'s answer could not be understood.\n");
-        }
+            // 라이브러리가 바뀌었으면 실크를 유지한 채 핫리로드(1초마다 확인)
+            const bool ReloadAll = gReloadAll;
+            gReloadAll = false;
+            if(ReloadAll || NextWatchMsec <= NowMsec())
+            {
+                NextWatchMsec = NowMsec() + 1000;
+                for(auto& iComponent : Components)
+                {
+                    if(iComponent.mFinished)
+                        continue;
+                    const time_t Modified = ModifiedTime(iComponent.mPath);
+                    const bool Changed = (Modified != 0 && Modified != iComponent.mModified && Modified == iComponent.mChanging);
+                    iComponent.mChanging = Modified;
+                    if(ReloadAll || Changed)
+                    {
+                        iComponent.mModified = Modified;
+                        utf8s Error = (iComponent.mRetired.size() < gRetiredMax)?
+                            ReloadComponent(iComponent) : RestartComponent(iComponent, Components);
+                        if(Error)
+                            printf(Error); // 이전 빌드로 계속
+                    }
+                }
+            }
 
-        // 생명주기
-        do
-        {
-            if(Adapter->onCreate())
+            Running = false;
+            for(auto& iComponent : Components)
             {
-                while(Adapter->alived() && !gInterrupt)
+                if(iComponent.mFinished)
+                    continue;
+                if(iComponent.mLiving)
                 {
-                    dTelepath::gateCall("localhost", NewClient, MarkIn);
-                    while(dTelepath::nextReceive(NewClient));
-                    Adapter->sleep();
+                    iComponent.mAdapter->tick();
+                    iComponent.mLiving = iComponent.mAdapter->alived();
                 }
+                if(!iComponent.mLiving)
+                {
+                    if(iComponent.mAdapter->onDestroy())
+                        iComponent.mFinished = true;
+                    else iComponent.mLiving = iComponent.mAdapter->onCreate();
+                }
+                Running |= !iComponent.mFinished;
             }
         }
-        while(!Adapter->onDestroy() && !gInterrupt);
-
-        // 어댑터 해제
-        printf("[daddy] * * * * * release adapter * * * * *\n");
-        delete Adapter;
+        for(auto& iComponent : Components)
+            if(!iComponent.mFinished)
+                iComponent.mAdapter->onDestroy();
 
-        // 클라이언트 소멸
-        printf("[daddy] * * * * * release client * * * * *\n");
-        auto ReleaseResult = (bool) MarkIn((int32_t) dTeleApi::MarkInType::ReleaseClient);
-        if(!ReleaseResult)
+        // 컴포넌트 해제
+        if(utf8s Error = ReleaseComponents(Components))
         {
             dGlobal::release();
-            return ErrorToExit("[daddy] client release failed.\n");
+            return ErrorToExit(Error);
         }
 
-        // 동적라이브러리 해제
-        printf("[daddy] * * * * * free library * * * * *\n");
-        LIB_FREE(NewLib);
-
         dGlobal::release();
         printf("[daddy] * * * * * done * * * * *\n");
         return 0;
     }
     return ErrorToExit("[daddy] call the argument again like this! (waiting 3sec)\n"
-        "C:\\>telekit.exe core.dll\n");
+        "C:\\>telekit.exe core.dll [more.dll ...]\n");
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -165,6 +387,13 @@ bool TeleKit::onCreate()
     return mCycleCB((int32_t) dTeleApi::CycleType::Create);
 }
 
+bool TeleKit::onRecreate()
+{
+    mAlived = true;
+    printf("[daddy] * * * * * calling onRecreate() * * * * *\n");
+    return mCycleCB((int32_t) dTeleApi::CycleType::Recreate);
+}
+
 bool TeleKit::onDestroy()
 {
     printf("[daddy] * * * * * calling onDestroy() * * * * *\n");
@@ -174,6 +403,11 @@ bool TeleKit::onDestroy()
 void TeleKit::sleep()
 {
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    tick();
+}
+
+void TeleKit::tick()
+{
     mAlived &= mCycleCB((int32_t) dTeleApi::CycleType::Tick);
 }
 